@@ -20,6 +20,9 @@
 #include "../src/bigInteger.cpp"
 #include "../src/garbageCollector.cpp"
 #include "../src/callPath.cpp"
+#include "../src/jitCompiler.cpp"
+#include "../src/mappedFile.cpp"
+#include "../src/heapSnapshot.cpp"
 
 namespace MSL
 {
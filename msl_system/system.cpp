@@ -502,6 +502,11 @@ void ConsolePrint(PARAMS)
 		out << classObject->typeInstance->namespaceName + '.' + classObject->typeInstance->name << " instance";
 		break;
 	}
+	case Type::INTEGER:
+	{
+		static_cast<IntegerObject*>(object)->value.write(out);
+		break;
+	}
 	default:
 	{
 		out << object->ToString();
@@ -689,31 +694,257 @@ void ArrayAppend(PARAMS)
 	array.push_back({ object, false });
 }
 
+static momo::BigInteger MaxInt64 = (long long)std::numeric_limits<long long>::max();
+static momo::BigInteger MinInt64 = (long long)std::numeric_limits<long long>::min();
+
+// arrays smaller than this are sorted in one thread
+static const size_t ParallelSortThreshold = 1 << 16;
+// integer arrays smaller than this are sorted by comparison
+static const size_t RadixSortThreshold = 1 << 8;
+
+template<typename Iterator, typename Compare>
+static void ParallelSort(Iterator begin, Iterator end, Compare compare, size_t threads)
+{
+	size_t size = end - begin;
+	if (threads < 2 || size < ParallelSortThreshold)
+	{
+		std::sort(begin, end, compare);
+		return;
+	}
+	Iterator middle = begin + size / 2;
+	std::thread worker;
+	try
+	{
+		worker = std::thread(ParallelSort<Iterator, Compare>, begin, middle, compare, threads / 2);
+	}
+	catch (std::system_error&)
+	{
+		std::sort(begin, end, compare); // no threads available, sort sequentially
+		return;
+	}
+	ParallelSort(middle, end, compare, threads - threads / 2);
+	worker.join();
+	std::inplace_merge(begin, middle, end, compare);
+}
+
+template<typename Key, typename Compare>
+static void SortByKey(ArrayObject::InnerType& array, Key(*getKey)(BaseObject*), Compare compare)
+{
+	using KeyValue = std::pair<Key, Local>;
+	std::vector<KeyValue> values;
+	values.reserve(array.size());
+	for (const Local& local : array)
+	{
+		values.push_back({ getKey(local.object), local });
+	}
+	size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	ParallelSort(values.begin(), values.end(), [&compare](const KeyValue& v1, const KeyValue& v2)
+		{
+			return compare(v1.first, v2.first);
+		}, threads);
+
+	for (size_t i = 0; i < array.size(); i++)
+	{
+		array[i] = values[i].second;
+	}
+}
+
+static void RadixSort(ArrayObject::InnerType& array, long long minValue)
+{
+	using KeyValue = std::pair<uint64_t, Local>;
+	std::vector<KeyValue> values, buffer(array.size());
+	values.reserve(array.size());
+	uint64_t maxKey = 0;
+	for (const Local& local : array)
+	{
+		// shift all values by minimal one, so keys are unsigned and as small as possible
+		long long value = static_cast<IntegerObject*>(local.object)->value.to_int64();
+		uint64_t key = (uint64_t)value - (uint64_t)minValue;
+		maxKey = std::max(maxKey, key);
+		values.push_back({ key, local });
+	}
+	for (size_t shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += 8)
+	{
+		size_t count[256 + 1] = { 0 };
+		for (const KeyValue& value : values)
+		{
+			count[((value.first >> shift) & 0xFF) + 1]++;
+		}
+		for (size_t i = 1; i < 256; i++)
+		{
+			count[i] += count[i - 1];
+		}
+		for (const KeyValue& value : values)
+		{
+			buffer[count[(value.first >> shift) & 0xFF]++] = value;
+		}
+		values.swap(buffer);
+	}
+	for (size_t i = 0; i < array.size(); i++)
+	{
+		array[i] = values[i].second;
+	}
+}
+
+static void SortIntegers(ArrayObject::InnerType& array)
+{
+	bool isSmall = true;
+	long long minValue = std::numeric_limits<long long>::max();
+	for (const Local& local : array)
+	{
+		const auto& value = static_cast<IntegerObject*>(local.object)->value;
+		if (value < MinInt64 || value > MaxInt64)
+		{
+			isSmall = false;
+			break;
+		}
+		minValue = std::min(minValue, value.to_int64());
+	}
+	if (isSmall && array.size() >= RadixSortThreshold)
+	{
+		RadixSort(array, minValue);
+	}
+	else if (isSmall)
+	{
+		SortByKey<long long>(array,
+			[](BaseObject* object) { return static_cast<IntegerObject*>(object)->value.to_int64(); },
+			std::less<long long>());
+	}
+	else
+	{
+		SortByKey<const IntegerObject::InnerType*>(array,
+			[](BaseObject* object) { return (const IntegerObject::InnerType*)&static_cast<IntegerObject*>(object)->value; },
+			[](const IntegerObject::InnerType* v1, const IntegerObject::InnerType* v2) { return *v1 < *v2; });
+	}
+}
+
+static void SortFloats(ArrayObject::InnerType& array)
+{
+	SortByKey<FloatObject::InnerType>(array,
+		[](BaseObject* object) { return static_cast<FloatObject*>(object)->value; },
+		[](FloatObject::InnerType v1, FloatObject::InnerType v2)
+		{
+			// NaN values are considered the greatest, so the order stays strict
+			return v1 < v2 || (std::isnan(v2) && !std::isnan(v1));
+		});
+}
+
+static void SortStrings(ArrayObject::InnerType& array)
+{
+	SortByKey<const StringObject::InnerType*>(array,
+		[](BaseObject* object) { return (const StringObject::InnerType*)&static_cast<StringObject*>(object)->value; },
+		[](const StringObject::InnerType* v1, const StringObject::InnerType* v2) { return *v1 < *v2; });
+}
+
+/*
+merge sort which is safe to use with any user-provided comparison: if compare() fails,
+it must set vm errors and the sort stops, leaving sorted range as a permutation of the source
+*/
+template<typename Compare>
+static void MergeSort(ArrayObject::InnerType& array, size_t begin, size_t end, ArrayObject::InnerType& buffer, PARAMS, Compare compare)
+{
+	if (end - begin < 2) return;
+	size_t middle = begin + (end - begin) / 2;
+	MergeSort(array, begin, middle, buffer, vm, compare);
+	MergeSort(array, middle, end, buffer, vm, compare);
+	if (vm->GetErrors() != 0) return;
+
+	size_t left = begin, right = middle, out = begin;
+	while (left < middle && right < end)
+	{
+		if (compare(array[right].object, array[left].object))
+			buffer[out++] = array[right++];
+		else
+			buffer[out++] = array[left++];
+		if (vm->GetErrors() != 0) return;
+	}
+	while (left < middle) buffer[out++] = array[left++];
+	while (right < end) buffer[out++] = array[right++];
+	std::copy(buffer.begin() + begin, buffer.begin() + end, array.begin() + begin);
+}
+
+template<typename Compare>
+static void SortByVM(ArrayObject::InnerType& array, PARAMS, Compare compare)
+{
+	// objects are sorted in copy of the array, so they are not lost by GC during MSL calls
+	ArrayObject::InnerType sorted = array, buffer(array.size());
+	MergeSort(sorted, 0, sorted.size(), buffer, vm, compare);
+	if (vm->GetErrors() != 0) return;
+	array = std::move(sorted);
+}
+
+static bool PopBoolean(PARAMS)
+{
+	auto& stack = vm->GetObjectStack();
+	BaseObject* result = GetUnderlyingObject(stack.back());
+	stack.pop_back();
+	if (result->type == Type::TRUE)
+		return true;
+	if (result->type != Type::FALSE)
+		AssertType(vm, result, Type::TRUE);
+	return false;
+}
+
 void ArraySort(PARAMS)
 {
 	auto& stack = vm->GetObjectStack();
 	auto& array = GetArrayReference(stack.back());
-	try
+	if (array.empty()) return;
+
+	Type type = array.front().object->type;
+	bool isHomogeneous = std::all_of(array.begin(), array.end(), [type](const Local& local)
+		{
+			return local.object->type == type;
+		});
+
+	if (isHomogeneous && type == Type::INTEGER)
+	{
+		SortIntegers(array);
+	}
+	else if (isHomogeneous && type == Type::FLOAT)
+	{
+		SortFloats(array);
+	}
+	else if (isHomogeneous && type == Type::STRING)
+	{
+		SortStrings(array);
+	}
+	else
 	{
-		std::sort(array.begin(), array.end(), [&stack, &vm](MSL::VM::Local& o1, MSL::VM::Local& o2)
+		// class objects and mixed arrays are compared by VM (IsLess() for classes)
+		SortByVM(array, vm, [vm, &stack](BaseObject* o1, BaseObject* o2)
 			{
-				stack.push_back(o1.object);
-				stack.push_back(o2.object);
+				stack.push_back(o1);
+				stack.push_back(o2);
 				vm->PerformALUCall(OPCODE::CMP_L, 2, vm->GetCallStack().back().GetFrame());
-				if (vm->GetErrors() != 0)
-					throw std::exception("invalid compare");
-				auto output = stack.back();
-				stack.pop_back();
-				if (output->type == Type::TRUE)
-					return true;
-				if (output->type == Type::FALSE)
-					return false;
-				AssertType(vm, output, Type::TRUE);
-				throw std::exception("invalid compare");
+				if (vm->GetErrors() != 0) return false;
+				return PopBoolean(vm);
 			});
 	}
-	catch (std::exception&)
-	{
-		return;
-	}
+}
+
+void ArraySortBy(PARAMS)
+{
+	static const std::string compareMethod = "Compare_3";
+	static const std::string staticCompareMethod = "Compare_2";
+
+	auto& stack = vm->GetObjectStack();
+	BaseObject* comparator = GetUnderlyingObject(stack.back());
+	stack.pop_back(); // pop comparator
+	auto& array = GetArrayReference(stack.back());
+
+	if (comparator->type != Type::CLASS && !AssertType(vm, comparator, Type::CLASS_OBJECT)) return;
+
+	SortByVM(array, vm, [vm, &stack, comparator](BaseObject* o1, BaseObject* o2)
+		{
+			stack.push_back(comparator);
+			stack.push_back(o1);
+			stack.push_back(o2);
+			if (comparator->type == Type::CLASS)
+				vm->InvokeStaticMethod(staticCompareMethod, static_cast<ClassWrapper*>(comparator)->typeInstance);
+			else
+				vm->InvokeObjectMethod(compareMethod, static_cast<ClassObject*>(comparator));
+			if (vm->GetErrors() != 0) return false;
+			return PopBoolean(vm);
+		});
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "../LibMSL/msl_types.h"
 #include "../LibMSL/msl_types.cpp"
 #include <cmath>
+#include <algorithm>
+#include <thread>
 
 #define DLLEXPORT extern "C" __declspec(dllexport) void _cdecl
 #define PARAMS MSL::VM::VirtualMachine* vm
@@ -54,4 +56,5 @@ DLLEXPORT ArraySize(PARAMS);
 DLLEXPORT ArrayToString(PARAMS);
 DLLEXPORT ArrayPop(PARAMS);
 DLLEXPORT ArrayAppend(PARAMS);
-DLLEXPORT ArraySort(PARAMS);
\ No newline at end of file
+DLLEXPORT ArraySort(PARAMS);
+DLLEXPORT ArraySortBy(PARAMS);
\ No newline at end of file
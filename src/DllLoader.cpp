@@ -58,6 +58,17 @@ namespace MSL
 			return ::GetLastError();
 		}
 
+		std::vector<std::string> DllLoader::GetLibraries() const
+		{
+			std::vector<std::string> libraries;
+			libraries.reserve(modules.size());
+			for (const auto& module : modules)
+			{
+				libraries.push_back(module.first);
+			}
+			return libraries;
+		}
+
 		void DllLoader::UseFunctionCache(bool value)
 		{
 			useFunctionCache = value;
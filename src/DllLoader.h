@@ -1,5 +1,7 @@
 #pragma once
 #include <unordered_map>
+#include <vector>
+#include <string>
 #include <Windows.h>
 
 #include "cacher.h"
@@ -26,6 +28,10 @@ namespace MSL
 			DllFunction GetFunctionPointer(const std::string& module, const std::string& function) const;
 			bool HasLibrary(const std::string& filename) const;
 			DWORD GetLastError() const;
+			/*
+			returns names of loaded libraries
+			*/
+			std::vector<std::string> GetLibraries() const;
 			void UseFunctionCache(bool value);
 			void AddDllFunction(const std::string& module, const std::string& function, DllFunction pointer);
 		};
@@ -1,40 +1,59 @@
 #include "ExceptionTrace.h"
 
-std::string& MSL::VM::ExceptionTrace::GetErrorType()
+size_t MSL::VM::ExceptionTrace::GetError() const
 {
-	return innerArgs[0];
+	return error;
 }
 
 #undef GetMessage // winapi
 std::string& MSL::VM::ExceptionTrace::GetMessage()
 {
-	return innerArgs[1];
+	Format();
+	return message;
 }
 
 std::string& MSL::VM::ExceptionTrace::GetArgument()
 {
-	return innerArgs[2];
+	Format();
+	return argument;
 }
 
-std::string& MSL::VM::ExceptionTrace::GetTraceEntry(size_t index)
+const MSL::VM::ExceptionTrace::TraceEntry& MSL::VM::ExceptionTrace::GetTraceEntry(size_t index) const
 {
-	return innerArgs[index + 3];
+	return trace[index];
 }
 
 size_t MSL::VM::ExceptionTrace::GetTraceSize()
 {
-	return innerArgs.size() - 3;
+	return trace.size();
 }
 
-void MSL::VM::ExceptionTrace::Init(const std::string& message, const std::string& arg, const std::string& error)
+void MSL::VM::ExceptionTrace::Init(const std::string& message, const std::string& arg, size_t error)
 {
-	innerArgs.clear();
-	innerArgs.push_back(error);
-	innerArgs.push_back(message);
-	innerArgs.push_back(arg);
+	this->error = error;
+	this->message = message;
+	this->argument = arg;
+	formatter = nullptr;
+	trace.clear();
 }
 
-void MSL::VM::ExceptionTrace::AddTraceEntry(const std::string& entry)
+void MSL::VM::ExceptionTrace::Init(Formatter formatter, size_t error)
 {
-	innerArgs.push_back(entry);
+	this->error = error;
+	this->formatter = std::move(formatter);
+	trace.clear();
 }
+
+void MSL::VM::ExceptionTrace::Format()
+{
+	if (formatter == nullptr) return;
+	message.clear();
+	argument.clear();
+	formatter(message, argument);
+	formatter = nullptr;
+}
+
+void MSL::VM::ExceptionTrace::AddTraceEntry(const TraceEntry& entry)
+{
+	trace.push_back(entry);
+}
\ No newline at end of file
@@ -2,22 +2,51 @@
 
 #include <vector>
 #include <string>
+#include <functional>
 
 namespace MSL
 {
 	namespace VM
 	{
+		struct ClassType;
+		struct MethodType;
+
 		class ExceptionTrace
 		{
-			std::vector<std::string> innerArgs;
+		public:
+			/*
+			frame unwound by error. Entries are formatted to strings only when stack trace is read
+			*/
+			struct TraceEntry
+			{
+				const ClassType* _class;
+				const MethodType* _method;
+				size_t offset;
+				size_t tailCalls = 0; // number of calls which reused frame of this method (see OPCODE::TAIL_CALL)
+			};
+			/*
+			builds message and argument of error. It is called only when one of them is read, so errors caught by script do not format them
+			*/
+			using Formatter = std::function<void(std::string& message, std::string& argument)>;
+		private:
+			size_t error = 0;
+			Formatter formatter;
+			std::string message;
+			std::string argument;
+			std::vector<TraceEntry> trace;
 		public:
 			std::string& GetMessage();
 			std::string& GetArgument();
-			std::string& GetTraceEntry(size_t index);
-			std::string& GetErrorType();
+			const TraceEntry& GetTraceEntry(size_t index) const;
+			size_t GetError() const;
 			size_t GetTraceSize();
-			void Init(const std::string& message, const std::string& arg, const std::string& error);
-			void AddTraceEntry(const std::string& entry);
+			void Init(const std::string& message, const std::string& arg, size_t error);
+			void Init(Formatter formatter, size_t error);
+			/*
+			calls formatter of error if message was not built yet. Formatter may refer to VM objects, so it must be called before they can be collected
+			*/
+			void Format();
+			void AddTraceEntry(const TraceEntry& entry);
 		};
 	}
 }
\ No newline at end of file
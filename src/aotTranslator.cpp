@@ -0,0 +1,502 @@
+#include "aotTranslator.h"
+#include "jitCompiler.h"
+
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cctype>
+
+namespace MSL
+{
+	namespace VM
+	{
+		/*
+		functions written once to each module. Calls and member access of generated code use them, as they are too long to be written inline
+		*/
+		static const char* RuntimeSource = R"(	/*
+	calls public method of class or class object by VM API, as CALL_FUNCTION does. Returns false if call is left to interpreter:
+	caller or arguments are not resolved yet, method is not found, private or abstract, or interpreter executes it inline
+	*/
+	bool CallMethod(VirtualMachine* vm, const std::string& name, const std::string& objectName, size_t paramSize)
+	{
+		auto& stack = vm->GetObjectStack();
+		if (stack.size() < paramSize + 1) return false;
+		for (size_t i = stack.size() - paramSize; i < stack.size(); i++)
+		{
+			if (stack[i]->type == Type::UNKNOWN) return false;
+		}
+		BaseObject* caller = stack[stack.size() - paramSize - 1];
+		const MethodType* method = nullptr;
+		if (caller->type == Type::CLASS)
+			method = vm->GetMethodOrNull(static_cast<ClassWrapper*>(caller)->typeInstance, name);
+		else if (caller->type == Type::CLASS_OBJECT)
+			method = vm->GetMethodOrNull(static_cast<ClassObject*>(caller)->typeInstance, objectName);
+		if (method == nullptr || !method->isPublic() || method->isAbstract() || method->isStatic() != (caller->type == Type::CLASS) ||
+			method->inlineKind != MethodType::InlineKind::NONE)
+			return false;
+
+		// arguments read by LOAD_LOCAL can be stored by called method
+		for (size_t i = stack.size() - paramSize - 1; i < stack.size(); i++)
+		{
+			stack[i]->unique = false;
+		}
+		if (caller->type == Type::CLASS)
+			vm->InvokeStaticMethod(name, static_cast<ClassWrapper*>(caller)->typeInstance);
+		else
+			vm->InvokeObjectMethod(objectName, static_cast<ClassObject*>(caller));
+		return true;
+	}
+
+	/*
+	replaces object on top of stack by its member, as GET_MEMBER does. Returns false if member access is left to interpreter:
+	object is not resolved yet, member is not found or it is private attribute of other class
+	*/
+	bool GetMember(VirtualMachine* vm, Frame* frame, const std::string& name)
+	{
+		auto& stack = vm->GetObjectStack();
+		if (stack.empty()) return false;
+		BaseObject* object = stack.back();
+		if (object->type != Type::CLASS_OBJECT && object->type != Type::CLASS && object->type != Type::NAMESPACE) return false;
+		BaseObject* member = vm->GetMemberObject(object, name);
+		if (member == nullptr) return false;
+		if (member->type == Type::ATTRIBUTE && !static_cast<AttributeObject*>(member)->type->isPublic())
+		{
+			const ClassType* type = (object->type == Type::CLASS) ? static_cast<ClassWrapper*>(object)->typeInstance : static_cast<ClassObject*>(object)->typeInstance;
+			if (type != frame->_class) return false;
+		}
+		stack.back() = member;
+		return true;
+	}
+)";
+
+		static std::string ToStringLiteral(const std::string& str)
+		{
+			// octal escapes are used for other characters, as they are at most three digits long
+			std::ostringstream literal;
+			literal << '"';
+			for (char c : str)
+			{
+				if (c == '"' || c == '\\') literal << '\\' << c;
+				else if (std::isprint(static_cast<unsigned char>(c))) literal << c;
+				else literal << '\\' << std::oct << std::setw(3) << std::setfill('0') << static_cast<int>(static_cast<unsigned char>(c)) << std::dec;
+			}
+			literal << '"';
+			return literal.str();
+		}
+
+		/*
+		returns comment with name of dependency or empty string if it cannot be written on one line
+		*/
+		static std::string ToComment(const std::string& name)
+		{
+			for (char c : name)
+			{
+				if (!std::isprint(static_cast<unsigned char>(c))) return "";
+			}
+			return " // " + name;
+		}
+
+		/*
+		converts decimal integer to int64_t. Returns false if it is out of range, so it is kept as big integer constant
+		*/
+		static bool ToInt64(const std::string& value, int64_t& result)
+		{
+			size_t digits = (!value.empty() && value[0] == '-') ? 1 : 0;
+			if (value.size() <= digits || value.size() - digits > 18) return false;
+			for (size_t i = digits; i < value.size(); i++)
+			{
+				if (!std::isdigit(static_cast<unsigned char>(value[i]))) return false;
+			}
+			result = std::stoll(value);
+			return std::to_string(result) == value;
+		}
+
+		/*
+		returns C++ operator applied to operands of ALU instruction by its integer and float fast paths or nullptr if it has no fast path
+		*/
+		static const char* GetOperatorSymbol(OPCODE op)
+		{
+			switch (ToGenericOpcode(op))
+			{
+			case OPCODE::SUM_OP: return "+";
+			case OPCODE::SUB_OP: return "-";
+			case OPCODE::MULT_OP: return "*";
+			case OPCODE::DIV_OP: return "/";
+			case OPCODE::CMP_EQ: return "==";
+			case OPCODE::CMP_NEQ: return "!=";
+			case OPCODE::CMP_L: return "<";
+			case OPCODE::CMP_G: return ">";
+			case OPCODE::CMP_LE: return "<=";
+			case OPCODE::CMP_GE: return ">=";
+			default: return nullptr;
+			}
+		}
+
+		static bool IsALU(OPCODE op)
+		{
+			switch (op)
+			{
+			case OPCODE::NEGATION_OP:
+			case OPCODE::NEGATIVE_OP:
+			case OPCODE::POSITIVE_OP:
+			case OPCODE::SUM_OP:
+			case OPCODE::SUB_OP:
+			case OPCODE::MULT_OP:
+			case OPCODE::DIV_OP:
+			case OPCODE::MOD_OP:
+			case OPCODE::POWER_OP:
+			case OPCODE::ASSIGN_OP:
+			case OPCODE::CMP_EQ:
+			case OPCODE::CMP_NEQ:
+			case OPCODE::CMP_L:
+			case OPCODE::CMP_G:
+			case OPCODE::CMP_LE:
+			case OPCODE::CMP_GE:
+			case OPCODE::CMP_AND:
+			case OPCODE::CMP_OR:
+				return true;
+			default:
+				return ToGenericOpcode(op) != op && op != OPCODE::CALL_METHOD;
+			}
+		}
+
+		/*
+		writes fast path of ALU instruction for two operands of type provided, which computes its result as quickened instruction does
+		*/
+		static void WriteFastPath(std::ostream& out, OPCODE op, const char* objectType, const char* typeName, bool isFirst)
+		{
+			std::string symbol = GetOperatorSymbol(op);
+			bool isComparison = ToGenericOpcode(op) >= OPCODE::CMP_EQ && ToGenericOpcode(op) <= OPCODE::CMP_GE;
+			out << "\t\t\t" << (isFirst ? "if" : "else if") << " (size >= 2 && stack[size - 2]->type == Type::" << typeName << " && stack[size - 1]->type == Type::" << typeName << ")\n";
+			out << "\t\t\t{\n";
+			out << "\t\t\t\tconst auto& lhs = static_cast<" << objectType << "*>(stack[size - 2])->value;\n";
+			out << "\t\t\t\tconst auto& rhs = static_cast<" << objectType << "*>(stack[size - 1])->value;\n";
+			if (isComparison)
+				out << "\t\t\t\tBaseObject* result = (lhs " << symbol << " rhs) ? static_cast<BaseObject*>(vm->AllocTrue()) : vm->AllocFalse();\n";
+			else
+				out << "\t\t\t\tBaseObject* result = vm->Alloc" << (std::strcmp(typeName, "INTEGER") == 0 ? "Integer" : "Float") << "(lhs " << symbol << " rhs);\n";
+			out << "\t\t\t\tstack.pop_back();\n";
+			out << "\t\t\t\tstack.back() = result;\n";
+			out << "\t\t\t}\n";
+		}
+
+		AotTranslator::AotTranslator(const AssemblyType& assembly, std::ostream& out)
+			: assembly(assembly), out(out) { }
+
+		bool AotTranslator::TranslateInstruction(const MethodType& method, const JitMethod::Instruction& instruction, OPCODE previous, std::ostream& code)
+		{
+			const auto& body = method.body;
+			// operands which are not decoded by JitCompiler::Decode() are read here: dependency hashes, then parameter count and label
+			OperandLayout layout = GetOperandLayout(instruction.op);
+			size_t hashes[3] = { 0, 0, 0 };
+			for (size_t i = 0; i < layout.hashCount && i < 3; i++)
+			{
+				std::memcpy(&hashes[i], &body[instruction.offset + 1 + i * sizeof(size_t)], sizeof(size_t));
+				if (hashes[i] >= method.dependencies.size()) return false;
+			}
+			const size_t paramsOffset = instruction.offset + 1 + layout.hashCount * sizeof(size_t);
+			const std::string hash = std::to_string(hashes[0]);
+			const std::string leave = "{ frame->offset = " + std::to_string(instruction.offset) + "; return true; }";
+			static const std::string noDependency;
+			const std::string& dependency = (layout.hashCount > 0) ? method.dependencies[hashes[0]] : noDependency;
+
+			switch (instruction.op)
+			{
+			case OPCODE::PUSH_INTEGER:
+			{
+				int64_t value = 0;
+				if (ToInt64(dependency, value))
+				{
+					code << "\t\tstack.push_back(vm->AllocInteger(int64_t(" << value << ")));\n";
+				}
+				else
+				{
+					code << "\t\t{\n";
+					code << "\t\t\tstatic const IntegerObject::InnerType value(std::string(" << ToStringLiteral(dependency) << "));\n";
+					code << "\t\t\tstack.push_back(vm->AllocInteger(value));\n";
+					code << "\t\t}\n";
+				}
+				return true;
+			}
+			case OPCODE::PUSH_FLOAT:
+			{
+				double value = 0.0;
+				try
+				{
+					value = std::stod(dependency);
+				}
+				catch (...)
+				{
+					return false; // error is reported by interpreter
+				}
+				if (std::isnan(value)) return false;
+				code << "\t\tstack.push_back(vm->AllocFloat(FloatObject::InnerType(";
+				if (std::isinf(value))
+					code << (value < 0 ? "-" : "") << "std::numeric_limits<double>::infinity()";
+				else
+					code << std::setprecision(17) << value;
+				code << ")));\n";
+				return true;
+			}
+			case OPCODE::PUSH_STRING:
+				code << "\t\t{\n";
+				code << "\t\t\tstatic const std::string value(" << ToStringLiteral(dependency) << ", " << dependency.size() << ");\n";
+				code << "\t\t\tstack.push_back(vm->AllocString(value));\n";
+				code << "\t\t}\n";
+				return true;
+			case OPCODE::PUSH_OBJECT:
+				code << "\t\tstack.push_back(vm->AllocUnknown(&deps[" << hash << "]));" << ToComment(dependency) << '\n';
+				return true;
+			case OPCODE::PUSH_THIS:
+				code << "\t\tstack.push_back(frame->classObject);\n";
+				return true;
+			case OPCODE::PUSH_NULL:
+				code << "\t\tstack.push_back(vm->AllocNull());\n";
+				return true;
+			case OPCODE::PUSH_TRUE:
+				code << "\t\tstack.push_back(vm->AllocTrue());\n";
+				return true;
+			case OPCODE::PUSH_FALSE:
+				code << "\t\tstack.push_back(vm->AllocFalse());\n";
+				return true;
+			case OPCODE::ALLOC_VAR:
+			case OPCODE::ALLOC_CONST_VAR:
+				code << "\t\t{" << ToComment(dependency) << '\n';
+				code << "\t\t\tLocal& local = frame->locals[deps[" << hash << "]] = { vm->AllocNull(), " << (instruction.op == OPCODE::ALLOC_CONST_VAR ? "true" : "false") << " };\n";
+				code << "\t\t\tstack.push_back(vm->AllocLocal(deps[" << hash << "], local));\n";
+				code << "\t\t}\n";
+				return true;
+			case OPCODE::LOAD_LOCAL:
+				// local which is not declared yet is resolved by name, as after PUSH_OBJECT
+				code << "\t\t{" << ToComment(dependency) << '\n';
+				code << "\t\t\tLocal* local = vm->GetLocalSlot(frame, " << hash << ");\n";
+				code << "\t\t\tstack.push_back(local != nullptr ? local->object : vm->AllocUnknown(&deps[" << hash << "]));\n";
+				code << "\t\t}\n";
+				return true;
+			case OPCODE::STORE_LOCAL:
+				code << "\t\tvm->PerformStoreLocal(frame, " << hash << ");" << ToComment(dependency) << '\n';
+				return true;
+			case OPCODE::POP_STACK_TOP:
+				code << "\t\tif (stack.empty()) " << leave << '\n';
+				code << "\t\tstack.pop_back();\n";
+				return true;
+			case OPCODE::SET_ALU_INCR:
+				code << "\t\tvm->GetAluIncrMode() = true;\n";
+				return true;
+			case OPCODE::JUMP_IF_TRUE:
+			case OPCODE::JUMP_IF_FALSE:
+			case OPCODE::JUMP_IF_TRUE_KEEP:
+			case OPCODE::JUMP_IF_FALSE_KEEP:
+			{
+				// only Boolean and null conditions are checked here, references and class objects are converted by interpreter
+				bool keep = instruction.op == OPCODE::JUMP_IF_TRUE_KEEP || instruction.op == OPCODE::JUMP_IF_FALSE_KEEP;
+				bool onTrue = instruction.op == OPCODE::JUMP_IF_TRUE || instruction.op == OPCODE::JUMP_IF_TRUE_KEEP;
+				code << "\t\tif (stack.empty()) " << leave << '\n';
+				code << "\t\tcondition = stack.back()->type;\n";
+				code << "\t\tif (condition != Type::TRUE && condition != Type::FALSE" << (keep ? "" : " && condition != Type::NULLPTR") << ") " << leave << '\n';
+				if (!keep) code << "\t\tstack.pop_back();\n";
+				code << "\t\tif (condition " << (onTrue ? "==" : "!=") << " Type::TRUE) goto L" << instruction.operand << ";\n";
+				return true;
+			}
+			case OPCODE::ITER_INIT:
+				code << "\t\tvm->PerformIterationInit(frame, " << hashes[0] << ", " << hashes[1] << ");\n";
+				return true;
+			case OPCODE::ITER_NEXT:
+			{
+				uint16_t label;
+				std::memcpy(&label, &body[paramsOffset], sizeof(uint16_t));
+				// VM moves frame offset to the loop end label when iteration is finished
+				code << "\t\tvm->PerformIterationNext(frame, " << hashes[0] << ", " << hashes[1] << ", " << hashes[2] << ", " << label << ");\n";
+				code << "\t\tif (errors != 0) return true;\n";
+				code << "\t\tif (frame->offset != " << instruction.next << ") goto L" << instruction.operand << ";\n";
+				return true;
+			}
+			case OPCODE::GET_MEMBER:
+				code << "\t\tif (!GetMember(vm, frame, deps[" << hash << "])) " << leave << ToComment(dependency) << '\n';
+				return true;
+			case OPCODE::CALL_FUNCTION:
+			case OPCODE::CALL_METHOD:
+			{
+				// as class method has extra implicit argument `this`, object method is called by other name
+				size_t paramSize = body[paramsOffset];
+				size_t separator = dependency.rfind('_');
+				if (separator == std::string::npos) return false;
+				std::string objectName = dependency.substr(0, separator) + '_' + std::to_string(paramSize + 1);
+				code << "\t\t{" << ToComment(dependency) << '\n';
+				code << "\t\t\tstatic const std::string objectName = " << ToStringLiteral(objectName) << ";\n";
+				code << "\t\t\tif (!CallMethod(vm, deps[" << hash << "], objectName, " << paramSize << ")) " << leave << '\n';
+				code << "\t\t}\n";
+				return true;
+			}
+			default:
+				break;
+			}
+
+			if (!IsALU(instruction.op)) return false;
+			OPCODE generic = ToGenericOpcode(instruction.op);
+			bool isUnary = generic == OPCODE::NEGATION_OP || generic == OPCODE::NEGATIVE_OP || generic == OPCODE::POSITIVE_OP;
+			std::string call = "vm->PerformALUCall(OPCODE::" + ToString(generic) + ", " + (isUnary ? "1" : "2") + ", frame);";
+			// fast paths are taken for the same operands for which interpreter quickens instruction. Incremental ALU call assigns its result, so it is never quickened
+			bool hasInteger = ToIntegerOpcode(generic) != generic && (generic == instruction.op || ToIntegerOpcode(generic) == instruction.op);
+			bool hasFloat = ToFloatOpcode(generic) != generic && (generic == instruction.op || ToFloatOpcode(generic) == instruction.op);
+			if (previous == OPCODE::SET_ALU_INCR || (!hasInteger && !hasFloat))
+			{
+				code << "\t\t" << call << '\n';
+				return true;
+			}
+			code << "\t\t{\n";
+			code << "\t\t\tconst size_t size = stack.size();\n";
+			if (hasInteger) WriteFastPath(code, generic, "IntegerObject", "INTEGER", true);
+			if (hasFloat) WriteFastPath(code, generic, "FloatObject", "FLOAT", !hasInteger);
+			code << "\t\t\telse\n";
+			code << "\t\t\t\t" << call << '\n';
+			code << "\t\t}\n";
+			return true;
+		}
+
+		bool AotTranslator::TranslateMethod(const MethodType& method, const std::string& fullName, size_t index)
+		{
+			std::vector<JitMethod::Instruction> instructions;
+			if (method.body.empty() || !JitCompiler::Decode(&method, instructions)) return false;
+
+			// translated instructions are written first, as entries and labels of method depend on them
+			std::vector<std::string> translated(instructions.size());
+			std::vector<bool> isTranslated(instructions.size(), false);
+			size_t translatedCount = 0;
+			for (size_t i = 0; i < instructions.size(); i++)
+			{
+				const JitMethod::Instruction& instruction = instructions[i];
+				if (i + 1 == instructions.size()) break; // method end is left to interpreter
+				std::ostringstream code;
+				OPCODE previous = (i > 0) ? instructions[i - 1].op : OPCODE::ERROR_SYMBOL;
+				if (JitCompiler::IsNop(instruction.op) || instruction.op == OPCODE::JUMP || TranslateInstruction(method, instruction, previous, code))
+				{
+					translated[i] = code.str();
+					isTranslated[i] = true;
+					if (!JitCompiler::IsNop(instruction.op) && instruction.op != OPCODE::JUMP) translatedCount++;
+				}
+			}
+			if (translatedCount == 0) return false;
+
+			// entries are all translated instructions, labels are written only for entries and jump targets
+			std::vector<bool> hasLabel(method.body.size() + 1, false);
+			std::ostringstream entries;
+			for (size_t i = 0; i < instructions.size(); i++)
+			{
+				const JitMethod::Instruction& instruction = instructions[i];
+				if (isTranslated[i])
+				{
+					entries << "\t\tcase " << instruction.offset << ": goto L" << instruction.offset << ";\n";
+					hasLabel[instruction.offset] = true;
+				}
+				if (instruction.op == OPCODE::JUMP || JitCompiler::IsConditionalJump(instruction.op))
+					hasLabel[instruction.operand] = true;
+			}
+
+			std::ostringstream code;
+			bool reachable = false; // code after goto and return statements is written only if it has label
+			bool usesCondition = false;
+			for (size_t i = 0; i < instructions.size(); i++)
+			{
+				const JitMethod::Instruction& instruction = instructions[i];
+				if (hasLabel[instruction.offset]) reachable = true;
+				if (!reachable) continue;
+
+				if (hasLabel[instruction.offset])
+					code << "\tL" << instruction.offset << ":\n";
+				if (JitCompiler::IsNop(instruction.op))
+					code << "\t\t;\n";
+				else if (instruction.op == OPCODE::JUMP)
+				{
+					code << "\t\tgoto L" << instruction.operand << ";\n";
+					reachable = false;
+				}
+				else if (!isTranslated[i])
+				{
+					code << "\t\tframe->offset = " << instruction.offset << ";\n\t\treturn true;\n";
+					reachable = false;
+				}
+				else
+				{
+					// offset is moved past the instruction, as interpreter does before its execution, so errors are handled by the same exception handlers
+					code << "\t\tframe->offset = " << instruction.next << ";\n";
+					code << "\t\tvm->CollectGarbage();\n";
+					code << translated[i];
+					if (instruction.op != OPCODE::ITER_NEXT)
+						code << "\t\tif (errors != 0) return true;\n";
+					usesCondition |= instruction.op == OPCODE::JUMP_IF_TRUE || instruction.op == OPCODE::JUMP_IF_FALSE ||
+						instruction.op == OPCODE::JUMP_IF_TRUE_KEEP || instruction.op == OPCODE::JUMP_IF_FALSE_KEEP;
+				}
+			}
+
+			std::string source = code.str();
+			out << "\n\t// " << fullName << '\n';
+			out << "\tbool Method" << index << "(VirtualMachine* vm, Frame* frame)\n\t{\n";
+			if (source.find("stack.") != std::string::npos)
+				out << "\t\tauto& stack = vm->GetObjectStack();\n";
+			if (source.find("deps[") != std::string::npos)
+				out << "\t\tconst auto& deps = frame->_method->dependencies;\n";
+			out << "\t\tconst uint32_t& errors = vm->GetErrors();\n";
+			if (usesCondition)
+				out << "\t\tType condition = Type::NULLPTR;\n";
+			out << "\t\tswitch (frame->offset)\n\t\t{\n";
+			out << entries.str();
+			out << "\t\tdefault: return false;\n\t\t}\n";
+			out << source;
+			out << "\t}\n";
+			return true;
+		}
+
+		void AotTranslator::Translate(const std::string& moduleName)
+		{
+			out << "// generated by MSL aot from " << moduleName << ", do not edit\n";
+			out << "// build as dll with LibMSL directory in include path and load it by `MSL run -aot " << moduleName << ".dll " << moduleName << ".emsl`\n";
+			out << "#include \"msl_types.h\" // VM sources are compiled into module, as into msl_system\n";
+			out << "#include <limits>\n\n";
+			out << "using namespace MSL::VM;\n\n";
+			out << "namespace\n{\n";
+			out << RuntimeSource;
+
+			std::string registration;
+			size_t index = 0;
+			for (const auto& _namespace : assembly.namespaces)
+			{
+				for (const auto& _class : _namespace.second.classes)
+				{
+					for (const auto& _method : _class.second.methods)
+					{
+						const MethodType& method = _method.second;
+						std::string fullName = _namespace.first + '.' + _class.first + '.' + _method.first;
+						if (!TranslateMethod(method, fullName, index))
+						{
+							methodsSkipped++;
+							continue;
+						}
+						registration += "\tresult &= vm->AddAotMethod(" + ToStringLiteral(_namespace.first) + ", " + ToStringLiteral(_class.first) + ", " +
+							ToStringLiteral(_method.first) + ", " + std::to_string(method.GetBodyHash()) + "ull, Method" + std::to_string(index) + ");\n";
+						methodsTranslated++;
+						index++;
+					}
+				}
+			}
+			out << "}\n\n";
+
+			out << "extern \"C\" __declspec(dllexport) bool _cdecl MSL_RegisterAotModule(VirtualMachine* vm)\n{\n";
+			out << "\tbool result = true;\n";
+			out << registration;
+			out << "\treturn result;\n}\n";
+		}
+
+		size_t AotTranslator::GetTranslatedCount() const
+		{
+			return methodsTranslated;
+		}
+
+		size_t AotTranslator::GetSkippedCount() const
+		{
+			return methodsSkipped;
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "assemblyType.h"
+#include "jitCompiler.h"
+#include <ostream>
+
+namespace MSL
+{
+	namespace VM
+	{
+		/*
+		translates method bodies of loaded assembly to C++ source (see MSL aot command)
+		instructions are translated to calls of public VM API with their operands written as literals: object allocations, ALU calls with inline
+		integer and float fast paths, method calls by InvokeStaticMethod() / InvokeObjectMethod() and member access by GetMemberObject()
+		jumps and method entries are translated to goto statements. Instructions which are not translated (returns, tail calls, indexing)
+		and cases which generated code does not handle (unresolved references, private methods) are left to interpreter
+		generated source is built as dll, which exports registration function attaching methods to VM by VirtualMachine::AddAotMethod() call
+		module is loaded after assembly by VirtualMachine::LoadAotModule() (see MSL run -aot option)
+		*/
+		class AotTranslator
+		{
+			const AssemblyType& assembly;
+			std::ostream& out;
+			size_t methodsTranslated = 0;
+			size_t methodsSkipped = 0;
+
+			/*
+			writes C++ statements executing instruction of method. Returns false if instruction is left to interpreter
+			previous is opcode of the instruction before it, as ALU instruction after SET_ALU_INCR has no fast path
+			*/
+			bool TranslateInstruction(const MethodType& method, const JitMethod::Instruction& instruction, OPCODE previous, std::ostream& code);
+			/*
+			writes definition of native method with index provided. Returns false if method body cannot be translated
+			*/
+			bool TranslateMethod(const MethodType& method, const std::string& fullName, size_t index);
+		public:
+			AotTranslator(const AssemblyType& assembly, std::ostream& out);
+			/*
+			writes C++ source of all methods of assembly. Registration function is named MSL_RegisterAotModule
+			*/
+			void Translate(const std::string& moduleName);
+			size_t GetTranslatedCount() const;
+			size_t GetSkippedCount() const;
+		};
+	}
+}
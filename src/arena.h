@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace MSL
+{
+	namespace utils
+	{
+		/*
+		Arena class allocates objects one after another in large memory blocks and releases all of them at once
+		objects cannot be freed one by one. Destructors of objects which need them are called by Arena::Release() in reverse order
+		*/
+		class Arena
+		{
+			/*
+			memory block in which objects are allocated. Blocks are linked from the last one to the first one
+			*/
+			struct Block
+			{
+				Block* previous;
+			};
+			/*
+			record of object with non-trivial destructor. Records are linked from the last one to the first one
+			*/
+			struct Destructor
+			{
+				Destructor* previous;
+				void(*destroy)(void* object);
+				void* object;
+			};
+
+			/*
+			block in which objects are currently allocated
+			*/
+			Block* block = nullptr;
+			/*
+			list of objects which must be destroyed on release
+			*/
+			Destructor* destructors = nullptr;
+			/*
+			current position in block and its end
+			*/
+			uint8_t* position = nullptr;
+			uint8_t* end = nullptr;
+			/*
+			total memory allocated by arena in bytes
+			*/
+			size_t allocatedSize = 0;
+
+			/*
+			allocates new block which fits at least size bytes
+			*/
+			void Grow(size_t size);
+			/*
+			calls destructor of object of type T
+			*/
+			template<typename T>
+			static void Destroy(void* object);
+		public:
+			/*
+			default size of memory block in bytes
+			*/
+			static constexpr size_t blockSize = 64 * 1024;
+
+			Arena() = default;
+			/*
+			arena cannot be copied, as objects are bound to its memory
+			*/
+			Arena(const Arena&) = delete;
+			Arena& operator=(const Arena&) = delete;
+			~Arena();
+
+			/*
+			allocates uninitialized memory of size bytes aligned to alignment, which must be a power of two
+			*/
+			void* Allocate(size_t size, size_t alignment);
+			/*
+			allocates object in arena and constructs it with arguments provided
+			*/
+			template<typename T, typename... Args>
+			T* New(Args&&... args);
+			/*
+			destroys all objects and releases memory. Arena can be used again after this call
+			*/
+			void Release();
+			/*
+			returns total memory allocated by arena in bytes
+			*/
+			size_t GetAllocatedSize() const;
+		};
+
+		inline void Arena::Grow(size_t size)
+		{
+			size_t capacity = sizeof(Block) + size;
+			if (capacity < blockSize) capacity = blockSize;
+			Block* next = static_cast<Block*>(std::malloc(capacity));
+			if (next == nullptr) throw std::bad_alloc();
+			next->previous = block;
+			block = next;
+			position = reinterpret_cast<uint8_t*>(block + 1);
+			end = reinterpret_cast<uint8_t*>(block) + capacity;
+			allocatedSize += capacity;
+		}
+
+		template<typename T>
+		inline void Arena::Destroy(void* object)
+		{
+			static_cast<T*>(object)->~T();
+		}
+
+		inline Arena::~Arena()
+		{
+			Release();
+		}
+
+		inline void* Arena::Allocate(size_t size, size_t alignment)
+		{
+			uintptr_t address = (reinterpret_cast<uintptr_t>(position) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			if (position == nullptr || address + size > reinterpret_cast<uintptr_t>(end))
+			{
+				Grow(size + alignment);
+				address = (reinterpret_cast<uintptr_t>(position) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			}
+			position = reinterpret_cast<uint8_t*>(address + size);
+			return reinterpret_cast<void*>(address);
+		}
+
+		template<typename T, typename... Args>
+		inline T* Arena::New(Args&&... args)
+		{
+			if (std::is_trivially_destructible<T>::value)
+			{
+				return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			}
+			Destructor* destructor = static_cast<Destructor*>(Allocate(sizeof(Destructor), alignof(Destructor)));
+			T* object = new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			// record is linked only after object was constructed, so it is not destroyed if constructor throws
+			destructor->previous = destructors;
+			destructor->destroy = &Arena::Destroy<T>;
+			destructor->object = object;
+			destructors = destructor;
+			return object;
+		}
+
+		inline void Arena::Release()
+		{
+			for (Destructor* destructor = destructors; destructor != nullptr; destructor = destructor->previous)
+			{
+				destructor->destroy(destructor->object);
+			}
+			destructors = nullptr;
+			while (block != nullptr)
+			{
+				Block* previous = block->previous;
+				std::free(block);
+				block = previous;
+			}
+			position = end = nullptr;
+			allocatedSize = 0;
+		}
+
+		inline size_t Arena::GetAllocatedSize() const
+		{
+			return allocatedSize;
+		}
+	}
+}
@@ -26,6 +26,11 @@ namespace MSL
 			return namespaces;
 		}
 
+		Assembly::NamespaceArray& Assembly::GetNamespaces()
+		{
+			return namespaces;
+		}
+
 		bool Assembly::ContainsNamespace(const std::string& namespaceName) const
 		{
 			return table.find(namespaceName) != table.end();
@@ -50,6 +50,10 @@ namespace MSL
 			*/
 			const NamespaceArray& GetNamespaces() const;
 			/*
+			returns reference to all namespaces in assembly. Used by optimizer to modify method bodies
+			*/
+			NamespaceArray& GetNamespaces();
+			/*
 			checks if assembly already contains namespace with given name
 			*/
 			bool ContainsNamespace(const std::string& namespaceName) const;
@@ -1,4 +1,8 @@
 #include "assemblyEditor.h"
+#include <cstring>
+#include <iterator>
+#include <initializer_list>
+#include <sstream>
 
 using namespace MSL::utils;
 
@@ -14,6 +18,7 @@ namespace MSL
 
 		bool AssemblyEditor::ExpectOpcode(OPCODE expected, OPCODE current)
 		{
+			if (!success) return false; // assembly ended unexpectedly or contains invalid operand
 			if (!performCheck) return true;
 
 			if (expected != current)
@@ -25,13 +30,66 @@ namespace MSL
 			return true;
 		}
 
+		bool AssemblyEditor::CheckVersion(uint16_t version)
+		{
+			if (version > BYTECODE_VERSION)
+			{
+				DisplayError("Assembly version " + std::to_string(version) + " is not supported, latest supported version: " + std::to_string(BYTECODE_VERSION));
+				errors |= ERROR::UNSUPPORTED_VERSION;
+				return false;
+			}
+			return true;
+		}
+
+		bool AssemblyEditor::CheckRemaining(size_t size)
+		{
+			if (static_cast<size_t>(end - position) >= size) return true;
+			if (success)
+			{
+				DisplayError("Assembly ended unexpectedly at position: " + std::to_string(end - begin));
+				errors |= ERROR::UNEXPECTED_END;
+			}
+			position = end;
+			return false;
+		}
+
 		AssemblyEditor::AssemblyEditor(std::istream* binaryFile, std::ostream* errorStream)
-			: file(*binaryFile), error(*errorStream), success(true) { }
+			: error(*errorStream), success(true)
+		{
+			auto buffer = std::make_shared<std::string>(std::istreambuf_iterator<char>(*binaryFile), std::istreambuf_iterator<char>());
+			begin = position = reinterpret_cast<const uint8_t*>(buffer->data());
+			end = begin + buffer->size();
+			owner = std::move(buffer);
+		}
+
+		AssemblyEditor::AssemblyEditor(const uint8_t* data, size_t size, std::ostream* errorStream, std::shared_ptr<const void> owner)
+			: owner(std::move(owner)), begin(data), position(data), end(data + size), error(*errorStream), success(true) { }
+
+		void AssemblyEditor::SetLazyDecoding(bool lazy)
+		{
+			lazyDecoding = lazy;
+		}
+
+		bool AssemblyEditor::DecodeMethodBody(const MethodType& method, std::ostream* errorStream)
+		{
+			if (method.encodedBody == nullptr) return true;
+			// body is decoded once in place, as VM quickening does with its instructions
+			MethodType& decoded = const_cast<MethodType&>(method);
+			std::ostringstream ignoredErrors;
+			AssemblyEditor editor(method.encodedBody, method.encodedBodySize, errorStream != nullptr ? errorStream : &ignoredErrors);
+			editor.compactFormat = true;
+			decoded.encodedBody = nullptr;
+			decoded.encodedBodySize = 0;
+			editor.ReadMethodBody(decoded);
+			decoded.body.shrink_to_fit();
+			return editor.success && editor.CheckLabels(decoded);
+		}
 
 		bool AssemblyEditor::MergeAssemblies(AssemblyType& assembly, bool checkErrors, CallPath* callPath)
 		{
 			performCheck = checkErrors;
 			entryPoint = callPath;
+			target = &assembly;
 			AssemblyType secondAssembly = ReadAssembly();
 
 			std::string namespaceEntry;
@@ -55,6 +113,10 @@ namespace MSL
 			{
 				callPath->SetNamespace(&assembly.namespaces[namespaceEntry].name);
 			}
+			if (success && lazyDecoding && owner != nullptr && hasBodySize)
+			{
+				assembly.images.push_back(owner); // method bodies still reference it
+			}
 			return success;
 		}
 
@@ -66,8 +128,43 @@ namespace MSL
 		AssemblyType AssemblyEditor::ReadAssembly()
 		{
 			AssemblyType assembly;
-			if (!ExpectOpcode(OPCODE::ASSEMBLY_BEGIN_DECL, ReadOPCode())) return assembly;
-			if (!ExpectOpcode(OPCODE::NAMESPACE_POOL_DECL_SIZE, ReadOPCode())) return assembly;
+			OPCODE op;
+			if (position != end && *position == BYTECODE_MAGIC[0]) // assembly in compact format starts with header
+			{
+				if (!CheckRemaining(sizeof(BYTECODE_MAGIC))) return assembly;
+				if (std::memcmp(position, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0)
+				{
+					position += sizeof(SNAPSHOT_MAGIC);
+					return ReadSnapshot();
+				}
+				bool validMagic = std::memcmp(position, BYTECODE_MAGIC, sizeof(BYTECODE_MAGIC)) == 0;
+				position += sizeof(BYTECODE_MAGIC);
+				if (!validMagic)
+				{
+					DisplayError("Assembly header is invalid");
+					errors |= ERROR::INVALID_OPCODE;
+					return assembly;
+				}
+				uint16_t version = GenericRead<uint16_t>();
+				if (!CheckVersion(version)) return assembly;
+				compactFormat = version >= COMPACT_BYTECODE_VERSION;
+				hasConstantPool = version >= CONSTANT_POOL_BYTECODE_VERSION;
+				hasBodySize = version >= BODY_SIZE_BYTECODE_VERSION;
+				if (!ExpectOpcode(OPCODE::ASSEMBLY_BEGIN_DECL, ReadOPCode())) return assembly;
+				if (hasConstantPool && !ReadConstantPool()) return assembly;
+				op = ReadOPCode();
+			}
+			else
+			{
+				if (!ExpectOpcode(OPCODE::ASSEMBLY_BEGIN_DECL, ReadOPCode())) return assembly;
+				op = ReadOPCode();
+				if (op == OPCODE::ASSEMBLY_VERSION_DECL) // assemblies of version 1 have no version declaration
+				{
+					if (!CheckVersion(GenericRead<uint16_t>())) return assembly;
+					op = ReadOPCode();
+				}
+			}
+			if (!ExpectOpcode(OPCODE::NAMESPACE_POOL_DECL_SIZE, op)) return assembly;
 			size_t namespacePoolSize = ReadSize();
 			ReserveExtraSpace(assembly.namespaces, namespacePoolSize);
 			
@@ -93,6 +190,379 @@ namespace MSL
 			return assembly;
 		}
 
+		/*
+		snapshot structure:
+			[SNAPSHOT_MAGIC] [uint16 SNAPSHOT_VERSION] [uint16 BYTECODE_VERSION] [uint8 sizeof(size_t)]
+			[symbol count] [symbols] -> symbol pool of assembly, method dependencies are indices in it
+			[namespace count] [namespaces]:
+				[name] [friend count] [friends] [class count] [classes]:
+					[name] [modifiers] [attribute count] [[name] [modifiers]] [method count] [methods]:
+						[name] [modifiers] [parameter count] [parameters] [dependency count] [dependency indices]
+						[label count] [label offsets] [body size] [body bytes]
+			[static state of VM] -> written by HeapSnapshot
+		counts, sizes and indices are LEB128 integers, strings are [LEB128 size][char[] char_array]
+		method names include overload suffix and bodies are stored with fixed-size operands, as VM executes them
+		*/
+		AssemblyType AssemblyEditor::ReadSnapshot()
+		{
+			AssemblyType assembly;
+			uint16_t snapshotVersion = GenericRead<uint16_t>();
+			uint16_t bytecodeVersion = GenericRead<uint16_t>();
+			uint8_t hashSize = GenericRead<uint8_t>();
+			if (!success) return assembly;
+			if (snapshotVersion != SNAPSHOT_VERSION || bytecodeVersion != BYTECODE_VERSION || hashSize != sizeof(size_t))
+			{
+				DisplayError("Snapshot was written by another VM version (snapshot version " + std::to_string(snapshotVersion) +
+					", bytecode version " + std::to_string(bytecodeVersion) + "), it must be created again");
+				errors |= ERROR::UNSUPPORTED_VERSION;
+				return assembly;
+			}
+			compactFormat = true;
+
+			size_t symbolCount = ReadSize();
+			constantPool.clear();
+			for (size_t i = 0; i < symbolCount && success; i++)
+			{
+				constantPool.push_back(target->InternSymbol(ReadString()));
+			}
+
+			size_t namespaceCount = ReadSize();
+			ReserveExtraSpace(assembly.namespaces, namespaceCount);
+			for (size_t i = 0; i < namespaceCount && success; i++)
+			{
+				NamespaceType ns = ReadSnapshotNamespace();
+				std::string namespaceName = ns.name;
+				assembly.namespaces.insert({ namespaceName, std::move(ns) });
+				if (entryPoint != nullptr && entryPoint->GetNamespace() == nullptr && entryPoint->GetClass() != nullptr)
+				{
+					entryPoint->SetNamespace(&assembly.namespaces[namespaceName].name);
+				}
+			}
+			snapshotHeap = position;
+			return assembly;
+		}
+
+		const uint8_t* AssemblyEditor::GetSnapshotHeap(size_t& size) const
+		{
+			size = snapshotHeap != nullptr ? end - snapshotHeap : 0;
+			return snapshotHeap;
+		}
+
+		NamespaceType AssemblyEditor::ReadSnapshotNamespace()
+		{
+			NamespaceType ns;
+			ns.name = ReadString();
+			size_t friendCount = ReadSize();
+			for (size_t i = 0; i < friendCount && success; i++)
+			{
+				ns.friendNamespaces.insert(ReadString());
+			}
+			size_t classCount = ReadSize();
+			ReserveExtraSpace(ns.classes, classCount);
+			for (size_t i = 0; i < classCount && success; i++)
+			{
+				ClassType c = ReadSnapshotClass();
+				std::string className = c.name;
+				c.namespaceName = ns.name;
+				ns.classes.insert({ className, std::move(c) });
+				if (entryPoint != nullptr && entryPoint->GetClass() == nullptr && entryPoint->GetMethod() != nullptr)
+				{
+					entryPoint->SetClass(&ns.classes[className].name);
+				}
+			}
+			return ns;
+		}
+
+		ClassType AssemblyEditor::ReadSnapshotClass()
+		{
+			ClassType c;
+			c.name = ReadString();
+			c.modifiers = ReadModifiers();
+			size_t attributeCount = ReadSize();
+			for (size_t i = 0; i < attributeCount && success; i++)
+			{
+				AttributeType attr;
+				attr.name = ReadString();
+				attr.modifiers = ReadModifiers();
+				std::string attributeName = attr.name;
+				if (attr.modifiers & AttributeType::Modifiers::STATIC)
+					c.staticAttributes.insert({ attributeName, std::move(attr) });
+				else
+					c.objectAttributes.insert({ attributeName, std::move(attr) });
+			}
+			size_t methodCount = ReadSize();
+			ReserveExtraSpace(c.methods, methodCount);
+			for (size_t i = 0; i < methodCount && success; i++)
+			{
+				MethodType method = ReadSnapshotMethod();
+				std::string methodName = method.name;
+				bool isEntryPoint = (method.modifiers & MethodType::Modifiers::ENTRY_POINT) != 0;
+				c.methods.insert({ methodName, std::move(method) });
+				if (entryPoint != nullptr && isEntryPoint)
+				{
+					if (entryPoint->GetMethod() != nullptr)
+					{
+						DisplayError("Trying to add second entry-point to assembly: " + c.name + '.' + methodName);
+						errors |= ERROR::ENTRY_POINT_DUBLICATE;
+					}
+					else
+					{
+						entryPoint->SetMethod(&c.methods[methodName].name);
+					}
+				}
+			}
+			return c;
+		}
+
+		MethodType AssemblyEditor::ReadSnapshotMethod()
+		{
+			MethodType method;
+			method.name = ReadString();
+			method.modifiers = ReadModifiers();
+			size_t parameterCount = ReadSize();
+			for (size_t i = 0; i < parameterCount && success; i++)
+			{
+				method.parameters.push_back(ReadString());
+			}
+			size_t dependencyCount = ReadSize();
+			method.dependencies.reserve(dependencyCount);
+			for (size_t i = 0; i < dependencyCount && success; i++)
+			{
+				size_t index = ReadSize();
+				if (index >= constantPool.size())
+				{
+					DisplayError("Found invalid symbol index: " + std::to_string(index));
+					errors |= ERROR::INVALID_OPERAND;
+					return method;
+				}
+				method.dependencies.push_back(constantPool[index]);
+			}
+			size_t labelCount = ReadSize();
+			method.labels.resize(labelCount);
+			for (size_t i = 0; i < labelCount && success; i++)
+			{
+				method.labels[i] = ReadSize();
+			}
+			size_t bodySize = ReadSize();
+			if (!CheckRemaining(bodySize)) return method;
+			method.body.assign(position, position + bodySize);
+			position += bodySize;
+
+			if (performCheck) CheckLabels(method);
+			return method;
+		}
+
+		static void WriteSnapshotString(std::ostream& out, const std::string& str)
+		{
+			WriteVarint(out, str.size());
+			out.write(str.data(), str.size());
+		}
+
+		void AssemblyEditor::WriteSnapshot(const AssemblyType& assembly, std::ostream& out)
+		{
+			std::unordered_map<const std::string*, size_t> symbolIndices;
+			symbolIndices.reserve(assembly.symbols.size());
+			out.write(reinterpret_cast<const char*>(SNAPSHOT_MAGIC), sizeof(SNAPSHOT_MAGIC));
+			uint16_t versions[] = { SNAPSHOT_VERSION, BYTECODE_VERSION };
+			out.write(reinterpret_cast<const char*>(versions), sizeof(versions));
+			out.put(static_cast<char>(sizeof(size_t)));
+
+			WriteVarint(out, assembly.symbols.size());
+			for (const std::string& symbol : assembly.symbols)
+			{
+				symbolIndices.insert({ &symbol, symbolIndices.size() });
+				WriteSnapshotString(out, symbol);
+			}
+
+			WriteVarint(out, assembly.namespaces.size());
+			for (const auto& ns : assembly.namespaces)
+			{
+				WriteSnapshotString(out, ns.second.name);
+				WriteVarint(out, ns.second.friendNamespaces.size());
+				for (const auto& friendNamespace : ns.second.friendNamespaces)
+				{
+					WriteSnapshotString(out, friendNamespace);
+				}
+				size_t classCount = 0;
+				for (const auto& c : ns.second.classes)
+				{
+					if (!c.second.isSystem()) classCount++;
+				}
+				WriteVarint(out, classCount);
+				for (const auto& c : ns.second.classes)
+				{
+					const ClassType& _class = c.second;
+					if (_class.isSystem()) continue; // native classes are added by VM on launch
+					WriteSnapshotString(out, _class.name);
+					out.put(static_cast<char>(_class.modifiers));
+					WriteVarint(out, _class.staticAttributes.size() + _class.objectAttributes.size());
+					for (const auto* attributes : { &_class.staticAttributes, &_class.objectAttributes })
+					{
+						for (const auto& attr : *attributes)
+						{
+							WriteSnapshotString(out, attr.second.name);
+							out.put(static_cast<char>(attr.second.modifiers));
+						}
+					}
+					WriteVarint(out, _class.methods.size());
+					for (const auto& m : _class.methods)
+					{
+						const MethodType& method = m.second;
+						WriteSnapshotString(out, method.name);
+						out.put(static_cast<char>(method.modifiers));
+						WriteVarint(out, method.parameters.size());
+						for (const auto& parameter : method.parameters)
+						{
+							WriteSnapshotString(out, parameter);
+						}
+						WriteVarint(out, method.dependencies.size());
+						for (size_t i = 0; i < method.dependencies.size(); i++)
+						{
+							WriteVarint(out, symbolIndices[&method.dependencies[i]]);
+						}
+						WriteVarint(out, method.labels.size());
+						for (size_t label : method.labels)
+						{
+							WriteVarint(out, label);
+						}
+						WriteVarint(out, method.body.size());
+						out.write(reinterpret_cast<const char*>(method.body.data()), method.body.size());
+					}
+				}
+			}
+		}
+
+		static void WriteAssemblyString(std::ostream& out, const std::string& str)
+		{
+			out.put(static_cast<char>(OPCODE::STRING_DECL));
+			WriteVarint(out, str.size());
+			out.write(str.data(), str.size());
+		}
+
+		void AssemblyEditor::WriteAssembly(const AssemblyType& assembly, std::ostream& out)
+		{
+			std::unordered_map<const std::string*, size_t> constantIndices;
+			std::vector<const std::string*> constants;
+			for (const auto& ns : assembly.namespaces)
+			{
+				for (const auto& c : ns.second.classes)
+				{
+					if (c.second.isSystem()) continue;
+					for (const auto& m : c.second.methods)
+					{
+						for (size_t i = 0; i < m.second.dependencies.size(); i++)
+						{
+							const std::string* dependency = &m.second.dependencies[i];
+							if (constantIndices.insert({ dependency, constants.size() }).second) constants.push_back(dependency);
+						}
+					}
+				}
+			}
+
+			out.write(reinterpret_cast<const char*>(BYTECODE_MAGIC), sizeof(BYTECODE_MAGIC));
+			uint16_t version = BYTECODE_VERSION;
+			out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+			out.put(static_cast<char>(OPCODE::ASSEMBLY_BEGIN_DECL));
+			out.put(static_cast<char>(OPCODE::CONSTANT_POOL_DECL_SIZE));
+			WriteVarint(out, constants.size());
+			for (const std::string* constant : constants)
+			{
+				WriteAssemblyString(out, *constant);
+			}
+
+			out.put(static_cast<char>(OPCODE::NAMESPACE_POOL_DECL_SIZE));
+			WriteVarint(out, assembly.namespaces.size());
+			for (const auto& ns : assembly.namespaces)
+			{
+				WriteAssemblyString(out, ns.second.name);
+				out.put(static_cast<char>(OPCODE::FRIEND_POOL_DECL_SIZE));
+				WriteVarint(out, ns.second.friendNamespaces.size());
+				for (const auto& friendNamespace : ns.second.friendNamespaces)
+				{
+					WriteAssemblyString(out, friendNamespace);
+				}
+				size_t classCount = 0;
+				for (const auto& c : ns.second.classes)
+				{
+					if (!c.second.isSystem()) classCount++;
+				}
+				out.put(static_cast<char>(OPCODE::CLASS_POOL_DECL_SIZE));
+				WriteVarint(out, classCount);
+				for (const auto& c : ns.second.classes)
+				{
+					const ClassType& _class = c.second;
+					if (_class.isSystem()) continue; // native classes are added by VM on launch
+					WriteAssemblyString(out, _class.name);
+					out.put(static_cast<char>(OPCODE::MODIFIERS_DECL));
+					out.put(static_cast<char>(_class.modifiers));
+					out.put(static_cast<char>(OPCODE::ATTRIBUTE_POOL_DECL_SIZE));
+					WriteVarint(out, _class.staticAttributes.size() + _class.objectAttributes.size());
+					for (const auto* attributes : { &_class.staticAttributes, &_class.objectAttributes })
+					{
+						for (const auto& attr : *attributes)
+						{
+							WriteAssemblyString(out, attr.second.name);
+							out.put(static_cast<char>(OPCODE::MODIFIERS_DECL));
+							out.put(static_cast<char>(attr.second.modifiers));
+						}
+					}
+					out.put(static_cast<char>(OPCODE::METHOD_POOL_DECL_SIZE));
+					WriteVarint(out, _class.methods.size());
+					for (const auto& m : _class.methods)
+					{
+						const MethodType& method = m.second;
+						// suffix for overloading is added again when assembly is read (see ReadClass)
+						std::string suffix = method.isStaticConstructor() ? "_0static" : '_' + std::to_string(method.parameters.size());
+						WriteAssemblyString(out, method.name.substr(0, method.name.size() - suffix.size()));
+						out.put(static_cast<char>(OPCODE::MODIFIERS_DECL));
+						out.put(static_cast<char>(method.modifiers));
+						out.put(static_cast<char>(OPCODE::METHOD_PARAMS_DECL_SIZE));
+						WriteVarint(out, method.parameters.size());
+						for (const auto& parameter : method.parameters)
+						{
+							WriteAssemblyString(out, parameter);
+						}
+						out.put(static_cast<char>(OPCODE::DEPENDENCY_POOL_DECL_SIZE));
+						WriteVarint(out, method.dependencies.size());
+						for (size_t i = 0; i < method.dependencies.size(); i++)
+						{
+							WriteVarint(out, constantIndices[&method.dependencies[i]]);
+						}
+						out.put(static_cast<char>(OPCODE::METHOD_BODY_BEGIN_DECL));
+						if (method.encodedBody != nullptr)
+						{
+							// body which is not decoded yet is already encoded and followed by METHOD_BODY_END_DECL
+							WriteVarint(out, method.encodedBodySize - 1);
+							out.write(reinterpret_cast<const char*>(method.encodedBody), method.encodedBodySize);
+							continue;
+						}
+						utils::ByteBuffer body;
+						// decoded body has no SET_LABEL instructions, they are restored from label offsets
+						EncodeMethodBody(method.body.data(), method.body.size(), body, &method.labels);
+						WriteVarint(out, body.GetSize());
+						out.write(reinterpret_cast<const char*>(body.GetData()), body.GetSize());
+						out.put(static_cast<char>(OPCODE::METHOD_BODY_END_DECL));
+					}
+				}
+			}
+			out.put(static_cast<char>(OPCODE::ASSEMBLY_END_DECL));
+		}
+
+		bool AssemblyEditor::ReadConstantPool()
+		{
+			if (!ExpectOpcode(OPCODE::CONSTANT_POOL_DECL_SIZE, ReadOPCode())) return false;
+			size_t constantPoolSize = ReadSize();
+			constantPool.clear();
+			constantPool.reserve(constantPoolSize);
+			for (size_t i = 0; i < constantPoolSize && success; i++)
+			{
+				if (!ExpectOpcode(OPCODE::STRING_DECL, ReadOPCode())) return false;
+				// strings are written with escape sequences already replaced
+				constantPool.push_back(target->InternSymbol(ReadString()));
+			}
+			return success;
+		}
+
 		NamespaceType AssemblyEditor::ReadNamespace()
 		{
 			NamespaceType ns;
@@ -173,20 +643,7 @@ namespace MSL
 				MethodType method = ReadMethod();
 				method.body.shrink_to_fit(); // optimizing memory usage
 				if (!success) return c;
-
-				if (performCheck)
-				{
-					for (size_t i = 0; i < method.labels.size(); i++)
-					{
-						size_t offset = method.labels[i];
-						if (offset >= method.body.size())
-						{
-							DisplayError("Found invalid label offset (label #" + std::to_string(i) + "): " + std::to_string(offset));
-							errors |= ERROR::INVALID_METHOD_LABEL;
-							return c;
-						}
-					}
-				}
+				if (performCheck && !CheckLabels(method)) return c;
 				if (method.modifiers & MethodType::Modifiers::STATIC_CONSTRUCTOR)
 				{
 					method.name += "_0static";
@@ -246,18 +703,62 @@ namespace MSL
 
 			for (size_t i = 0; i < dependencyPoolSize; i++)
 			{
-				if (!ExpectOpcode(OPCODE::STRING_DECL, ReadOPCode())) return method;
-				method.dependencies.push_back(ReadString());
+				if (hasConstantPool)
+				{
+					size_t index = ReadSize();
+					if (index >= constantPool.size())
+					{
+						DisplayError("Found invalid constant pool index: " + std::to_string(index));
+						errors |= ERROR::INVALID_OPERAND;
+						return method;
+					}
+					method.dependencies.push_back(constantPool[index]);
+				}
+				else
+				{
+					if (!ExpectOpcode(OPCODE::STRING_DECL, ReadOPCode())) return method;
+					method.dependencies.push_back(target->InternSymbol(replaceEscapeTokens(ReadString())));
+				}
 			}
 
-			for (size_t i = 0; i < method.dependencies.size(); i++)
+			if (!ExpectOpcode(OPCODE::METHOD_BODY_BEGIN_DECL, ReadOPCode())) return method;
+			if (hasBodySize)
 			{
-				method.dependencies[i] = replaceEscapeTokens(method.dependencies[i]);
+				size_t bodySize = ReadSize();
+				// encoded body is followed by METHOD_BODY_END_DECL
+				if (!CheckRemaining(bodySize) || !CheckRemaining(bodySize + 1)) return method;
+				if (lazyDecoding && owner != nullptr)
+				{
+					method.encodedBody = position;
+					method.encodedBodySize = bodySize + 1;
+					position += bodySize;
+					ExpectOpcode(OPCODE::METHOD_BODY_END_DECL, ReadOPCode());
+					return method;
+				}
 			}
+			ReadMethodBody(method);
+			return method;
+		}
 
-			if (!ExpectOpcode(OPCODE::METHOD_BODY_BEGIN_DECL, ReadOPCode())) return method;
+		bool AssemblyEditor::CheckLabels(const MethodType& method)
+		{
+			for (size_t i = 0; i < method.labels.size(); i++)
+			{
+				size_t offset = method.labels[i];
+				if (offset >= method.body.size())
+				{
+					DisplayError("Found invalid label offset (label #" + std::to_string(i) + "): " + std::to_string(offset));
+					errors |= ERROR::INVALID_METHOD_LABEL;
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void AssemblyEditor::ReadMethodBody(MethodType& method)
+		{
 			OPCODE op = OPCODE::METHOD_BODY_BEGIN_DECL;
-			ReserveExtraSpace(method.body, dependencyPoolSize);
+			ReserveExtraSpace(method.body, method.dependencies.size());
 
 			while (op != OPCODE::ERROR_SYMBOL)
 			{
@@ -344,6 +845,11 @@ namespace MSL
                     WRITE_OPCODE(OPCODE::CALL_FUNCTION);
                     WRITE_HASH;
                     WRITE_OPCODE(GenericRead<uint8_t>());
+                    break;
+                case (OPCODE::TAIL_CALL):
+                    WRITE_OPCODE(OPCODE::TAIL_CALL);
+                    WRITE_HASH;
+                    WRITE_OPCODE(GenericRead<uint8_t>());
                     break;
 				case (OPCODE::CMP_EQ):
 					WRITE_OPCODE(OPCODE::CMP_EQ);
@@ -398,24 +904,102 @@ namespace MSL
 					WRITE_OPCODE(OPCODE::JUMP_IF_FALSE);
 					WRITE_LABEL;
 					break;
+				case (OPCODE::JUMP_IF_FALSE_KEEP):
+					WRITE_OPCODE(OPCODE::JUMP_IF_FALSE_KEEP);
+					WRITE_LABEL;
+					break;
+				case (OPCODE::JUMP_IF_TRUE_KEEP):
+					WRITE_OPCODE(OPCODE::JUMP_IF_TRUE_KEEP);
+					WRITE_LABEL;
+					break;
+				case (OPCODE::SUM_INT):
+					WRITE_OPCODE(OPCODE::SUM_INT);
+					break;
+				case (OPCODE::SUB_INT):
+					WRITE_OPCODE(OPCODE::SUB_INT);
+					break;
+				case (OPCODE::MULT_INT):
+					WRITE_OPCODE(OPCODE::MULT_INT);
+					break;
+				case (OPCODE::CMP_EQ_INT):
+					WRITE_OPCODE(OPCODE::CMP_EQ_INT);
+					break;
+				case (OPCODE::CMP_NEQ_INT):
+					WRITE_OPCODE(OPCODE::CMP_NEQ_INT);
+					break;
+				case (OPCODE::CMP_L_INT):
+					WRITE_OPCODE(OPCODE::CMP_L_INT);
+					break;
+				case (OPCODE::CMP_G_INT):
+					WRITE_OPCODE(OPCODE::CMP_G_INT);
+					break;
+				case (OPCODE::CMP_LE_INT):
+					WRITE_OPCODE(OPCODE::CMP_LE_INT);
+					break;
+				case (OPCODE::CMP_GE_INT):
+					WRITE_OPCODE(OPCODE::CMP_GE_INT);
+					break;
+				case (OPCODE::SUM_FLOAT):
+					WRITE_OPCODE(OPCODE::SUM_FLOAT);
+					break;
+				case (OPCODE::SUB_FLOAT):
+					WRITE_OPCODE(OPCODE::SUB_FLOAT);
+					break;
+				case (OPCODE::MULT_FLOAT):
+					WRITE_OPCODE(OPCODE::MULT_FLOAT);
+					break;
+				case (OPCODE::DIV_FLOAT):
+					WRITE_OPCODE(OPCODE::DIV_FLOAT);
+					break;
+				case (OPCODE::CMP_L_FLOAT):
+					WRITE_OPCODE(OPCODE::CMP_L_FLOAT);
+					break;
+				case (OPCODE::CMP_G_FLOAT):
+					WRITE_OPCODE(OPCODE::CMP_G_FLOAT);
+					break;
+				case (OPCODE::CMP_LE_FLOAT):
+					WRITE_OPCODE(OPCODE::CMP_LE_FLOAT);
+					break;
+				case (OPCODE::CMP_GE_FLOAT):
+					WRITE_OPCODE(OPCODE::CMP_GE_FLOAT);
+					break;
 				case (OPCODE::POP_STACK_TOP):
 					WRITE_OPCODE(OPCODE::POP_STACK_TOP);
 					break;
 				case (OPCODE::POP_CATCH):
 					WRITE_OPCODE(OPCODE::POP_CATCH);
 					break;
+				case (OPCODE::ITER_INIT):
+					WRITE_OPCODE(OPCODE::ITER_INIT);
+					WRITE_HASH; // container
+					WRITE_HASH; // iterator
+					break;
+				case (OPCODE::ITER_NEXT):
+					WRITE_OPCODE(OPCODE::ITER_NEXT);
+					WRITE_HASH; // element
+					WRITE_HASH; // container
+					WRITE_HASH; // iterator
+					WRITE_LABEL;
+					break;
+				case (OPCODE::LOAD_LOCAL):
+					WRITE_OPCODE(OPCODE::LOAD_LOCAL);
+					WRITE_HASH;
+					break;
+				case (OPCODE::STORE_LOCAL):
+					WRITE_OPCODE(OPCODE::STORE_LOCAL);
+					WRITE_HASH;
+					break;
 				case (OPCODE::METHOD_BODY_END_DECL):
-					return method; // success
+					return; // success
 				default:
 					ExpectOpcode(OPCODE::METHOD_BODY_END_DECL, op); // reaches only if error occured
-					return method; // error occured
+					return; // error occured
 				}
 			}
 			#undef WRITE_OPCODE
 			#undef WRITE_LABEL
 			#undef WRITE_HASH
 			ExpectOpcode(OPCODE::METHOD_BODY_END_DECL, op); // reaches only if error occured
-			return method;
 		}
 
 		void AssemblyEditor::MergeNamespaces(NamespaceType& ns1, NamespaceType& ns2)
@@ -448,12 +1032,21 @@ namespace MSL
 
 		OPCODE AssemblyEditor::ReadOPCode()
 		{
+			if (!CheckRemaining(sizeof(OPCODE))) return OPCODE::ERROR_SYMBOL;
 			return GenericRead<VM::OPCODE>();
 		}
 
 		size_t AssemblyEditor::ReadSize()
 		{
-			return GenericRead<size_t>();
+			if (!compactFormat) return GenericRead<size_t>();
+
+			uint64_t size = 0;
+			if (!ReadVarint(position, end, size) && success)
+			{
+				DisplayError("Found invalid variable-length integer at position: " + std::to_string(position - begin));
+				errors |= ERROR::INVALID_OPERAND;
+			}
+			return static_cast<size_t>(size);
 		}
 
 		uint8_t AssemblyEditor::ReadModifiers()
@@ -463,15 +1056,24 @@ namespace MSL
 
 		uint16_t AssemblyEditor::ReadLabel()
 		{
-			return GenericRead<uint16_t>();
+			if (!compactFormat) return GenericRead<uint16_t>();
+
+			size_t label = ReadSize();
+			if (label > UINT16_MAX && success)
+			{
+				DisplayError("Found label which is out of range: " + std::to_string(label));
+				errors |= ERROR::INVALID_METHOD_LABEL;
+			}
+			return static_cast<uint16_t>(label);
 		}
 
 		std::string AssemblyEditor::ReadString()
 		{
 			using StringSize = uint16_t;
-			StringSize size = GenericRead<StringSize>();
-			std::string res(size, '?');
-			file.read(&res[0], size);
+			size_t size = compactFormat ? ReadSize() : GenericRead<StringSize>();
+			if (!CheckRemaining(size)) return std::string();
+			std::string res(reinterpret_cast<const char*>(position), size);
+			position += size;
 			return res;
 		}
 	}
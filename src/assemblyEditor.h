@@ -3,6 +3,7 @@
 #include "assemblyType.h"
 #include "opcode.h"
 #include "stringExtensions.h"
+#include <cstring>
 
 namespace MSL
 {
@@ -10,23 +11,45 @@ namespace MSL
 	{
 		class AssemblyEditor
 		{
-			std::istream& file;
+			std::shared_ptr<const void> owner; // keeps assembly memory alive if method bodies are decoded lazily
+			const uint8_t* begin; // assembly is read from memory range [begin, end)
+			const uint8_t* position;
+			const uint8_t* end;
+			const uint8_t* snapshotHeap = nullptr; // part of snapshot after its assembly, which is read by HeapSnapshot
 			std::ostream& error;
 			CallPath* entryPoint = nullptr;
 			bool success = true;
 			bool performCheck = true;
+			bool compactFormat = false; // sizes, hashes and labels are LEB128 integers (see COMPACT_BYTECODE_VERSION)
+			bool hasConstantPool = false; // method dependencies are indices in constantPool (see CONSTANT_POOL_BYTECODE_VERSION)
+			bool hasBodySize = false; // method bodies are prefixed with their size (see BODY_SIZE_BYTECODE_VERSION)
+			bool lazyDecoding = false;
+			AssemblyType* target = nullptr; // assembly which symbol pool owns strings of method dependencies
+			std::vector<const std::string*> constantPool;
 			uint8_t errors = 0;
 
 			OPCODE ReadOPCode();
 			size_t ReadSize();
 			uint8_t ReadModifiers();
 			uint16_t ReadLabel();
+			/*
+			copies string from assembly memory. Strings are not views of it, even if it is mapped file kept alive by AssemblyType::images:
+			names of namespaces, classes, methods and attributes are keys of assembly hash tables, and VM references them and method dependencies
+			as std::string (CallPath, UnknownObject, locals of frame, DLL API), so views would be copied on each use instead of once at load
+			*/
 			std::string ReadString();
 			AssemblyType ReadAssembly();
+			bool ReadConstantPool();
+			AssemblyType ReadSnapshot();
+			NamespaceType ReadSnapshotNamespace();
+			ClassType ReadSnapshotClass();
+			MethodType ReadSnapshotMethod();
 			NamespaceType ReadNamespace();
 			ClassType ReadClass();
 			AttributeType ReadAttribute();
 			MethodType ReadMethod();
+			void ReadMethodBody(MethodType& method);
+			bool CheckLabels(const MethodType& method);
 			void MergeNamespaces(NamespaceType& ns1, NamespaceType& ns2);
 			void RegisterLabelInMethod(MethodType& method, uint16_t label);
 			template<typename T> T GenericRead();
@@ -34,6 +57,8 @@ namespace MSL
 			template<typename T> void ReserveExtraSpace(T& container, size_t additionalSpace);
 			void DisplayError(std::string message);
 			bool ExpectOpcode(OPCODE expected, OPCODE current);
+			bool CheckRemaining(size_t size);
+			bool CheckVersion(uint16_t version);
 		public:
 			enum ERROR
 			{
@@ -41,18 +66,54 @@ namespace MSL
 				DECLARATION_DUBLICATE = 2,
 				INVALID_METHOD_LABEL = 4,
 				ENTRY_POINT_DUBLICATE = 8,
+				UNSUPPORTED_VERSION = 16,
+				INVALID_OPERAND = 32,
+				UNEXPECTED_END = 64,
 			};
 
+			/*
+			reads whole stream to the buffer and decodes assembly from it
+			*/
 			AssemblyEditor(std::istream* binaryFile, std::ostream* errorStream);
+			/*
+			decodes assembly directly from memory, for example from MappedFile. Memory must not be released before MergeAssemblies() returns
+			if owner of memory is provided, it is kept alive by assembly, so method bodies can be decoded lazily
+			*/
+			AssemblyEditor(const uint8_t* data, size_t size, std::ostream* errorStream, std::shared_ptr<const void> owner = nullptr);
+			/*
+			if set, method bodies of assemblies with body sizes are skipped and decoded on first call by DecodeMethodBody()
+			it has effect only if editor owns assembly memory: it was created from stream or with owner of memory
+			*/
+			void SetLazyDecoding(bool lazy);
 			bool MergeAssemblies(AssemblyType& assembly, bool checkErrors, CallPath* callPath);
 			uint8_t GetErrors() const;
+			/*
+			writes loaded assembly as snapshot, which is read by MergeAssemblies() without decoding of method bodies
+			native methods of System namespace added by VM are not written
+			*/
+			static void WriteSnapshot(const AssemblyType& assembly, std::ostream& out);
+			/*
+			returns static state of VM which follows assembly of snapshot (see HeapSnapshot) or nullptr if assembly read was not a snapshot
+			*/
+			const uint8_t* GetSnapshotHeap(size_t& size) const;
+			/*
+			writes loaded assembly as bytecode of latest version, which can be read by MergeAssemblies() as any compiled assembly
+			native methods of System namespace added by VM are not written
+			*/
+			static void WriteAssembly(const AssemblyType& assembly, std::ostream& out);
+			/*
+			decodes body of method skipped by lazy decoding and checks its labels. Returns false and prints error if body is invalid
+			*/
+			static bool DecodeMethodBody(const MethodType& method, std::ostream* errorStream);
 		};
 
 		template<typename T>
 		T AssemblyEditor::GenericRead()
 		{
-			T variable;
-			file.read(reinterpret_cast<char*>(&variable), sizeof(variable));
+			T variable = T();
+			if (!CheckRemaining(sizeof(T))) return variable;
+			std::memcpy(&variable, position, sizeof(T));
+			position += sizeof(T);
 			return variable;
 		}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
@@ -13,7 +14,24 @@ namespace MSL
 		struct AssemblyType
 		{
 			using HashTable = std::unordered_map<std::string, NamespaceType>;
+			using SymbolPool = std::unordered_set<std::string>;
 			HashTable namespaces;
+			/*
+			strings referenced by method dependencies, each is stored once. Pool is node-based, so pointers to symbols are never invalidated
+			*/
+			SymbolPool symbols;
+			/*
+			encoded assemblies which are kept in memory while method bodies are decoded on first call (see AssemblyEditor::SetLazyDecoding)
+			*/
+			std::vector<std::shared_ptr<const void>> images;
+
+			/*
+			returns symbol equal to string provided, adding it to pool if it is not there yet. String read from assembly is moved to pool, so it is copied only once
+			*/
+			const std::string* InternSymbol(std::string symbol)
+			{
+				return &*symbols.insert(std::move(symbol)).first;
+			}
 
 			AssemblyType() = default;
 			AssemblyType(AssemblyType&&) = default;
@@ -1,5 +1,9 @@
 #include "bigInteger.h"
 #include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
 
 #define NOEXCEPT
 
@@ -9,45 +13,6 @@ namespace momo
 	const int32_t big_integer::_base = (int32_t)std::pow(10, big_integer::_base_digits);
 	const big_integer big_integer::inf("inf");
 
-	size_t big_integer::to_buffer(std::stringstream& buffer, const std::string& str)
-	{
-		bool is_signed = false;
-		size_t digit_count = 0;
-		if (str[0] == '-' || str[0] == '+')
-		{
-			is_signed = true;
-		}
-
-		std::string no_err_str;
-		const std::string* str_ptr = &str;
-
-		auto it_err = std::find_if(str.begin() + is_signed, str.end(), [](char c) {return c < '0' || c > '9'; });
-		if (it_err != str.end())
-		{
-			no_err_str = std::string(str.begin(), it_err);
-			str_ptr = &no_err_str;
-		}
-
-		size_t first_digits = (str_ptr->size() - is_signed) % _base_digits;
-		if (first_digits != 0)
-		{
-			auto it_start = str_ptr->begin() + is_signed;
-			auto it_end = it_start + (str_ptr->size() - is_signed) % _base_digits;
-			buffer << std::string(it_start, it_end) << ' ';
-			digit_count++;
-		}
-
-		size_t length = (str_ptr->size() - is_signed) / _base_digits;
-		auto it = str_ptr->cbegin() + first_digits + is_signed;
-		for (size_t i = 0; i < length; i++, digit_count++)
-		{
-			auto it_start = it + i * _base_digits;
-			auto it_end = it + (i + 1) * _base_digits;
-			buffer << std::string(it_start, it_end) << ' ';
-		}
-		return digit_count;
-	}
-
 	void big_integer::normalize()
 	{
 		while ((_digits.size() > 1) && (_digits.back() == 0)) _digits.pop_back();
@@ -61,13 +26,40 @@ namespace momo
 	}
 
 	#undef max // winapi
-	void big_integer::from_buffer(std::stringstream& buffer, size_t size)
+	void big_integer::from_chars(const char* first, const char* last)
 	{
-		size = std::max(size, 1U);
-		_digits.resize(size);
-		for (size_t i = 0; i < size; i++)
+		_negative = false;
+		_inf = false;
+		if (first != last && (*first == '-' || *first == '+'))
 		{
-			buffer >> _digits[size - i - 1];
+			_negative = *first == '-';
+			first++;
+		}
+		if (last - first == 3 && std::equal(first, last, "inf"))
+		{
+			_inf = true;
+			free();
+			return;
+		}
+		// digits are read until first non-digit character
+		last = std::find_if(first, last, [](char c) { return c < '0' || c > '9'; });
+
+		if (last - first <= 2 * _base_digits)
+		{
+			unsigned long long value = 0;
+			std::from_chars(first, last, value);
+			from_integer(value);
+		}
+		else
+		{
+			// base is a power of ten, so every digit is parsed from its own chunk of characters
+			_digits.resize((last - first + _base_digits - 1) / _base_digits);
+			for (size_t i = 0; i < _digits.size(); i++)
+			{
+				const char* end = last - i * _base_digits;
+				const char* begin = end - first > _base_digits ? end - _base_digits : first;
+				std::from_chars(begin, end, _digits[i]);
+			}
 		}
 		normalize();
 	}
@@ -166,6 +158,20 @@ namespace momo
 		}
 	}
 
+	void big_integer::rsub_abs(const big_integer& other)
+	{
+		// |this| = |other| - |this|, |this| <= |other|
+		_digits.resize(other._digits.size(), 0);
+		NumberType borrow = 0;
+		for (size_t i = 0; i < _digits.size(); i++)
+		{
+			NumberType cur = other._digits[i] - _digits[i] - borrow;
+			borrow = cur < 0;
+			_digits[i] = borrow ? cur + _base : cur;
+		}
+		normalize();
+	}
+
 	void big_integer::mult_abs(unsigned long long value)
 	{
 		_digits.push_back(0);
@@ -184,6 +190,463 @@ namespace momo
 		_digits.insert(_digits.begin(), count, 0);
 	}
 
+	void big_integer::shift_right(size_t count)
+	{
+		if (count >= _digits.size())
+		{
+			free();
+			_negative = false;
+			return;
+		}
+		_digits.erase(0, count);
+		normalize();
+	}
+
+	big_integer::NumberType big_integer::div_small(NumberType value)
+	{
+		long long rem = 0;
+		for (size_t i = _digits.size(); i-- > 0;)
+		{
+			long long cur = _digits[i] + rem * _base;
+			_digits[i] = NumberType(cur / value);
+			rem = cur % value;
+		}
+		normalize();
+		return NumberType(rem);
+	}
+
+	big_integer big_integer::from_digits(const NumberType* digits, size_t count)
+	{
+		big_integer res;
+		if (count > 0)
+		{
+			res._digits.assign(digits, count);
+			res.normalize();
+		}
+		return res;
+	}
+
+	big_integer::NumberType big_integer::add_digits(NumberType* a, size_t n, const NumberType* b, size_t m)
+	{
+		// a[0, n) += b[0, m), n >= m
+		NumberType carry = 0;
+		for (size_t i = 0; i < n && (i < m || carry != 0); i++)
+		{
+			NumberType cur = a[i] + carry + (i < m ? b[i] : 0);
+			carry = cur >= _base;
+			a[i] = carry ? cur - _base : cur;
+		}
+		return carry;
+	}
+
+	void big_integer::sub_digits(NumberType* a, size_t n, const NumberType* b, size_t m)
+	{
+		// a[0, n) -= b[0, m), a >= b
+		NumberType borrow = 0;
+		for (size_t i = 0; i < n && (i < m || borrow != 0); i++)
+		{
+			NumberType cur = a[i] - borrow - (i < m ? b[i] : 0);
+			borrow = cur < 0;
+			a[i] = borrow ? cur + _base : cur;
+		}
+	}
+
+	size_t big_integer::karatsuba_threshold = 40;
+	size_t big_integer::toom3_threshold = 150;
+	size_t big_integer::ntt_threshold = 1500;
+	size_t big_integer::newton_division_threshold = 200;
+
+	void big_integer::mult_digits(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out)
+	{
+		// out[0, n + m) = a[0, n) * b[0, m), out must be zero-filled
+		if (n < m)
+		{
+			std::swap(a, b);
+			std::swap(n, m);
+		}
+		while (m > 0 && b[m - 1] == 0) m--;
+		if (m == 0) return;
+
+		if (m < karatsuba_threshold)
+		{
+			mult_schoolbook(a, n, b, m, out);
+		}
+		else if (2 * m <= n)
+		{
+			// unbalanced operands: multiply b by m-sized slices of a
+			NumberVector tmp(2 * m, 0);
+			for (size_t i = 0; i < n; i += m)
+			{
+				size_t len = std::min(m, n - i);
+				std::fill(tmp.begin(), tmp.end(), 0);
+				mult_digits(a + i, len, b, m, &tmp[0]);
+				add_digits(out + i, n + m - i, tmp.data(), len + m);
+			}
+		}
+		else if (m >= ntt_threshold && 3 * (n + m) <= (1 << 23))
+		{
+			mult_ntt(a, n, b, m, out);
+		}
+		else if (m >= toom3_threshold)
+		{
+			mult_toom3(a, n, b, m, out);
+		}
+		else
+		{
+			mult_karatsuba(a, n, b, m, out);
+		}
+	}
+
+	void big_integer::mult_schoolbook(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			if (a[i] == 0) continue;
+			unsigned long long carry = 0;
+			for (size_t j = 0; j < m; j++)
+			{
+				unsigned long long cur = out[i + j] + (unsigned long long)a[i] * b[j] + carry;
+				carry = cur / _base;
+				out[i + j] = NumberType(cur - carry * _base);
+			}
+			out[i + m] = NumberType(carry);
+		}
+	}
+
+	void big_integer::mult_karatsuba(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out)
+	{
+		// n >= m > n / 2, a = a1 * B^h + a0, b = b1 * B^h + b0
+		size_t h = n / 2;
+		mult_digits(a, h, b, h, out);
+		mult_digits(a + h, n - h, b + h, m - h, out + 2 * h);
+
+		// (a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1 = a0 * b1 + a1 * b0
+		NumberVector sa(n - h + 1, 0), sb(std::max(m - h, h) + 1, 0);
+		std::copy(a + h, a + n, sa.begin());
+		std::copy(b + h, b + m, sb.begin());
+		add_digits(&sa[0], sa.size(), a, h);
+		add_digits(&sb[0], sb.size(), b, h);
+
+		NumberVector mid(sa.size() + sb.size(), 0);
+		mult_digits(sa.data(), sa.size(), sb.data(), sb.size(), &mid[0]);
+		sub_digits(&mid[0], mid.size(), out, 2 * h);
+		sub_digits(&mid[0], mid.size(), out + 2 * h, n + m - 2 * h);
+		add_digits(out + h, n + m - h, mid.data(), std::min(mid.size(), n + m - h));
+	}
+
+	void big_integer::mult_toom3(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out)
+	{
+		// n >= m > n / 2, operands are split into three k-digit parts
+		size_t k = (n + 2) / 3;
+		auto part = [k](const NumberType* x, size_t size, size_t i)
+		{
+			size_t first = std::min(size, i * k), last = std::min(size, (i + 1) * k);
+			return from_digits(x + first, last - first);
+		};
+		big_integer a0 = part(a, n, 0), a1 = part(a, n, 1), a2 = part(a, n, 2);
+		big_integer b0 = part(b, m, 0), b1 = part(b, m, 1), b2 = part(b, m, 2);
+
+		// evaluation in 0, 1, -1, -2, inf
+		big_integer pa = a0 + a2, pb = b0 + b2;
+		big_integer a_p1 = pa + a1, a_m1 = pa - a1, a_m2 = (a_m1 + a2) * 2 - a0;
+		big_integer b_p1 = pb + b1, b_m1 = pb - b1, b_m2 = (b_m1 + b2) * 2 - b0;
+
+		big_integer r0 = a0 * b0, r1 = a_p1 * b_p1, rm1 = a_m1 * b_m1, rm2 = a_m2 * b_m2, r4 = a2 * b2;
+
+		// interpolation (Bodrato sequence), all divisions are exact
+		big_integer r3 = rm2 - r1;
+		r3.div_small(3);
+		r1 -= rm1;
+		r1.div_small(2);
+		big_integer r2 = rm1 - r0;
+		r3 = r2 - r3;
+		r3.div_small(2);
+		r3 += r4 * 2;
+		r2 += r1;
+		r2 -= r4;
+		r1 -= r3;
+
+		const big_integer* coefs[] = { &r0, &r1, &r2, &r3, &r4 };
+		for (size_t i = 0; i < 5; i++)
+		{
+			const big_integer& coef = *coefs[i];
+			if (coef.is_zero()) continue;
+			add_digits(out + i * k, n + m - i * k, coef._digits.data(), coef._digits.size());
+		}
+	}
+
+	static uint32_t pow_mod(unsigned long long value, unsigned long long power, uint32_t mod)
+	{
+		unsigned long long res = 1;
+		value %= mod;
+		while (power > 0)
+		{
+			if (power & 1) res = res * value % mod;
+			value = value * value % mod;
+			power >>= 1;
+		}
+		return uint32_t(res);
+	}
+
+	static void ntt(std::vector<uint32_t>& a, bool invert, uint32_t mod)
+	{
+		const uint32_t root = 3; // primitive root of both NTT modules
+		size_t n = a.size();
+		for (size_t i = 1, j = 0; i < n; i++)
+		{
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1) j ^= bit;
+			j ^= bit;
+			if (i < j) std::swap(a[i], a[j]);
+		}
+		std::vector<uint32_t> roots(n / 2);
+		for (size_t len = 2; len <= n; len <<= 1)
+		{
+			unsigned long long w = pow_mod(root, (mod - 1) / len, mod);
+			if (invert) w = pow_mod(w, mod - 2, mod);
+			roots[0] = 1;
+			for (size_t j = 1; j < len / 2; j++) roots[j] = uint32_t(roots[j - 1] * w % mod);
+
+			for (size_t i = 0; i < n; i += len)
+			{
+				for (size_t j = 0; j < len / 2; j++)
+				{
+					uint32_t u = a[i + j];
+					uint32_t v = uint32_t((unsigned long long)a[i + j + len / 2] * roots[j] % mod);
+					a[i + j] = u + v < mod ? u + v : u + v - mod;
+					a[i + j + len / 2] = u >= v ? u - v : u + mod - v;
+				}
+			}
+		}
+		if (invert)
+		{
+			unsigned long long inv = pow_mod(n, mod - 2, mod);
+			for (uint32_t& x : a) x = uint32_t(x * inv % mod);
+		}
+	}
+
+	void big_integer::mult_ntt(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out)
+	{
+		// digits are split into base 1000 parts, convolution is computed modulo two primes
+		// and restored by CRT: coefficients are less than 2^23 * 999^2 < mod1 * mod2
+		const uint32_t mod1 = 998244353, mod2 = 469762049;
+		size_t len = 3 * (n + m), size = 1;
+		while (size < len) size <<= 1;
+
+		auto split = [size](const NumberType* x, size_t count)
+		{
+			std::vector<uint32_t> res(size, 0);
+			for (size_t i = 0; i < count; i++)
+			{
+				res[3 * i] = x[i] % 1000;
+				res[3 * i + 1] = x[i] / 1000 % 1000;
+				res[3 * i + 2] = x[i] / 1000000;
+			}
+			return res;
+		};
+		std::vector<uint32_t> fa1 = split(a, n), fb1 = split(b, m);
+		std::vector<uint32_t> fa2 = fa1, fb2 = fb1;
+
+		ntt(fa1, false, mod1);
+		ntt(fb1, false, mod1);
+		for (size_t i = 0; i < size; i++) fa1[i] = uint32_t((unsigned long long)fa1[i] * fb1[i] % mod1);
+		ntt(fa1, true, mod1);
+
+		ntt(fa2, false, mod2);
+		ntt(fb2, false, mod2);
+		for (size_t i = 0; i < size; i++) fa2[i] = uint32_t((unsigned long long)fa2[i] * fb2[i] % mod2);
+		ntt(fa2, true, mod2);
+
+		const unsigned long long inv = pow_mod(mod1, mod2 - 2, mod2);
+		unsigned long long carry = 0;
+		for (size_t i = 0; i < len; i += 3)
+		{
+			NumberType digit = 0, scale = 1;
+			for (size_t j = i; j < i + 3; j++)
+			{
+				unsigned long long r1 = fa1[j], r2 = fa2[j];
+				unsigned long long t = (r2 + mod2 - r1 % mod2) % mod2 * inv % mod2;
+				unsigned long long value = r1 + t * mod1 + carry;
+				carry = value / 1000;
+				digit += NumberType(value - carry * 1000) * scale;
+				scale *= 1000;
+			}
+			out[i / 3] = digit;
+		}
+	}
+
+	void big_integer::divmod_abs(const big_integer& a, const big_integer& b, big_integer& quotient, big_integer& remainder)
+	{
+		// |a| = quotient * |b| + remainder, b != 0
+		if (a.compare_abs(b) < 0)
+		{
+			quotient = 0;
+			remainder = abs(a);
+			return;
+		}
+		size_t n = a._digits.size(), m = b._digits.size();
+		if (m == 1)
+		{
+			quotient = abs(a);
+			remainder = quotient.div_small(b._digits[0]);
+			return;
+		}
+		if (m < newton_division_threshold || n - m < newton_division_threshold)
+		{
+			divmod_knuth(a, b, quotient, remainder);
+			return;
+		}
+
+		// a is divided by blocks of m digits using precomputed B^(2m) / b
+		big_integer divisor = abs(b);
+		big_integer inverse = reciprocal(divisor);
+		size_t blocks = (n + m - 1) / m;
+		quotient._digits.assign(blocks * m, 0);
+		quotient._negative = quotient._inf = false;
+		remainder = 0;
+		for (size_t i = blocks; i-- > 0;)
+		{
+			big_integer current;
+			current._digits.assign(a._digits.begin() + i * m, a._digits.begin() + std::min(n, (i + 1) * m));
+			if (!remainder.is_zero())
+			{
+				current._digits.resize(m, 0);
+				current._digits += remainder._digits;
+			}
+			current.normalize();
+
+			big_integer q = current * inverse;
+			q.shift_right(2 * m);
+			remainder = current - q * divisor;
+			while (remainder._negative)
+			{
+				q -= 1;
+				remainder += divisor;
+			}
+			while (remainder.compare_abs(divisor) >= 0)
+			{
+				q += 1;
+				remainder -= divisor;
+			}
+			if (!q.is_zero()) std::copy(q._digits.begin(), q._digits.end(), quotient._digits.begin() + i * m);
+		}
+		quotient.normalize();
+	}
+
+	void big_integer::divmod_knuth(const big_integer& a, const big_integer& b, big_integer& quotient, big_integer& remainder)
+	{
+		// Knuth's algorithm D, |a| >= |b| and b has at least two digits
+		size_t n = b._digits.size(), m = a._digits.size() - n;
+		NumberType d = NumberType(_base / (b._digits.back() + 1LL));
+		big_integer u = abs(a), v = abs(b);
+		u.mult_abs(d);
+		v.mult_abs(d);
+		u._digits.resize(n + m + 1, 0);
+
+		quotient._digits.assign(m + 1, 0);
+		quotient._negative = quotient._inf = false;
+		const unsigned long long base = _base;
+		const unsigned long long top = v._digits[n - 1], next = v._digits[n - 2];
+		for (size_t j = m + 1; j-- > 0;)
+		{
+			unsigned long long num = u._digits[j + n] * base + u._digits[j + n - 1];
+			unsigned long long qhat = num / top, rhat = num % top;
+			while (qhat >= base || qhat * next > rhat * base + u._digits[j + n - 2])
+			{
+				qhat--;
+				rhat += top;
+				if (rhat >= base) break;
+			}
+
+			// u[j, j + n] -= qhat * v
+			unsigned long long carry = 0;
+			long long borrow = 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				unsigned long long p = qhat * v._digits[i] + carry;
+				carry = p / base;
+				long long t = (long long)u._digits[i + j] - (long long)(p - carry * base) - borrow;
+				borrow = t < 0;
+				u._digits[i + j] = NumberType(borrow ? t + _base : t);
+			}
+			long long t = (long long)u._digits[j + n] - (long long)carry - borrow;
+			if (t < 0)
+			{
+				// qhat was too large by one, add v back
+				qhat--;
+				NumberType c = 0;
+				for (size_t i = 0; i < n; i++)
+				{
+					NumberType s = u._digits[i + j] + v._digits[i] + c;
+					c = s >= _base;
+					u._digits[i + j] = c ? s - _base : s;
+				}
+				t += c;
+			}
+			u._digits[j + n] = NumberType(t);
+			quotient._digits[j] = NumberType(qhat);
+		}
+		quotient.normalize();
+		u._digits.resize(n);
+		u.normalize();
+		u.div_small(d);
+		remainder = u;
+	}
+
+	big_integer big_integer::reciprocal(const big_integer& b)
+	{
+		// floor(B^(2m) / b), where m is digit count of b
+		size_t m = b._digits.size();
+		big_integer power = 1;
+		power.mult_base(2 * m);
+		if (m == 1)
+		{
+			power.div_small(b._digits[0]);
+			return power;
+		}
+		if (m <= 8 || m < newton_division_threshold)
+		{
+			big_integer q, r;
+			divmod_knuth(power, b, q, r);
+			return q;
+		}
+
+		// approximation from the high digits of b, refined by one Newton iteration
+		size_t h = m / 2 + 2;
+		big_integer x = reciprocal(from_digits(b._digits.data() + m - h, h));
+		x.mult_base(m - h);
+		big_integer correction = x * (power - b * x);
+		correction.shift_right(2 * m);
+		x += correction;
+
+		big_integer remainder = power - b * x;
+		while (remainder._negative)
+		{
+			x -= 1;
+			remainder += b;
+		}
+		while (remainder.compare_abs(b) >= 0)
+		{
+			x += 1;
+			remainder -= b;
+		}
+		return x;
+	}
+
+	big_integer big_integer::range_product(unsigned long long first, unsigned long long last)
+	{
+		// product tree keeps operands balanced for fast multiplication
+		if (first > last) return 1;
+		if (last - first < 16)
+		{
+			big_integer res = 1;
+			for (unsigned long long i = first; i <= last; i++) res.mult_abs(i);
+			return res;
+		}
+		unsigned long long middle = first + (last - first) / 2;
+		return range_product(first, middle) * range_product(middle + 1, last);
+	}
+
 	int big_integer::check_inf(const big_integer& other) const
 	{
 		return _inf + 2 * other._inf;
@@ -225,42 +688,26 @@ namespace momo
 	}
 
 	big_integer::big_integer(const std::string& value)
-		: _negative(value[0] == '-'), _inf(false)
-	{
-		if (value == "inf" || value == "-inf")
-		{
-			_inf = true;
-		}
-		else
-		{
-			std::stringstream buffer;
-			size_t digits = to_buffer(buffer, value);
-			from_buffer(buffer, digits);
-		}
-	}
+		: big_integer(value.data(), value.data() + value.size()) { }
 
 	big_integer::big_integer(const char* value)
-		: big_integer(std::string(value)) { }
+		: big_integer(value, value + std::strlen(value)) { }
+
+	big_integer::big_integer(const char* first, const char* last)
+		: _negative(false), _inf(false)
+	{
+		from_chars(first, last);
+	}
 
 	big_integer& big_integer::operator=(const std::string& value)
 	{
-		_negative = value[0] == '-';
-		if (value == "inf" || value == "-inf")
-		{
-			_inf = true;
-		}
-		else
-		{
-			std::stringstream buffer;
-			size_t digits = to_buffer(buffer, value);
-			from_buffer(buffer, digits);
-		}
+		from_chars(value.data(), value.data() + value.size());
 		return *this;
 	}
 
 	big_integer& big_integer::operator=(const char* value)
 	{
-		*this = std::string(value);
+		from_chars(value, value + std::strlen(value));
 		return *this;
 	}
 
@@ -274,36 +721,82 @@ namespace momo
 		{
 			sub_abs(other);
 		}
-		else
+		else if (_inf || other._inf)
 		{
 			big_integer res = other;
 			res.sub_abs(*this);
 			*this = res;
 		}
+		else
+		{
+			_negative = other._negative;
+			rsub_abs(other);
+		}
 		return *this;
 	}
 
 	big_integer& big_integer::operator-=(const big_integer& other)
 	{
-		*this += (-other);
+		if (_inf || other._inf)
+		{
+			*this += (-other);
+		}
+		else if (_negative != other._negative)
+		{
+			sum_abs(other);
+		}
+		else if (compare_abs(other) == 1)
+		{
+			sub_abs(other);
+		}
+		else
+		{
+			_negative = !other._negative;
+			rsub_abs(other);
+		}
 		return *this;
 	}
 
 	big_integer& big_integer::operator*=(const big_integer& other)
 	{
-		*this = *this * other;
+		if (_inf || other._inf || other._digits.size() > 1)
+		{
+			*this = *this * other;
+			return *this;
+		}
+		// single digit multiplier is applied to existing digits
+		_negative = _negative != other._negative;
+		mult_abs(other._digits[0]);
 		return *this;
 	}
 
 	big_integer& big_integer::operator/=(const big_integer& other)
 	{
-		*this = *this / other;
+		if (_inf || other._inf || other._digits.size() > 1 || other.is_zero())
+		{
+			*this = *this / other;
+			return *this;
+		}
+		_negative = _negative != other._negative;
+		div_small(other._digits[0]);
 		return *this;
 	}
 
 	big_integer & big_integer::operator%=(const big_integer & other)
 	{
-		*this = *this % other;
+		if (_inf || other._inf || other._digits.size() > 1 || other.is_zero())
+		{
+			*this = *this % other;
+			return *this;
+		}
+		long long rem = 0;
+		for (size_t i = _digits.size(); i-- > 0;)
+		{
+			rem = (_digits[i] + rem * _base) % other._digits[0];
+		}
+		_negative = _negative != other._negative;
+		from_integer(rem);
+		normalize();
 		return *this;
 	}
 
@@ -380,6 +873,12 @@ namespace momo
 
 	std::string big_integer::to_string(std::string sep) const
 	{
+		if (sep.empty())
+		{
+			std::string res(chars_size(), '\0');
+			to_chars(&res[0], &res[0] + res.size());
+			return res;
+		}
 		std::stringstream res;
 		if (_negative) res << '-';
 		if (_inf) res << "inf";
@@ -398,6 +897,74 @@ namespace momo
 		return res.str();
 	}
 
+	static char* write_digits(char* out, int32_t value, int32_t count)
+	{
+		// writes exactly count digits of value, including leading zeros
+		for (int32_t i = count - 1; i >= 0; i--)
+		{
+			out[i] = char('0' + value % 10);
+			value /= 10;
+		}
+		return out + count;
+	}
+
+	size_t big_integer::chars_size() const
+	{
+		if (_inf) return _negative + 3;
+		size_t top_digits = 1;
+		for (NumberType value = _digits.back(); value >= 10; value /= 10) top_digits++;
+		return _negative + top_digits + (_digits.size() - 1) * _base_digits;
+	}
+
+	char* big_integer::to_chars(char* first, char* last) const
+	{
+		// returns end of written characters or nullptr if buffer is less than chars_size()
+		if (last - first < (std::ptrdiff_t)chars_size()) return nullptr;
+		if (_negative) *first++ = '-';
+		if (_inf) return std::copy_n("inf", 3, first);
+
+		first = std::to_chars(first, last, _digits.back()).ptr;
+		for (size_t i = _digits.size() - 1; i-- > 0;)
+		{
+			first = write_digits(first, _digits[i], _base_digits);
+		}
+		return first;
+	}
+
+	void big_integer::append_to(std::string& str) const
+	{
+		size_t offset = str.size();
+		str.resize(offset + chars_size());
+		to_chars(&str[offset], &str[0] + str.size());
+	}
+
+	void big_integer::write(std::ostream& out) const
+	{
+		// huge values are written by blocks without building the whole string
+		char buffer[64 * 9];
+		char* const end = buffer + sizeof(buffer);
+		char* it = buffer;
+		if (_negative) *it++ = '-';
+		if (_inf)
+		{
+			it = std::copy_n("inf", 3, it);
+		}
+		else
+		{
+			it = std::to_chars(it, end, _digits.back()).ptr;
+			for (size_t i = _digits.size() - 1; i-- > 0;)
+			{
+				if (end - it < _base_digits)
+				{
+					out.write(buffer, it - buffer);
+					it = buffer;
+				}
+				it = write_digits(it, _digits[i], _base_digits);
+			}
+		}
+		out.write(buffer, it - buffer);
+	}
+
 	double big_integer::to_double() const
 	{
 		double res = 0.0;
@@ -411,6 +978,17 @@ namespace momo
 		return res;
 	}
 
+	long long big_integer::to_int64() const
+	{
+		long long res = 0;
+		for (auto it = _digits.rbegin(); it != _digits.rend(); it++)
+		{
+			res = res * _base + *it;
+		}
+		if (_negative) res *= -1;
+		return res;
+	}
+
 	size_t big_integer::size_bytes() const
 	{
 		return sizeof(BigInteger) + _digits.capacity() * sizeof(int32_t);
@@ -418,7 +996,7 @@ namespace momo
 
 	std::ostream& operator<<(std::ostream& out, const big_integer& num)
 	{
-		out << num.to_string();
+		num.write(out);
 		return out;
 	}
 
@@ -441,15 +1019,36 @@ namespace momo
 
 	big_integer pow(const big_integer& num, const big_integer& power)
 	{
-		if (power == 0) return big_integer(1);
-		if (power % 2 == 0)
+		if (power._negative)
 		{
-			return pow(num * num, power / 2);
+			// integer result of 1 / num^|power|
+			if (num.is_zero()) return big_integer::inf;
+			if (abs(num) != 1) return big_integer(0);
+			return (num._negative && power._digits[0] % 2 == 1) ? big_integer(-1) : big_integer(1);
 		}
-		else
+		if (power <= big_integer(std::numeric_limits<long long>::max()))
 		{
-			return num * pow(num, power - 1);
+			return pow(num, (unsigned long long)power.to_int64());
 		}
+		if (num.is_zero() || abs(num) == 1)
+		{
+			return pow(num, (unsigned long long)(power._digits[0] % 2));
+		}
+		big_integer res = big_integer::inf;
+		res._negative = num._negative && power._digits[0] % 2 == 1;
+		return res;
+	}
+
+	big_integer pow(const big_integer& num, unsigned long long power)
+	{
+		big_integer res = 1, base = num;
+		while (power > 0)
+		{
+			if (power & 1) res *= base;
+			power >>= 1;
+			if (power > 0) base *= base;
+		}
+		return res;
 	}
 
 	big_integer pow(const big_integer& num, size_t power, const big_integer& mod)
@@ -467,33 +1066,30 @@ namespace momo
 
 	big_integer fact(big_integer num)
 	{
-		big_integer res = 1;
-		while (num > 0)
-		{
-			res *= num;
-			num -= 1;
-		}
-		return res;
+		if (num <= 1) return 1;
+		return big_integer::range_product(2, (unsigned long long)num.to_int64());
 	}
 
 	big_integer sqrt(const big_integer& num)
 	{
-		big_integer l, r = num;
-		big_integer res;
-		while (l <= r)
+		if (num._negative || num.is_zero()) return big_integer();
+
+		// Newton's method starting from an approximation which is not less than the root
+		size_t shift = (num._digits.size() - 1) / 2;
+		double top = 0.0;
+		for (size_t i = num._digits.size(); i-- > 2 * shift;)
 		{
-			big_integer m = (l + r) / 2;
-			if (m * m <= num)
-			{
-				res = m;
-				l = m + 1;
-			}
-			else
-			{
-				r = m - 1;
-			}
+			top = top * big_integer::_base + num._digits[i];
+		}
+		big_integer res = (unsigned long long)std::sqrt(top) + 2;
+		res.mult_base(shift);
+		while (true)
+		{
+			big_integer next = res + num / res;
+			next.div_small(2);
+			if (next >= res) return res;
+			res = next;
 		}
-		return res;
 	}
 
 	big_integer big_integer::operator+(const big_integer& other) const
@@ -528,27 +1124,10 @@ namespace momo
 			res._negative = _negative != other._negative;
 			return res;
 		}
-		else if (compare_abs(other) == -1)
-		{
-			for (int i = 0; i < (int)_digits.size(); i++)
-			{
-				big_integer tmp(other);
-				tmp.mult_abs(_digits[i]);
-				tmp.mult_base(i);
-				res += tmp;
-			}
-		}
-		else
-		{
-			for (int i = 0; i < (int)other._digits.size(); i++)
-			{
-				big_integer tmp(*this);
-				tmp.mult_abs(other._digits[i]);
-				tmp.mult_base(i);
-				res += tmp;
-			}
-		}
-		res._negative = _negative != other._negative;
+		res._digits.assign(_digits.size() + other._digits.size(), 0);
+		mult_digits(_digits.data(), _digits.size(), other._digits.data(), other._digits.size(), &res._digits[0]);
+		res.normalize();
+		res._negative = _negative != other._negative && !res.is_zero();
 		return res;
 	}
 	big_integer big_integer::operator/(const big_integer& other) const
@@ -599,37 +1178,10 @@ namespace momo
 				return res;
 			}
 		}
-		big_integer a = abs(*this), b = abs(other);
-		big_integer res, current;
-
-		res._digits.resize(_digits.size());
-		for (int i = (int)a._digits.size() - 1; i >= 0; i--)
-		{
-			current.mult_base(1);
-			current._digits[0] = a._digits[i];
-			current.normalize();
-			int x = 0;
-			int l = 0, r = _base;
-			while (l <= r)
-			{
-				int m = (l + r) >> 1;
-				big_integer cur = b * m;
-				if (cur <= current)
-				{
-					x = m;
-					l = m + 1;
-				}
-				else
-				{
-					r = m - 1;
-				}
-			}
-			res._digits[i] = x;
-			current = current - b * x;
-		}
-		res.normalize();
-		res._negative = res_sign;
-		return res;
+		big_integer quotient, remainder;
+		divmod_abs(*this, other, quotient, remainder);
+		quotient._negative = res_sign && !quotient.is_zero();
+		return quotient;
 	}
 
 	big_integer big_integer::operator%(const big_integer& other) const
@@ -677,37 +1229,10 @@ namespace momo
 				return big_integer(0);
 			}
 		}
-		big_integer a = abs(*this), b = abs(other);
-		big_integer res, current;
-
-		res._digits.resize(_digits.size());
-		for (int i = (int)a._digits.size() - 1; i >= 0; i--)
-		{
-			current.mult_base(1);
-			current._digits[0] = a._digits[i];
-			current.normalize();
-			int x = 0;
-			int l = 0, r = _base;
-			while (l <= r)
-			{
-				int m = (l + r) >> 1;
-				big_integer cur = b * m;
-				if (cur <= current)
-				{
-					x = m;
-					l = m + 1;
-				}
-				else
-				{
-					r = m - 1;
-				}
-			}
-			res._digits[i] = x;
-			current = current - b * x;
-		}
-		current.normalize();
-		current._negative = res_sign;
-		return current;
+		big_integer quotient, remainder;
+		divmod_abs(*this, other, quotient, remainder);
+		remainder._negative = res_sign && !remainder.is_zero();
+		return remainder;
 	}
 	#undef NOEXCEPT
 }
\ No newline at end of file
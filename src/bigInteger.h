@@ -17,19 +17,40 @@ namespace momo
 		bool _negative;
 		bool _inf;
 
-		static size_t to_buffer(std::stringstream& buffer, const std::string& str);
 		void normalize();
 		void free();
-		void from_buffer(std::stringstream& buffer, size_t size);
+		void from_chars(const char* first, const char* last);
 		void from_integer(unsigned long long value);
 		int compare_abs(const big_integer& other) const;
 		void sum_abs(const big_integer& other);
 		void sub_abs(const big_integer& other);
+		void rsub_abs(const big_integer& other);
 		void mult_abs(unsigned long long value);
 		void mult_base(size_t count);
+		void shift_right(size_t count);
+		NumberType div_small(NumberType value);
 		int check_inf(const big_integer& other) const;
+
+		static big_integer from_digits(const NumberType* digits, size_t count);
+		static NumberType add_digits(NumberType* a, size_t n, const NumberType* b, size_t m);
+		static void sub_digits(NumberType* a, size_t n, const NumberType* b, size_t m);
+		static void mult_digits(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out);
+		static void mult_schoolbook(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out);
+		static void mult_karatsuba(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out);
+		static void mult_toom3(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out);
+		static void mult_ntt(const NumberType* a, size_t n, const NumberType* b, size_t m, NumberType* out);
+		static void divmod_abs(const big_integer& a, const big_integer& b, big_integer& quotient, big_integer& remainder);
+		static void divmod_knuth(const big_integer& a, const big_integer& b, big_integer& quotient, big_integer& remainder);
+		static big_integer reciprocal(const big_integer& b);
+		static big_integer range_product(unsigned long long first, unsigned long long last);
 	public:
 		static const big_integer inf;
+		// multiplication / division algorithm thresholds (in base 10^9 digits of smaller operand)
+		static size_t karatsuba_threshold;
+		static size_t toom3_threshold;
+		static size_t ntt_threshold;
+		static size_t newton_division_threshold;
+
 		bool is_inf() const;
 		bool is_zero() const;
 
@@ -39,6 +60,7 @@ namespace momo
 		big_integer(int value);
 		big_integer(const std::string& value);
 		big_integer(const char* value);
+		big_integer(const char* first, const char* last);
 		big_integer(const big_integer&) = default;
 		big_integer(big_integer&&) = default;
 
@@ -73,7 +95,12 @@ namespace momo
 		big_integer operator+() const;
 
 		std::string to_string(std::string sep = "") const;
+		size_t chars_size() const;
+		char* to_chars(char* first, char* last) const;
+		void append_to(std::string& str) const;
+		void write(std::ostream& out) const;
 		double to_double() const;
+		long long to_int64() const;
 		size_t size_bytes() const;
 
 		friend std::ostream& operator<<(std::ostream& out, const big_integer& num);
@@ -81,12 +108,14 @@ namespace momo
 		friend const big_integer& min(const big_integer& num1, const big_integer& num2);
 		friend big_integer abs(big_integer num);
 		friend big_integer pow(const big_integer& num, const big_integer& power);
+		friend big_integer pow(const big_integer& num, unsigned long long power);
 		friend big_integer pow(const big_integer& num, size_t power, const big_integer& mod);
 		friend big_integer fact(big_integer num);
 		friend big_integer sqrt(const big_integer& num);
 	};
 
 	big_integer pow(const big_integer& num, const big_integer& power);
+	big_integer pow(const big_integer& num, unsigned long long power);
 
 	typedef big_integer BigInteger;
 
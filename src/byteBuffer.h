@@ -0,0 +1,97 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace MSL
+{
+	namespace utils
+	{
+		/*
+		contiguous growable array of bytes, which is used by compiler to write bytecode of methods and assemblies
+		values are written in binary representation, as they are stored in memory
+		*/
+		class ByteBuffer
+		{
+			/*
+			bytes written to the buffer
+			*/
+			std::string bytes;
+		public:
+			/*
+			writes binary representation of value to the end of buffer
+			*/
+			template<typename T>
+			void Write(T value);
+			/*
+			writes size bytes from data to the end of buffer
+			*/
+			void Write(const void* data, size_t size);
+			/*
+			writes single byte to the end of buffer
+			*/
+			void Put(uint8_t byte);
+			/*
+			reserves memory for at least size bytes, so buffer is not reallocated until it grows over it
+			*/
+			void Reserve(size_t size);
+			/*
+			removes all bytes from buffer, keeping memory allocated
+			*/
+			void Clear();
+			/*
+			returns pointer to the first byte of buffer
+			*/
+			const uint8_t* GetData() const;
+			/*
+			returns amount of bytes written to the buffer
+			*/
+			size_t GetSize() const;
+			/*
+			returns constant reference to buffer contents as string
+			*/
+			const std::string& GetString() const;
+		};
+
+		template<typename T>
+		inline void ByteBuffer::Write(T value)
+		{
+			bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		inline void ByteBuffer::Write(const void* data, size_t size)
+		{
+			bytes.append(static_cast<const char*>(data), size);
+		}
+
+		inline void ByteBuffer::Put(uint8_t byte)
+		{
+			bytes.push_back(static_cast<char>(byte));
+		}
+
+		inline void ByteBuffer::Reserve(size_t size)
+		{
+			bytes.reserve(size);
+		}
+
+		inline void ByteBuffer::Clear()
+		{
+			bytes.clear();
+		}
+
+		inline const uint8_t* ByteBuffer::GetData() const
+		{
+			return reinterpret_cast<const uint8_t*>(bytes.data());
+		}
+
+		inline size_t ByteBuffer::GetSize() const
+		{
+			return bytes.size();
+		}
+
+		inline const std::string& ByteBuffer::GetString() const
+		{
+			return bytes;
+		}
+	}
+}
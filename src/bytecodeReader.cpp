@@ -36,13 +36,23 @@ namespace MSL
 			using namespace VM;
 			OPCODE op;
 			size_t stringSize, dependencyCounter = 0;
+			if (file.peek() == BYTECODE_MAGIC[0]) // assembly in compact format starts with header
+			{
+				char magic[sizeof(BYTECODE_MAGIC)];
+				file.read(magic, sizeof(magic));
+				uint16_t version = GenericRead<uint16_t>();
+				compactFormat = version >= COMPACT_BYTECODE_VERSION;
+				hasConstantPool = version >= CONSTANT_POOL_BYTECODE_VERSION;
+				hasBodySize = version >= BODY_SIZE_BYTECODE_VERSION;
+				out << "BYTECODE_MAGIC " << version << '\n';
+			}
 			while (!file.eof())
 			{
 				op = ReadOPCode();
 #define OPCODE_CASE(OP) case OP: out << STRING(OP) << ' ';
 #define READ_SIZE_OPCODE(OP) OPCODE_CASE(OP) out << ReadSize();
 #define READ_HASH_CASE(OP) OPCODE_CASE(OP) out << '#' << ReadSize();
-#define READ_LABEL_CASE(OP) OPCODE_CASE(OP) out << 'L' << GenericRead<uint16_t>();
+#define READ_LABEL_CASE(OP) OPCODE_CASE(OP) out << 'L' << ReadLabel();
 #define BINARY(object, size) std::bitset<8 * size>(object)
 
 				switch (op)
@@ -63,9 +73,13 @@ namespace MSL
 						break;
 					OPCODE_CASE(ASSEMBLY_BEGIN_DECL)
 						break;
+					OPCODE_CASE(ASSEMBLY_VERSION_DECL)
+						out << GenericRead<uint16_t>();
+						break;
 					OPCODE_CASE(ASSEMBLY_END_DECL)
 						return; // no more read after this opcode
 					OPCODE_CASE(METHOD_BODY_BEGIN_DECL)
+						if (hasBodySize) out << ReadSize();
 						dependencyCounter = 0;
 					break;
 					OPCODE_CASE(METHOD_BODY_END_DECL)
@@ -118,6 +132,9 @@ namespace MSL
                     READ_HASH_CASE(CALL_FUNCTION)
                         out << ' ' << (size_t)GenericRead<uint8_t>();
                         break;
+                    READ_HASH_CASE(TAIL_CALL)
+                        out << ' ' << (size_t)GenericRead<uint8_t>();
+                        break;
                     READ_HASH_CASE(GET_MEMBER)
                         break;
 					READ_HASH_CASE(PUSH_STRING)
@@ -132,6 +149,10 @@ namespace MSL
 						break;
 					READ_HASH_CASE(ALLOC_CONST_VAR)
 						break;
+					READ_HASH_CASE(LOAD_LOCAL)
+						break;
+					READ_HASH_CASE(STORE_LOCAL)
+						break;
 					READ_LABEL_CASE(SET_LABEL)
 						break;
 					READ_LABEL_CASE(PUSH_CATCH)
@@ -140,8 +161,52 @@ namespace MSL
 						break;
 					READ_LABEL_CASE(JUMP_IF_FALSE)
 						break;
+					READ_LABEL_CASE(JUMP_IF_FALSE_KEEP)
+						break;
+					READ_LABEL_CASE(JUMP_IF_TRUE_KEEP)
+						break;
+					OPCODE_CASE(SUM_INT)
+						break;
+					OPCODE_CASE(SUB_INT)
+						break;
+					OPCODE_CASE(MULT_INT)
+						break;
+					OPCODE_CASE(CMP_EQ_INT)
+						break;
+					OPCODE_CASE(CMP_NEQ_INT)
+						break;
+					OPCODE_CASE(CMP_L_INT)
+						break;
+					OPCODE_CASE(CMP_G_INT)
+						break;
+					OPCODE_CASE(CMP_LE_INT)
+						break;
+					OPCODE_CASE(CMP_GE_INT)
+						break;
+					OPCODE_CASE(SUM_FLOAT)
+						break;
+					OPCODE_CASE(SUB_FLOAT)
+						break;
+					OPCODE_CASE(MULT_FLOAT)
+						break;
+					OPCODE_CASE(DIV_FLOAT)
+						break;
+					OPCODE_CASE(CMP_L_FLOAT)
+						break;
+					OPCODE_CASE(CMP_G_FLOAT)
+						break;
+					OPCODE_CASE(CMP_LE_FLOAT)
+						break;
+					OPCODE_CASE(CMP_GE_FLOAT)
+						break;
 					READ_LABEL_CASE(JUMP)
 						break;
+					READ_HASH_CASE(ITER_INIT)
+						out << " #" << ReadSize();
+						break;
+					READ_HASH_CASE(ITER_NEXT)
+						out << " #" << ReadSize() << " #" << ReadSize() << " L" << ReadLabel();
+						break;
 					READ_SIZE_OPCODE(NAMESPACE_POOL_DECL_SIZE)
 						dependencyCounter = 0;
 					break;
@@ -159,8 +224,20 @@ namespace MSL
 					READ_SIZE_OPCODE(METHOD_PARAMS_DECL_SIZE)
 						dependencyCounter = 0;
 					break;
-					READ_SIZE_OPCODE(DEPENDENCY_POOL_DECL_SIZE)
+					READ_SIZE_OPCODE(CONSTANT_POOL_DECL_SIZE)
+						dependencyCounter = 0;
+					break;
+					OPCODE_CASE(DEPENDENCY_POOL_DECL_SIZE)
+					{
+						size_t dependencyPoolSize = ReadSize();
+						out << dependencyPoolSize;
+						if (hasConstantPool)
+						{
+							for (size_t i = 0; i < dependencyPoolSize; i++)
+								out << " #" << ReadSize();
+						}
 						dependencyCounter = 0;
+					}
 					break;
 				case STRING_DECL:
 				{
@@ -169,7 +246,7 @@ namespace MSL
 					out << tmp;
 				}
 				out << STRING(STRING_DECL) << ' ';
-				stringSize = GenericRead<uint16_t>();
+				stringSize = compactFormat ? ReadSize() : GenericRead<uint16_t>();
 				out << stringSize << ' ';
 				out << ReadString(stringSize);
 				break;
@@ -195,7 +272,16 @@ namespace MSL
 
 		size_t BytecodeReader::ReadSize()
 		{
-			return GenericRead<size_t>();
+			if (!compactFormat) return GenericRead<size_t>();
+
+			uint64_t size = 0;
+			VM::ReadVarint(file, size);
+			return static_cast<size_t>(size);
+		}
+
+		uint16_t BytecodeReader::ReadLabel()
+		{
+			return compactFormat ? static_cast<uint16_t>(ReadSize()) : GenericRead<uint16_t>();
 		}
 
 		uint8_t BytecodeReader::ReadModifiers()
@@ -19,14 +19,30 @@ namespace MSL
 			*/
 			std::ifstream file;
 			/*
+			true if file is written in compact format, in which sizes, hashes and labels are LEB128 integers
+			*/
+			bool compactFormat = false;
+			/*
+			true if method dependencies are written as indices in assembly constant pool
+			*/
+			bool hasConstantPool = false;
+			/*
+			true if size of method body is written after METHOD_BODY_BEGIN_DECL
+			*/
+			bool hasBodySize = false;
+			/*
 			reads next opcode in binary file
 			*/
 			VM::OPCODE ReadOPCode();
 			/*
-			reads next size_t variable in binary file
+			reads next size, hash or string size in binary file
 			*/
 			size_t ReadSize();
 			/*
+			reads next label in binary file
+			*/
+			uint16_t ReadLabel();
+			/*
 			reads next modifier variable in binary file as uint8_t
 			*/
 			uint8_t ReadModifiers();
@@ -46,7 +46,22 @@ namespace MSL
 
 		size_t Frame::GetSize() const
 		{
-			return locals.size() * sizeof(std::pair<std::string, Local>);
+			return locals.size() * sizeof(std::pair<std::string, Local>) + localSlots.capacity() * sizeof(Local*);
+		}
+
+		void Frame::Reset()
+		{
+			locals.clear();
+			localSlots.clear();
+			localStorage.clear();
+			classObject = nullptr;
+			offset = 0;
+		}
+
+		void Frame::ClearCaches()
+		{
+			integerCache = IntegerCache();
+			floatCache = FloatCache();
 		}
 	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "objects.h"
 #include "cacher.h"
+#include "ExceptionTrace.h"
 #include <vector>
 #include <string>
 
@@ -9,36 +10,48 @@ namespace MSL
 {
 	namespace VM
 	{
-		struct ExceptionInfo
-		{
-			size_t stackSize;
-			uint16_t label;
-		};
-
 		struct Frame
 		{
 			using LocalsTable = std::unordered_map<std::string, Local>;
 			using LocalStorage = std::vector<std::unique_ptr<std::string>>;
-			using ExceptionStack = std::vector<ExceptionInfo>;
 			using IntegerCache = momo::Cacher<size_t, IntegerObject::InnerType>;
 			using FloatCache = momo::Cacher<size_t, FloatObject::InnerType>;
+			using LocalSlots = std::vector<Local*>;
 			IntegerCache integerCache;
 			FloatCache floatCache;
 
 			LocalsTable locals;
+			/*
+			pointers to locals indexed by method dependency hash, filled on first LOAD_LOCAL / STORE_LOCAL
+			locals are never erased from frame, so pointers stay valid while frame exists
+			*/
+			LocalSlots localSlots;
 			LocalStorage localStorage;
-			ExceptionStack exceptionStack;
 			const NamespaceType* _namespace = nullptr;
 			const ClassType* _class = nullptr;
 			const MethodType* _method = nullptr;
 			BaseObject* classObject = nullptr;
 			size_t offset = 0;
+			size_t stackBase = 0; // object stack size after parameters are popped, it is restored when error is caught
+			/*
+			method which started the frame and number of TAIL_CALL instructions which reused it. Kept by Reset(), so stack trace includes them
+			*/
+			ExceptionTrace::TraceEntry tailCaller = { nullptr, nullptr, 0 };
+			size_t tailCalls = 0;
 			GCstate state = GCstate::UNMARKED;
 
 			Frame() = default;
 			Frame(Frame&&) = default;
 			Frame& operator=(Frame&&) = default;
 			size_t GetSize() const;
+			/*
+			clears state of method execution, so frame can be reused by the next method call. Integer and Float caches are kept
+			*/
+			void Reset();
+			/*
+			clears Integer and Float caches, which are indexed by hashes of method dependencies
+			*/
+			void ClearCaches();
 		};
 
 		class CallPath
@@ -51,6 +51,11 @@ namespace MSL
 			return methods;
 		}
 
+		Class::MethodArray& Class::GetMethods()
+		{
+			return methods;
+		}
+
 		bool Class::ContainsMember(const std::string& memberName) const
 		{
 			return table.find(memberName) != table.end();
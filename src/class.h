@@ -113,6 +113,10 @@ namespace MSL
 			*/
 			const MethodArray& GetMethods() const;
 			/*
+			returns reference to all methods in class
+			*/
+			MethodArray& GetMethods();
+			/*
 			checks if class already contains member with given name
 			*/
 			bool ContainsMember(const std::string& memberName) const;
@@ -29,7 +29,7 @@ namespace MSL
 			AttributeHashTable staticAttributes;
 			AttributeHashTable objectAttributes;
 			MethodHashTable methods;
-			ClassObject* staticInstance = nullptr;
+			mutable ClassObject* staticInstance = nullptr; // allocated by VM when class static state is first referenced
 			ClassWrapper* wrapper = nullptr;
 			mutable bool staticConstructorCalled = false;
 			std::string namespaceName;
@@ -1,5 +1,6 @@
 #include "codeGenerator.h"
 #include "assembly.h"
+#include "stringExtensions.h"
 
 namespace MSL
 {
@@ -8,10 +9,44 @@ namespace MSL
 		using namespace VM;
 		/*
 		assembly structure:
+			[BYTECODE_MAGIC] [uint16 version] -> header of compact format
+			ASSEMBLY_BEGIN_DECL
+			[constant pool] -> look constant pool structure
 			NAMESPACE_POOL_DECL_SIZE [namespace pool size] -> namespaces in assembly
 			[namespace pool] -> look namespace structure
+			ASSEMBLY_END_DECL
+		all sizes, hashes and labels are written as LEB128 integers (see WriteSize)
 		*/
 
+		/*
+		constant pool structure:
+			CONSTANT_POOL_DECL_SIZE [constant pool size] -> unique dependencies of all methods in assembly
+			[STRING_DECL [string size] [string]] -> dependency with escape sequences replaced
+		*/
+		void CodeGenerator::GenerateConstantPool()
+		{
+			for (const auto& _namespace : assembly.GetNamespaces())
+			{
+				for (const auto& _class : _namespace.GetMembers())
+				{
+					for (const auto& method : _class.GetMethods())
+					{
+						for (const auto& variable : method.GetVariables())
+						{
+							auto it = constantIndices.emplace(utils::replaceEscapeTokens(variable), constants.size());
+							if (it.second) constants.push_back(&it.first->first);
+						}
+					}
+				}
+			}
+			Write(OPCODE::CONSTANT_POOL_DECL_SIZE);
+			WriteSize(constants.size());
+			for (const std::string* constant : constants)
+			{
+				WriteString(*constant);
+			}
+		}
+
 		/*
 		namespace structure:
 			STRING_DECL [string size] [string] -> namespace name
@@ -20,15 +55,18 @@ namespace MSL
 		*/
 		void CodeGenerator::GenerateNamespacePool()
 		{
+			out.Write(BYTECODE_MAGIC, sizeof(BYTECODE_MAGIC));
+			Write(BYTECODE_VERSION);
 			Write(OPCODE::ASSEMBLY_BEGIN_DECL);
+			GenerateConstantPool();
 			const auto& namespaces = assembly.GetNamespaces();
 			Write(OPCODE::NAMESPACE_POOL_DECL_SIZE);
-			Write(namespaces.size());
+			WriteSize(namespaces.size());
 			for (const auto& _namespace : namespaces)
 			{
 				WriteString(_namespace.GetName());
 				Write(OPCODE::FRIEND_POOL_DECL_SIZE);
-				Write(_namespace.friendNamespaces.size());
+				WriteSize(_namespace.friendNamespaces.size());
 				for (const auto& friendNamespace : _namespace.friendNamespaces)
 				{
 					WriteString(friendNamespace);
@@ -49,7 +87,7 @@ namespace MSL
 		{
 			const auto& classes = _namespace.GetMembers();
 			Write(OPCODE::CLASS_POOL_DECL_SIZE);
-			Write(classes.size());
+			WriteSize(classes.size());
 			for (const auto& _class : classes)
 			{
 				WriteString(_class.name);
@@ -71,7 +109,7 @@ namespace MSL
 		{
 			Write(OPCODE::ATTRIBUTE_POOL_DECL_SIZE);
 			const auto& attributes = _class.GetAttributes();
-			Write(attributes.size());
+			WriteSize(attributes.size());
 			for (const auto& attr : attributes)
 			{
 				WriteString(attr.name);
@@ -83,23 +121,25 @@ namespace MSL
 		void CodeGenerator::GenerateMethod(const Method& method)
 		{
 			Write(OPCODE::METHOD_PARAMS_DECL_SIZE);
-			Write(method.params.size());
+			WriteSize(method.params.size());
 			for (const auto& param : method.params)
 			{
 				WriteString(param);
 			}
 			Write(OPCODE::DEPENDENCY_POOL_DECL_SIZE);
 			const auto& variables = method.GetVariables();
-			Write(variables.size());
+			WriteSize(variables.size());
 			for (const auto& variable : variables)
 			{
-				WriteString(variable);
+				WriteSize(constantIndices[utils::replaceEscapeTokens(variable)]);
 			}
+			// method body is generated by expressions with fixed-size operands, as VM executes it. Operands are compacted here
+			const auto& bytecode = method.GetBytecode();
+			methodBody.Clear();
+			EncodeMethodBody(bytecode.GetData(), bytecode.GetSize(), methodBody);
 			Write(OPCODE::METHOD_BODY_BEGIN_DECL);
-            for (const auto& byte : method.GetBytecode().str())
-            {
-                Write(byte);
-            }
+			WriteSize(methodBody.GetSize()); // lets VM skip body until method is called
+			out.Write(methodBody.GetData(), methodBody.GetSize());
 			Write(OPCODE::METHOD_BODY_END_DECL);
 		}
 
@@ -107,7 +147,7 @@ namespace MSL
 		{
 			Write(OPCODE::METHOD_POOL_DECL_SIZE);
 			const auto& methods = _class.GetMethods();
-			Write(methods.size());
+			WriteSize(methods.size());
 			for (const auto& method : methods)
 			{
 				WriteString(method.name);
@@ -117,13 +157,16 @@ namespace MSL
 			}
 		}
 
+		void CodeGenerator::WriteSize(size_t size)
+		{
+			WriteVarint(out, size);
+		}
+
 		void CodeGenerator::WriteString(const std::string& data)
 		{
-			using StringSize = uint16_t;
 			Write(OPCODE::STRING_DECL);
-			StringSize stringSize = static_cast<StringSize>(data.size()); // size cannot be more than 0xFFFF !
-			Write(stringSize);
-			out.write(data.c_str(), stringSize);
+			WriteSize(data.size());
+			out.Write(data.data(), data.size());
 		}
 
 		CodeGenerator::CodeGenerator(const Assembly& assembly)
@@ -134,9 +177,9 @@ namespace MSL
 			GenerateNamespacePool();
 		}
 
-		std::string CodeGenerator::GetBuffer() const
+		const std::string& CodeGenerator::GetBuffer() const
 		{
-			return out.str();
+			return out.GetString();
 		}
 	}
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "opcode.h"
-#include <sstream>
+#include "byteBuffer.h"
+#include <unordered_map>
+#include <vector>
 
 namespace MSL
 {
@@ -25,9 +27,25 @@ namespace MSL
 			*/
 			const Assembly& assembly;
 			/*
-			stream for writing bytecode of assembly
+			buffer for writing bytecode of assembly
 			*/
-			std::stringstream out;
+			utils::ByteBuffer out;
+			/*
+			buffer for encoding method body before it is written to assembly. It is reused by all methods
+			*/
+			utils::ByteBuffer methodBody;
+			/*
+			indices of strings in assembly constant pool. Strings are stored with escape sequences replaced
+			*/
+			std::unordered_map<std::string, size_t> constantIndices;
+			/*
+			strings of constant pool in order they are written
+			*/
+			std::vector<const std::string*> constants;
+			/*
+			collects dependencies of all methods in assembly and writes them as constant pool
+			*/
+			void GenerateConstantPool();
 			/*
 			generates a list of namespaces from assembly provided (see CodeGenerator::assembly)
 			*/
@@ -58,16 +76,20 @@ namespace MSL
 			*/
 			void GenerateBytecode();
 			/*
-			Returns contents of stream with assembly
+			Returns contents of buffer with assembly
 			*/
-			std::string GetBuffer() const;
+			const std::string& GetBuffer() const;
 			/*
 			writes binary representation of data to the binary file
 			*/
 			template<typename T>
 			void Write(T data);
 			/*
-			writes string object to the binary file in format [uint8_t size][char[] char_array]
+			writes size, hash or label to the binary file as LEB128 integer
+			*/
+			void WriteSize(size_t size);
+			/*
+			writes string object to the binary file in format [LEB128 size][char[] char_array]
 			*/
 			void WriteString(const std::string& data);
 		};
@@ -78,7 +100,7 @@ namespace MSL
 		template<typename T>
 		inline void CodeGenerator::Write(T data)
 		{
-			out.write(reinterpret_cast<char*>(&data), sizeof(T));
+			out.Write(data);
 		}
 	}
 }
\ No newline at end of file
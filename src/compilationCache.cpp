@@ -0,0 +1,164 @@
+#include "compilationCache.h"
+#include "opcode.h"
+
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace MSL
+{
+	namespace compiler
+	{
+		std::string CompilationCache::Report::ToString() const
+		{
+			return std::to_string(hits) + " hits, " + std::to_string(misses) + " misses, " +
+				std::to_string(evicted) + " evicted (" + std::to_string(entries) + " entries, " +
+				std::to_string(totalSize) + " bytes)";
+		}
+
+		CompilationCache::CompilationCache(const std::string& directory, size_t maxSize)
+			: directory(directory), maxSize(maxSize)
+		{
+			#ifdef _WIN32
+			_mkdir(directory.c_str());
+			#else
+			mkdir(directory.c_str(), 0755);
+			#endif
+
+			// index contains key and size of entries, most recently used first
+			std::ifstream indexFile(GetIndexPath());
+			std::string key;
+			size_t size;
+			while (indexFile >> key >> size)
+			{
+				if (index.find(key) != index.end()) continue;
+				entries.push_back({ key, size });
+				index[key] = std::prev(entries.end());
+				totalSize += size;
+			}
+		}
+
+		std::string CompilationCache::GetEntryPath(const std::string& key) const
+		{
+			return directory + '/' + key + ".emsl";
+		}
+
+		std::string CompilationCache::GetIndexPath() const
+		{
+			return directory + "/index";
+		}
+
+		std::string CompilationCache::GetKey(const char* source, size_t size, int optimizationLevel)
+		{
+			// 64-bit FNV-1a hash over source and everything which changes generated bytecode
+			uint64_t hash = 14695981039346656037ull;
+			auto append = [&hash](const char* data, size_t size)
+			{
+				for (size_t i = 0; i < size; i++)
+				{
+					hash ^= static_cast<uint8_t>(data[i]);
+					hash *= 1099511628211ull;
+				}
+			};
+			uint16_t versions[] = { COMPILER_VERSION, VM::BYTECODE_VERSION, static_cast<uint16_t>(sizeof(size_t)), static_cast<uint16_t>(optimizationLevel) };
+			append(reinterpret_cast<const char*>(versions), sizeof(versions));
+			append(source, size);
+
+			std::stringstream key;
+			key << std::hex << hash << '_' << std::dec << size;
+			return key.str();
+		}
+
+		void CompilationCache::Touch(const std::string& key, size_t size)
+		{
+			auto it = index.find(key);
+			if (it != index.end())
+			{
+				totalSize -= it->second->size;
+				entries.erase(it->second);
+			}
+			entries.push_front({ key, size });
+			index[key] = entries.begin();
+			totalSize += size;
+		}
+
+		void CompilationCache::Remove(EntryList::iterator entry)
+		{
+			std::remove(GetEntryPath(entry->key).c_str());
+			totalSize -= entry->size;
+			index.erase(entry->key);
+			entries.erase(entry);
+		}
+
+		bool CompilationCache::Load(const std::string& key, std::string& bytecode)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (index.find(key) == index.end())
+				{
+					report.misses++;
+					return false;
+				}
+			}
+
+			std::ifstream file(GetEntryPath(key), std::ios::binary);
+			std::stringstream contents;
+			contents << file.rdbuf();
+			bytecode = contents.str();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			auto it = index.find(key);
+			if (!file || it == index.end() || bytecode.size() != it->second->size) // entry was removed from directory
+			{
+				if (it != index.end()) Remove(it->second);
+				report.misses++;
+				return false;
+			}
+			Touch(key, bytecode.size());
+			report.hits++;
+			return true;
+		}
+
+		void CompilationCache::Store(const std::string& key, const std::string& bytecode)
+		{
+			if (bytecode.size() > maxSize) return;
+
+			std::ofstream file(GetEntryPath(key), std::ios::binary);
+			file.write(bytecode.c_str(), bytecode.size());
+			file.close();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (file) Touch(key, bytecode.size());
+		}
+
+		void CompilationCache::Flush()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			while (totalSize > maxSize)
+			{
+				Remove(std::prev(entries.end()));
+				report.evicted++;
+			}
+
+			std::ofstream indexFile(GetIndexPath());
+			for (const auto& entry : entries)
+			{
+				indexFile << entry.key << ' ' << entry.size << '\n';
+			}
+			report.entries = entries.size();
+			report.totalSize = totalSize;
+		}
+
+		const CompilationCache::Report& CompilationCache::GetReport() const
+		{
+			return report;
+		}
+	}
+}
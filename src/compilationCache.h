@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+namespace MSL
+{
+	namespace compiler
+	{
+		/*
+		version of compiler output. It must be incremented when generated bytecode changes, so entries of older compiler are not used
+		*/
+		constexpr uint16_t COMPILER_VERSION = 1;
+
+		/*
+		CompilationCache class stores bytecode of compiled source files in a directory, so files which did not change are not compiled again
+		entries are keyed by hash of source contents, compiler version and optimization level
+		index of entries is kept in order of their use, least recently used entries are evicted when total size of cache exceeds limit
+		Load() and Store() may be called from multiple threads, Flush() must be called after all files are compiled
+		*/
+		class CompilationCache
+		{
+		public:
+			/*
+			statistics of cache usage since it was created
+			*/
+			struct Report
+			{
+				size_t hits = 0;
+				size_t misses = 0;
+				size_t evicted = 0;
+				size_t entries = 0;
+				size_t totalSize = 0;
+				/*
+				returns human-read representation of report as string
+				*/
+				std::string ToString() const;
+			};
+		private:
+			struct Entry
+			{
+				std::string key;
+				size_t size;
+			};
+			using EntryList = std::list<Entry>;
+
+			/*
+			directory where cache index and bytecode of entries are stored
+			*/
+			std::string directory;
+			/*
+			maximum total size of bytecode stored in cache (in bytes)
+			*/
+			size_t maxSize;
+			/*
+			entries of cache, most recently used first
+			*/
+			EntryList entries;
+			std::unordered_map<std::string, EntryList::iterator> index;
+			size_t totalSize = 0;
+			Report report;
+			std::mutex mutex;
+
+			std::string GetEntryPath(const std::string& key) const;
+			std::string GetIndexPath() const;
+			/*
+			moves entry to the front of cache index, adding it if it does not exist yet
+			*/
+			void Touch(const std::string& key, size_t size);
+			/*
+			removes entry from cache index and its bytecode from directory
+			*/
+			void Remove(EntryList::iterator entry);
+		public:
+			/*
+			opens cache in directory provided, creating directory if it does not exist
+			*/
+			CompilationCache(const std::string& directory, size_t maxSize);
+			CompilationCache(const CompilationCache&) = delete;
+			CompilationCache& operator=(const CompilationCache&) = delete;
+			/*
+			returns key of source file compiled with optimization level provided
+			*/
+			static std::string GetKey(const char* source, size_t size, int optimizationLevel);
+			/*
+			reads bytecode stored by key. Returns false if cache has no entry for it
+			*/
+			bool Load(const std::string& key, std::string& bytecode);
+			/*
+			stores bytecode by key, replacing previous entry
+			*/
+			void Store(const std::string& key, const std::string& bytecode);
+			/*
+			evicts least recently used entries which do not fit into cache size and writes cache index to directory
+			*/
+			void Flush();
+			/*
+			returns statistics of cache usage
+			*/
+			const Report& GetReport() const;
+		};
+	}
+}
@@ -28,6 +28,7 @@ namespace MSL
 			{
 				bool varifyBytecode = true;
 				bool allowAssemblyMerge = true;
+				bool lazyDecoding = true; // method bodies are decoded on first call
 			} compilation;
 			struct
 			{
@@ -36,7 +37,16 @@ namespace MSL
 				bool useUnicode = true;
 				bool safeMode = false;
 				bool cacheDll = true;
+				bool useJit = false;
+				uint32_t jitThreshold = 1000;
+				bool writePerfMap = true;
+				bool inlineMethods = true;
 			} execution;
+			struct
+			{
+				bool enabled = true;
+				std::ostream* log = nullptr;
+			} quickening;
 		};
 	}
 }
@@ -14,9 +14,9 @@ namespace MSL
 		using namespace VM;
 
         template<typename T>
-        void Write(std::ostream& out, T value)
+        void Write(utils::ByteBuffer& out, T value)
         {
-            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            out.Write(value);
         }
 
 #define OFFSET_PRINT(...) std::cout << std::string(offset * 2, ' ') << __VA_ARGS__
@@ -33,12 +33,7 @@ namespace MSL
             }
         }
 
-        void ObjectNode::Destroy()
-        {
-            
-        }
-
-        void ObjectNode::GenerateBytecode(std::ostream& out, Method& function)
+        void ObjectNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             function.InsertDependency(this->value);
 
@@ -57,7 +52,15 @@ namespace MSL
                 Write(out, function.GetHash(value));
                 break;
             case Token::Type::OBJECT:
-                Write(out, OPCODE::PUSH_OBJECT);
+                // names which compiler knows as locals or parameters are read by VM without name resolution
+                if (function.ContainsLocal(value) || function.ContainsParameter(value))
+                {
+                    Write(out, OPCODE::LOAD_LOCAL);
+                }
+                else
+                {
+                    Write(out, OPCODE::PUSH_OBJECT);
+                }
                 Write(out, function.GetHash(value));
                 break;
             case Token::Type::TRUE_CONSTANT:
@@ -85,14 +88,7 @@ namespace MSL
             std::cout << "." << this->object << ">";
         }
 
-#define FREE_AST(node) node->Destroy(); delete node; node = nullptr;
-
-        void MemberCallNode::Destroy()
-        {
-            FREE_AST(parent)
-        }
-
-        void MemberCallNode::GenerateBytecode(std::ostream& out, Method& function)
+        void MemberCallNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             function.InsertDependency(this->object);
 
@@ -109,12 +105,7 @@ namespace MSL
             std::cout << "]";
         }
 
-        void IndexCallNode::Destroy()
-        {
-            FREE_AST(parent)
-        }
-
-        void IndexCallNode::GenerateBytecode(std::ostream& out, Method& function)
+        void IndexCallNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             this->parent->GenerateBytecode(out, function);
             this->index->GenerateBytecode(out, function);
@@ -131,16 +122,7 @@ namespace MSL
             }
         }
 
-        void AstNodeList::Destroy()
-        {
-            for (auto& node : this->vec)
-            {
-                FREE_AST(node);
-            }
-            this->vec.clear();
-        }
-
-        void AstNodeList::GenerateBytecode(std::ostream& out, Method& function)
+        void AstNodeList::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             for (const auto& expression : this->vec)
             {
@@ -169,12 +151,7 @@ namespace MSL
             }
         }
 
-        void StringList::Destroy()
-        {
-            this->vec.clear();
-        }
-
-        void StringList::GenerateBytecode(std::ostream& out, Method& function)
+        void StringList::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("StringList node does not implement GenerateBytecode");
         }
@@ -193,13 +170,7 @@ namespace MSL
             std::cout << ")>";
         }
 
-        void MethodCallNode::Destroy()
-        {
-            FREE_AST(parent)
-            FREE_AST(args)
-        }
-
-        void MethodCallNode::GenerateBytecode(std::ostream& out, Method& function)
+        void MethodCallNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             if (this->parent != nullptr)
             {
@@ -217,7 +188,7 @@ namespace MSL
             }
             std::string methodName = this->name + '_' + std::to_string(this->args->vec.size());
             function.InsertDependency(methodName);
-            Write(out, OPCODE::CALL_FUNCTION);
+            Write(out, this->isTailCall ? OPCODE::TAIL_CALL : OPCODE::CALL_FUNCTION);
             Write(out, function.GetHash(methodName));
             Write(out, static_cast<uint8_t>(this->args->vec.size()));
         }
@@ -232,18 +203,53 @@ namespace MSL
             std::cout << ")";
         }
 
-        void BinaryExprNode::Destroy()
+        void BinaryExprNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
-            this->left->Destroy();
-            this->right->Destroy();
-            delete left;
-            delete right;
-            left = right = nullptr;
-        }
-
-        void BinaryExprNode::GenerateBytecode(std::ostream& out, Method& function)
-        {
-            this->left->GenerateBytecode(out, function);
+            if (this->op == Token::Type::LOGIC_AND || this->op == Token::Type::LOGIC_OR)
+            {
+                // short-circuit: if left operand is Boolean false for `&&` (true for `||`), it is the result and right one is skipped
+                // any other left operand (e.g. class object with AndOperator / OrOperator) is passed to CMP_AND / CMP_OR as usual
+                bool isAnd = this->op == Token::Type::LOGIC_AND;
+                uint16_t endLabel = function.labelInnerId++;
+                this->left->GenerateBytecode(out, function);
+                Write(out, isAnd ? OPCODE::JUMP_IF_FALSE_KEEP : OPCODE::JUMP_IF_TRUE_KEEP);
+                Write(out, endLabel);
+                this->right->GenerateBytecode(out, function);
+                Write(out, isAnd ? OPCODE::CMP_AND : OPCODE::CMP_OR);
+                Write(out, OPCODE::SET_LABEL);
+                Write(out, endLabel);
+                return;
+            }
+            ObjectNode* target = dynamic_cast<ObjectNode*>(this->left);
+            bool assignsToName = target != nullptr && target->type == Token::Type::OBJECT && (
+                this->op == Token::Type::ASSIGN_OP ||
+                this->op == Token::Type::SUM_ASSIGN_OP ||
+                this->op == Token::Type::SUB_ASSIGN_OP ||
+                this->op == Token::Type::MULT_ASSIGN_OP ||
+                this->op == Token::Type::DIV_ASSIGN_OP ||
+                this->op == Token::Type::MOD_ASSIGN_OP ||
+                this->op == Token::Type::POWER_ASSIGN_OP
+                );
+            if (assignsToName)
+            {
+                function.InsertDependency(target->value);
+                bool isLocal = function.ContainsLocal(target->value) || function.ContainsParameter(target->value);
+                if (this->op == Token::Type::ASSIGN_OP && isLocal)
+                {
+                    // `local = value` is stored directly to the local
+                    this->right->GenerateBytecode(out, function);
+                    Write(out, OPCODE::STORE_LOCAL);
+                    Write(out, function.GetHash(target->value));
+                    return;
+                }
+                // assignment target must be resolved by VM as reference, not as value
+                Write(out, OPCODE::PUSH_OBJECT);
+                Write(out, function.GetHash(target->value));
+            }
+            else
+            {
+                this->left->GenerateBytecode(out, function);
+            }
             this->right->GenerateBytecode(out, function);
             switch (this->op)
             {
@@ -268,6 +274,31 @@ namespace MSL
             case Token::Type::ASSIGN_OP:
                 Write(out, OPCODE::ASSIGN_OP);
                 break;
+            // compound assignment: ALU assigns result of operation to the left operand
+            case Token::Type::SUM_ASSIGN_OP:
+                Write(out, OPCODE::SET_ALU_INCR);
+                Write(out, OPCODE::SUM_OP);
+                break;
+            case Token::Type::SUB_ASSIGN_OP:
+                Write(out, OPCODE::SET_ALU_INCR);
+                Write(out, OPCODE::SUB_OP);
+                break;
+            case Token::Type::MULT_ASSIGN_OP:
+                Write(out, OPCODE::SET_ALU_INCR);
+                Write(out, OPCODE::MULT_OP);
+                break;
+            case Token::Type::DIV_ASSIGN_OP:
+                Write(out, OPCODE::SET_ALU_INCR);
+                Write(out, OPCODE::DIV_OP);
+                break;
+            case Token::Type::MOD_ASSIGN_OP:
+                Write(out, OPCODE::SET_ALU_INCR);
+                Write(out, OPCODE::MOD_OP);
+                break;
+            case Token::Type::POWER_ASSIGN_OP:
+                Write(out, OPCODE::SET_ALU_INCR);
+                Write(out, OPCODE::POWER_OP);
+                break;
             case Token::Type::LOGIC_EQUALS:
                 Write(out, OPCODE::CMP_EQ);
                 break;
@@ -311,12 +342,7 @@ namespace MSL
             }
         }
 
-        void ReturnExprNode::Destroy()
-        {
-            FREE_AST(value)
-        }
-
-        void ReturnExprNode::GenerateBytecode(std::ostream& out, Method& function)
+        void ReturnExprNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             if(this->value == nullptr)
             {
@@ -324,6 +350,9 @@ namespace MSL
             }
             else
             {
+                // call in tail position can reuse frame of the method, POP_TO_RETURN is still executed if VM cannot do it
+                MethodCallNode* call = dynamic_cast<MethodCallNode*>(this->value);
+                if (call != nullptr) call->isTailCall = true;
                 value->GenerateBytecode(out, function);
                 Write(out, OPCODE::POP_TO_RETURN);
             }
@@ -348,12 +377,7 @@ namespace MSL
             }
         }
 
-        void VariableDeclNode::Destroy()
-        {
-            FREE_AST(value)
-        }
-
-        void VariableDeclNode::GenerateBytecode(std::ostream& out, Method& function)
+        void VariableDeclNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             if (function.ContainsLocal(this->name))
             {
@@ -406,14 +430,7 @@ namespace MSL
             }
         }
 
-        void MethodDeclNode::Destroy()
-        {
-            FREE_AST(body);
-            FREE_AST(modifiers);
-            FREE_AST(args);
-        }
-
-        void MethodDeclNode::GenerateBytecode(std::ostream& out, Method& function)
+        void MethodDeclNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("MethodDecl node does not implement GenerateBytecode");
         }
@@ -430,14 +447,7 @@ namespace MSL
             OFFSET_PRINT("}");
         }
 
-        void ForeachExprNode::Destroy()
-        {
-            FREE_AST(body)
-
-            FREE_AST(container)
-        }
-
-        void ForeachExprNode::GenerateBytecode(std::ostream& out, Method& function)
+        void ForeachExprNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             function.InsertDependency(this->iterator);
             Write(out, OPCODE::ALLOC_VAR);
@@ -447,85 +457,32 @@ namespace MSL
             uint16_t labelId = function.labelInnerId;
             function.labelInnerId += 2; // predicate and end-foreach label
 
-            // var iteratorIndex = container.Begin();
             std::string iteratorIndex = "__BEGIN_" + std::to_string(function.labelInnerId);
             function.InsertDependency(iteratorIndex);
-            Write(out, OPCODE::ALLOC_VAR);
-            Write(out, function.GetHash(iteratorIndex));
-
-            this->container->GenerateBytecode(out, function);
             std::string container = "__CONTAINER_" + std::to_string(function.labelInnerId);
             function.InsertDependency(container);
-            Write(out, OPCODE::ALLOC_VAR);
-            Write(out, function.GetHash(container));
-            Write(out, OPCODE::ASSIGN_OP);
-
-            // call of .Begin(this);
-            function.InsertDependency("Begin_0");
-            Write(out, OPCODE::CALL_FUNCTION);
-            Write(out, function.GetHash("Begin_0"));
-            Write<uint8_t>(out, 0);
 
-            Write(out, OPCODE::ASSIGN_OP); // init iterator with begin of container
-            Write(out, OPCODE::POP_STACK_TOP);
+            // var container = expr; var iteratorIndex = container.Begin();
+            this->container->GenerateBytecode(out, function);
+            Write(out, OPCODE::ITER_INIT);
+            Write(out, function.GetHash(container));
+            Write(out, function.GetHash(iteratorIndex));
 
             Write(out, OPCODE::SET_LABEL); // predicate
             Write(out, labelId);
 
             // if(iteratorIndex == container.End()) jump_end;
-            Write(out, OPCODE::PUSH_OBJECT);
-            Write(out, function.GetHash(iteratorIndex));
-            Write(out, OPCODE::PUSH_OBJECT);
-            Write(out, function.GetHash(container));
-
-            // call of .End(this);
-            function.InsertDependency("End_0");
-            Write(out, OPCODE::CALL_FUNCTION);
-            Write(out, function.GetHash("End_0"));
-            Write<uint8_t>(out, 0);
-
-            Write(out, OPCODE::CMP_EQ);
-            Write(out, OPCODE::JUMP_IF_TRUE);
-            Write<uint16_t>(out, labelId + 1); // to end-foreach
-
             // iterator = container.GetByIter(iteratorIndex);
-            Write(out, OPCODE::PUSH_OBJECT);
-            Write(out, function.GetHash(iterator));
-            Write(out, OPCODE::PUSH_OBJECT);
+            // iteratorIndex = container.Next(iteratorIndex);
+            Write(out, OPCODE::ITER_NEXT);
+            Write(out, function.GetHash(this->iterator));
             Write(out, function.GetHash(container));
-            Write(out, OPCODE::PUSH_OBJECT);
             Write(out, function.GetHash(iteratorIndex));
-
-            // call of .GetByIter(this, iter);
-            function.InsertDependency("GetByIter_1");
-            Write(out, OPCODE::CALL_FUNCTION);
-            Write(out, function.GetHash("GetByIter_1"));
-            Write<uint8_t>(out, 1);
-
-            Write(out, OPCODE::ASSIGN_OP);
-            Write(out, OPCODE::POP_STACK_TOP);
+            Write<uint16_t>(out, labelId + 1); // to end-foreach
 
             // generate body inside { }
             this->body->GenerateBytecode(out, function);
 
-            // iteratorIndex = container.Next(iteratorIndex);
-            Write(out, OPCODE::PUSH_OBJECT);
-            Write(out, function.GetHash(iteratorIndex));
-            Write(out, OPCODE::PUSH_OBJECT);
-            Write(out, function.GetHash(container));
-            Write(out, OPCODE::PUSH_OBJECT);
-            Write(out, function.GetHash(iteratorIndex));
-
-            // call of .Next(this, iter);
-            function.InsertDependency("Next_1");
-            Write(out, OPCODE::CALL_FUNCTION);
-            Write(out, function.GetHash("Next_1"));
-            Write(out, (uint8_t)1);
-
-            Write(out, OPCODE::ASSIGN_OP);
-            Write(out, OPCODE::POP_STACK_TOP);
-
-
             Write(out, OPCODE::JUMP);
             Write(out, labelId); // to predicate
             Write(out, OPCODE::SET_LABEL);
@@ -551,25 +508,7 @@ namespace MSL
             OFFSET_PRINT("}");
         }
 
-        void ForExprNode::Destroy()
-        {
-            FREE_AST(body)
-
-            if (this->init != nullptr)
-            {
-                FREE_AST(init)
-            }
-            if (this->pred != nullptr)
-            {
-                FREE_AST(pred)
-            }
-            if (this->iter != nullptr)
-            {
-                FREE_AST(iter)
-            }
-        }
-
-        void ForExprNode::GenerateBytecode(std::ostream& out, Method& function)
+        void ForExprNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             if (this->init != nullptr)
             {
@@ -615,21 +554,7 @@ namespace MSL
                 this->elseBlock->DebugPrint(offset, " ");
         }
 
-        void IfStatementNode::Destroy()
-        {
-            FREE_AST(ifBlock)
-
-            elifBlocks->Destroy();
-            delete elifBlocks;
-            elifBlocks = nullptr;
-            
-            if (this->elseBlock != nullptr)
-            {
-                FREE_AST(elseBlock)
-            }
-        }
-
-        void IfStatementNode::GenerateBytecode(std::ostream& out, Method& function)
+        void IfStatementNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             uint16_t labelId = function.labelInnerId;
             function.labelInnerId += (uint16_t)(this->elifBlocks->vec.size() + 1);
@@ -697,16 +622,7 @@ namespace MSL
             OFFSET_PRINT("}");
         }
 
-        void ConditionalNode::Destroy()
-        {
-            if (this->predicate != nullptr)
-            {
-                FREE_AST(predicate)
-            }
-            FREE_AST(body)
-        }
-
-        void ConditionalNode::GenerateBytecode(std::ostream& out, Method& function)
+        void ConditionalNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("Conditional node does not implement GenerateBytecode");
         }
@@ -736,16 +652,7 @@ namespace MSL
             }
         }
 
-        void TryCatchNode::Destroy()
-        {
-            FREE_AST(tryExpr)
-            if (this->catchExpr != nullptr)
-            {
-                FREE_AST(catchExpr)
-            }
-        }
-
-        void TryCatchNode::GenerateBytecode(std::ostream& out, Method& function)
+        void TryCatchNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             uint16_t labelId = function.labelInnerId;
             function.labelInnerId += 2; // for catch block and end of catch block
@@ -797,12 +704,7 @@ namespace MSL
             std::cout << ")";
         }
 
-        void UnaryExprNode::Destroy()
-        {
-            FREE_AST(expr)
-        }
-
-        void UnaryExprNode::GenerateBytecode(std::ostream& out, Method& function)
+        void UnaryExprNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             this->expr->GenerateBytecode(out, function);
             switch (this->op)
@@ -829,12 +731,7 @@ namespace MSL
             std::cout << "var " << this->name << ";\n";
         }
 
-        void AttributeDeclNode::Destroy()
-        {
-            FREE_AST(modifiers);
-        }
-
-        void AttributeDeclNode::GenerateBytecode(std::ostream& out, Method& function)
+        void AttributeDeclNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("AttributeDecl node does not implement GenerateBytecode");
         }
@@ -849,13 +746,7 @@ namespace MSL
             OFFSET_PRINT("}\n");
         }
 
-        void ClassDeclNode::Destroy()
-        {
-            FREE_AST(members);
-            FREE_AST(modifiers);
-        }
-
-        void ClassDeclNode::GenerateBytecode(std::ostream& out, Method& function)
+        void ClassDeclNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("ClassDecl node does not implement GenerateBytecode");
         }
@@ -865,9 +756,7 @@ namespace MSL
             OFFSET_PRINT("using namespace " << this->namespaceName << ';');
         }
 
-        void UsingNamespaceNode::Destroy() { }
-
-        void UsingNamespaceNode::GenerateBytecode(std::ostream& out, Method& function)
+        void UsingNamespaceNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("UsingNamespace node does not implement GenerateBytecode");
         }
@@ -880,12 +769,7 @@ namespace MSL
             OFFSET_PRINT("}");
         }
 
-        void NamespaceDeclNode::Destroy()
-        {
-            FREE_AST(members);
-        }
-
-        void NamespaceDeclNode::GenerateBytecode(std::ostream& out, Method& function)
+        void NamespaceDeclNode::GenerateBytecode(utils::ByteBuffer& out, Method& function)
         {
             throw std::exception("NamespaceDecl node does not implement GenerateBytecode");
         }
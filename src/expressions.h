@@ -1,18 +1,23 @@
 #pragma once
 
 #include "token.h"
+#include "byteBuffer.h"
+#include "arena.h"
 
 namespace MSL
 {
 	namespace compiler
 	{     
         class Method;
+        /*
+        AST nodes of compilation unit are allocated in arena and released all at once after assembly is compiled
+        */
+        using AstArena = utils::Arena;
 
         struct BaseAstNode
         {
             virtual void DebugPrint(int offset, const char* delim) const = 0;
-            virtual void Destroy() = 0;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) = 0;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) = 0;
             virtual ~BaseAstNode() = default;
         };
 
@@ -25,8 +30,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct MemberCallNode : BaseAstNode
@@ -39,8 +43,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct IndexCallNode : BaseAstNode
@@ -52,8 +55,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct AstNodeList : BaseAstNode
@@ -62,8 +64,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct StringList : BaseAstNode
@@ -72,8 +73,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct MethodCallNode : BaseAstNode
@@ -81,13 +81,13 @@ namespace MSL
             std::string name;
             BaseAstNode* parent;
             AstNodeList* args;
+            bool isTailCall = false; // call is the value of return statement (see ReturnExprNode)
             inline MethodCallNode(const std::string& name, BaseAstNode* parent, AstNodeList* args) :
                 name(name), parent(parent), args(args) { }
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct BinaryExprNode : BaseAstNode
@@ -100,8 +100,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct UnaryExprNode : BaseAstNode
@@ -113,8 +112,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct ReturnExprNode : BaseAstNode
@@ -124,8 +122,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct VariableDeclNode : BaseAstNode
@@ -138,8 +135,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct TryCatchNode : BaseAstNode
@@ -152,8 +148,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct ConditionalNode : BaseAstNode
@@ -165,8 +160,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct IfStatementNode : BaseAstNode
@@ -179,8 +173,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct ForExprNode : BaseAstNode
@@ -194,8 +187,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct ForeachExprNode : BaseAstNode
@@ -208,8 +200,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct MethodDeclNode : BaseAstNode
@@ -223,8 +214,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct AttributeDeclNode : BaseAstNode
@@ -236,8 +226,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct ClassDeclNode : BaseAstNode
@@ -250,8 +239,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct UsingNamespaceNode : BaseAstNode
@@ -262,8 +250,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 
         struct NamespaceDeclNode : BaseAstNode
@@ -275,8 +262,7 @@ namespace MSL
 
             // Inherited via BaseAstNode
             virtual void DebugPrint(int offset, const char* delim) const override;
-            virtual void Destroy() override;
-            virtual void GenerateBytecode(std::ostream& out, Method& function) override;
+            virtual void GenerateBytecode(utils::ByteBuffer& out, Method& function) override;
         };
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "function.h"
 #include <sstream>
+#include <algorithm>
 
 namespace MSL
 {
@@ -90,6 +91,11 @@ namespace MSL
 			return dependencies.find(dependenctyName) != dependencies.end();
 		}
 
+		bool Method::ContainsParameter(const std::string& parameterName) const
+		{
+			return std::find(params.begin(), params.end(), parameterName) != params.end();
+		}
+
 		size_t Method::GetHash(const std::string& variableName) const
 		{
 			auto localIter = locals.find(variableName);
@@ -2,7 +2,7 @@
 
 #include "expressions.h"
 #include <unordered_map>
-#include <sstream>
+#include "byteBuffer.h"
 
 namespace MSL
 {
@@ -17,7 +17,7 @@ namespace MSL
 			using VariableArray = std::vector<std::string>;
 			using ParameterArray = std::vector<std::string>;
 			using DependencyTable = std::unordered_map<std::string, size_t>;
-            using BytecodeArray = std::stringstream;
+            using BytecodeArray = utils::ByteBuffer;
             using ErrorList = std::vector<std::string>;
 			/*
 			string hash-table storing local variable name as key and index in VariableArray as value
@@ -136,6 +136,10 @@ namespace MSL
 			*/
 			bool ContainsDependency(const std::string& dependenctyName) const;
 			/*
+			checks if function has parameter with given name
+			*/
+			bool ContainsParameter(const std::string& parameterName) const;
+			/*
 			returns index in VariableArray by searching variable name in LocalScopeTable or in DependencyTable
 			GetHash() must only be used if the variable already exists in VariableArray
 			*/
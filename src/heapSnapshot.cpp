@@ -0,0 +1,341 @@
+#include "heapSnapshot.h"
+#include "virtualMachine.h"
+
+#include <cstring>
+
+namespace MSL
+{
+	namespace VM
+	{
+		HeapSnapshot::HeapSnapshot(VirtualMachine& vm, std::ostream* errorStream)
+			: vm(vm), errorStream(errorStream) { }
+
+		void HeapSnapshot::DisplayError(const std::string& message) const
+		{
+			if (errorStream != nullptr)
+				*errorStream << "[heap snapshot]: " << message << std::endl;
+		}
+
+		size_t HeapSnapshot::AddObject(const BaseObject* object)
+		{
+			auto it = objectIndices.find(object);
+			if (it != objectIndices.end()) return it->second;
+			objectIndices.insert({ object, objects.size() });
+			objects.push_back(object);
+			return objects.size() - 1;
+		}
+
+		static void WriteString(std::ostream& out, const std::string& str)
+		{
+			WriteVarint(out, str.size());
+			out.write(str.data(), str.size());
+		}
+
+		static bool ReadString(const uint8_t*& data, const uint8_t* end, std::string& str)
+		{
+			uint64_t size = 0;
+			if (!ReadVarint(data, end, size) || size > static_cast<uint64_t>(end - data)) return false;
+			str.assign(reinterpret_cast<const char*>(data), static_cast<size_t>(size));
+			data += size;
+			return true;
+		}
+
+		/*
+		heap structure:
+			[library count] [library names]
+			[object count] [objects]: [uint8 Type] [object data]:
+				CLASS_OBJECT: [namespace] [class] [attribute count] [[name] [object index]]
+				INTEGER: [decimal string]
+				FLOAT: [double]
+				STRING: [string]
+				NAMESPACE: [namespace]
+				CLASS: [namespace] [class]
+				BASE (array): [size] [[object index] [uint8 flags: 1 - isConst, 2 - isElement]]
+				NULLPTR, TRUE, FALSE: no data
+			[class count] [classes]: [namespace] [class] [uint8 static constructor called] [static instance index + 1 or 0]
+		counts, sizes and indices are LEB128 integers, strings are [LEB128 size][char[] char_array]
+		*/
+		bool HeapSnapshot::WriteObject(const BaseObject* object, std::ostream& out)
+		{
+			out.put(static_cast<char>(object->type));
+			switch (object->type)
+			{
+			case Type::CLASS_OBJECT:
+			{
+				const ClassObject* classObject = static_cast<const ClassObject*>(object);
+				WriteString(out, classObject->typeInstance->namespaceName);
+				WriteString(out, classObject->typeInstance->name);
+				WriteVarint(out, classObject->attributes.size());
+				for (const auto& attribute : classObject->attributes)
+				{
+					WriteString(out, attribute.first);
+					WriteVarint(out, objectIndices.at(attribute.second->object));
+				}
+				break;
+			}
+			case Type::INTEGER:
+				WriteString(out, static_cast<const IntegerObject*>(object)->value.to_string());
+				break;
+			case Type::FLOAT:
+			{
+				FloatObject::InnerType value = static_cast<const FloatObject*>(object)->value;
+				out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+				break;
+			}
+			case Type::STRING:
+				WriteString(out, static_cast<const StringObject*>(object)->value);
+				break;
+			case Type::NAMESPACE:
+				WriteString(out, static_cast<const NamespaceWrapper*>(object)->type->name);
+				break;
+			case Type::CLASS:
+				WriteString(out, static_cast<const ClassWrapper*>(object)->typeInstance->namespaceName);
+				WriteString(out, static_cast<const ClassWrapper*>(object)->typeInstance->name);
+				break;
+			case Type::BASE:
+			{
+				const ArrayObject* array = static_cast<const ArrayObject*>(object);
+				WriteVarint(out, array->array.size());
+				for (const Local& element : array->array)
+				{
+					WriteVarint(out, objectIndices.at(element.object));
+					out.put(static_cast<char>((element.isConst ? 1 : 0) | (element.isElement ? 2 : 0)));
+				}
+				break;
+			}
+			case Type::NULLPTR:
+			case Type::TRUE:
+			case Type::FALSE:
+				break;
+			default:
+				// locals, attributes and unknown objects exist only while method is executed
+				DisplayError("object of type " + ToString(object->type) + " cannot be written to snapshot");
+				return false;
+			}
+			return true;
+		}
+
+		bool HeapSnapshot::Write(std::ostream& out)
+		{
+			objects.clear();
+			objectIndices.clear();
+
+			std::vector<const ClassType*> classes;
+			for (const auto& ns : vm.GetAssembly().namespaces)
+			{
+				for (const auto& c : ns.second.classes)
+				{
+					const ClassType& _class = c.second;
+					if (!_class.staticConstructorCalled && _class.staticInstance == nullptr) continue;
+					classes.push_back(&_class);
+					if (_class.staticInstance != nullptr) AddObject(_class.staticInstance);
+				}
+			}
+			// objects are indexed in order they are reached from static instances
+			for (size_t i = 0; i < objects.size(); i++)
+			{
+				const BaseObject* object = objects[i];
+				if (object->type == Type::CLASS_OBJECT)
+				{
+					for (const auto& attribute : static_cast<const ClassObject*>(object)->attributes)
+					{
+						if (attribute.second->object == nullptr)
+						{
+							DisplayError("attribute " + attribute.first + " has no value");
+							return false;
+						}
+						AddObject(attribute.second->object);
+					}
+				}
+				else if (object->type == Type::BASE)
+				{
+					for (const Local& element : static_cast<const ArrayObject*>(object)->array)
+					{
+						AddObject(element.object);
+					}
+				}
+			}
+
+			#ifdef MSL_DLL_API
+			std::vector<std::string> libraries = vm.dllLoader.GetLibraries();
+			#else
+			std::vector<std::string> libraries;
+			#endif
+			WriteVarint(out, libraries.size());
+			for (const std::string& library : libraries)
+			{
+				WriteString(out, library);
+			}
+
+			WriteVarint(out, objects.size());
+			for (const BaseObject* object : objects)
+			{
+				if (!WriteObject(object, out)) return false;
+			}
+
+			WriteVarint(out, classes.size());
+			for (const ClassType* _class : classes)
+			{
+				WriteString(out, _class->namespaceName);
+				WriteString(out, _class->name);
+				out.put(static_cast<char>(_class->staticConstructorCalled));
+				WriteVarint(out, _class->staticInstance != nullptr ? objectIndices.at(_class->staticInstance) + 1 : 0);
+			}
+			return true;
+		}
+
+		bool HeapSnapshot::Restore(const uint8_t* data, size_t size)
+		{
+			#define CHECK_READ(expr) if (!(expr)) { DisplayError("heap image is invalid or truncated"); return false; }
+			const uint8_t* end = data + size;
+			GarbageCollector& GC = vm.GetGC();
+			uint64_t count = 0;
+			std::string name, className;
+
+			CHECK_READ(ReadVarint(data, end, count));
+			for (uint64_t i = 0; i < count; i++)
+			{
+				CHECK_READ(ReadString(data, end, name));
+				if (!vm.LoadDll(name))
+				{
+					DisplayError("cannot load library " + name + ", which was loaded when snapshot was created");
+					return false;
+				}
+			}
+
+			// objects are allocated first, then references between them are relocated by object indices
+			std::vector<BaseObject*> restored;
+			std::vector<Relocation> relocations;
+			uint64_t objectCount = 0;
+			CHECK_READ(ReadVarint(data, end, objectCount) && objectCount <= size);
+			restored.reserve(static_cast<size_t>(objectCount));
+			for (uint64_t i = 0; i < objectCount; i++)
+			{
+				CHECK_READ(data != end);
+				Type type = static_cast<Type>(*data++);
+				uint64_t value = 0;
+				switch (type)
+				{
+				case Type::CLASS_OBJECT:
+				{
+					CHECK_READ(ReadString(data, end, name) && ReadString(data, end, className));
+					const ClassType* _class = vm.GetClassOrNull(name, className);
+					if (_class == nullptr)
+					{
+						DisplayError("class " + name + '.' + className + " of snapshot object was not found");
+						return false;
+					}
+					ClassObject* object = GC.classObjAlloc.Alloc(_class);
+					CHECK_READ(ReadVarint(data, end, count) && count <= size);
+					object->attributes.reserve(static_cast<size_t>(count));
+					for (uint64_t j = 0; j < count; j++)
+					{
+						CHECK_READ(ReadString(data, end, name) && ReadVarint(data, end, value));
+						const auto* attributes = _class->objectAttributes.count(name) ? &_class->objectAttributes : &_class->staticAttributes;
+						auto attributeType = attributes->find(name);
+						if (attributeType == attributes->end())
+						{
+							DisplayError("attribute " + name + " of class " + className + " was not found");
+							return false;
+						}
+						AttributeObject* attribute = GC.attributeAlloc.Alloc(&attributeType->second);
+						object->attributes[name] = attribute;
+						relocations.push_back({ &attribute->object, static_cast<size_t>(value) });
+					}
+					restored.push_back(object);
+					break;
+				}
+				case Type::INTEGER:
+					CHECK_READ(ReadString(data, end, name));
+					restored.push_back(vm.AllocInteger(name));
+					break;
+				case Type::FLOAT:
+				{
+					FloatObject::InnerType floatValue;
+					CHECK_READ(static_cast<size_t>(end - data) >= sizeof(floatValue));
+					std::memcpy(&floatValue, data, sizeof(floatValue));
+					data += sizeof(floatValue);
+					restored.push_back(vm.AllocFloat(floatValue));
+					break;
+				}
+				case Type::STRING:
+					CHECK_READ(ReadString(data, end, name));
+					restored.push_back(vm.AllocString(name));
+					break;
+				case Type::NAMESPACE:
+				{
+					CHECK_READ(ReadString(data, end, name));
+					const NamespaceType* ns = vm.GetNamespaceOrNull(name);
+					CHECK_READ(ns != nullptr && ns->wrapper != nullptr);
+					restored.push_back(ns->wrapper);
+					break;
+				}
+				case Type::CLASS:
+				{
+					CHECK_READ(ReadString(data, end, name) && ReadString(data, end, className));
+					const ClassType* _class = vm.GetClassOrNull(name, className);
+					CHECK_READ(_class != nullptr && _class->wrapper != nullptr);
+					restored.push_back(_class->wrapper);
+					break;
+				}
+				case Type::BASE:
+				{
+					CHECK_READ(ReadVarint(data, end, count) && count <= size);
+					ArrayObject* array = GC.arrayAlloc.Alloc(static_cast<size_t>(count));
+					for (Local& element : array->array)
+					{
+						CHECK_READ(ReadVarint(data, end, value) && data != end);
+						element.isConst = (*data & 1) != 0;
+						element.isElement = (*data & 2) != 0;
+						data++;
+						relocations.push_back({ &element.object, static_cast<size_t>(value) });
+					}
+					restored.push_back(array);
+					break;
+				}
+				case Type::NULLPTR:
+					restored.push_back(vm.AllocNull());
+					break;
+				case Type::TRUE:
+					restored.push_back(vm.AllocTrue());
+					break;
+				case Type::FALSE:
+					restored.push_back(vm.AllocFalse());
+					break;
+				default:
+					CHECK_READ(false);
+				}
+			}
+			for (const Relocation& relocation : relocations)
+			{
+				CHECK_READ(relocation.index < restored.size());
+				*relocation.slot = restored[relocation.index];
+			}
+
+			CHECK_READ(ReadVarint(data, end, count));
+			for (uint64_t i = 0; i < count; i++)
+			{
+				uint64_t instance = 0;
+				CHECK_READ(ReadString(data, end, name) && ReadString(data, end, className) && data != end);
+				bool staticConstructorCalled = *data++ != 0;
+				CHECK_READ(ReadVarint(data, end, instance) && instance <= restored.size());
+				const ClassType* _class = vm.GetClassOrNull(name, className);
+				if (_class == nullptr)
+				{
+					DisplayError("class " + name + '.' + className + " of snapshot static state was not found");
+					return false;
+				}
+				_class->staticConstructorCalled = staticConstructorCalled;
+				if (instance != 0)
+				{
+					BaseObject* staticInstance = restored[static_cast<size_t>(instance - 1)];
+					CHECK_READ(staticInstance->type == Type::CLASS_OBJECT && static_cast<ClassObject*>(staticInstance)->typeInstance == _class);
+					_class->staticInstance = static_cast<ClassObject*>(staticInstance);
+				}
+			}
+			CHECK_READ(data == end);
+			#undef CHECK_READ
+			return true;
+		}
+	}
+}
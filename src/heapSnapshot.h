@@ -0,0 +1,50 @@
+#pragma once
+
+#include "objects.h"
+#include <ostream>
+#include <vector>
+#include <unordered_map>
+
+namespace MSL
+{
+	namespace VM
+	{
+		class VirtualMachine;
+
+		/*
+		static state of initialized VM, written to snapshot after its assembly (see MSL snapshot command)
+		objects reachable from static attributes are stored by index, so references between them are relocated to new objects when state is restored
+		static constructors which were called are not called again, libraries they loaded are loaded again, as handles are local to process
+		*/
+		class HeapSnapshot
+		{
+			VirtualMachine& vm;
+			std::ostream* errorStream;
+			std::unordered_map<const BaseObject*, size_t> objectIndices;
+			std::vector<const BaseObject*> objects;
+
+			/*
+			reference of restored object to object by its index, it is set when all objects are allocated
+			*/
+			struct Relocation
+			{
+				BaseObject** slot;
+				size_t index;
+			};
+
+			size_t AddObject(const BaseObject* object);
+			bool WriteObject(const BaseObject* object, std::ostream& out);
+			void DisplayError(const std::string& message) const;
+		public:
+			HeapSnapshot(VirtualMachine& vm, std::ostream* errorStream);
+			/*
+			writes libraries loaded by VM, objects reachable from static state of classes and state of classes. Returns false if some object cannot be stored
+			*/
+			bool Write(std::ostream& out);
+			/*
+			restores state written by Write() to VM which has the same assembly and is not running yet. Returns false if state is invalid
+			*/
+			bool Restore(const uint8_t* data, size_t size);
+		};
+	}
+}
@@ -0,0 +1,1042 @@
+#include "jitCompiler.h"
+#include "virtualMachine.h"
+
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+#undef ERROR
+#undef CONST
+#undef THIS
+#undef TRUE
+#undef FALSE
+#undef IN
+#undef OUT
+#undef min
+#undef max
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+
+// unwind information of native code is registered in unwinder of libgcc as .eh_frame section
+extern "C" void __register_frame(void* begin);
+extern "C" void __deregister_frame(void* begin);
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define MSL_JIT_X64
+#endif
+
+namespace MSL
+{
+	namespace VM
+	{
+		/*
+		x86-64 machine code writer. Only instructions used by JitCompiler are supported
+		*/
+		class X64Emitter
+		{
+			std::vector<uint8_t> code;
+		public:
+			size_t Size() const
+			{
+				return code.size();
+			}
+
+			const std::vector<uint8_t>& GetCode() const
+			{
+				return code;
+			}
+
+			void Write(std::initializer_list<uint8_t> bytes)
+			{
+				code.insert(code.end(), bytes);
+			}
+
+			template<typename T>
+			void WriteValue(T value)
+			{
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+				code.insert(code.end(), bytes, bytes + sizeof(T));
+			}
+
+			/*
+			writes rel32 operand of jump and returns its position for Patch() call
+			*/
+			size_t WriteRel32()
+			{
+				size_t position = code.size();
+				WriteValue<int32_t>(0);
+				return position;
+			}
+
+			void Patch(size_t position, size_t target)
+			{
+				int32_t rel32 = static_cast<int32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(position + sizeof(int32_t)));
+				std::memcpy(&code[position], &rel32, sizeof(int32_t));
+			}
+
+			void PatchValue(size_t position, uint32_t value)
+			{
+				std::memcpy(&code[position], &value, sizeof(uint32_t));
+			}
+
+			void Align(size_t alignment)
+			{
+				while (code.size() % alignment != 0)
+					code.push_back(0xCC); // int3, never executed
+			}
+
+			/*
+			writes jump with rel32 operand (jmp or jcc) and returns its position for Patch() call
+			*/
+			size_t WriteJump(std::initializer_list<uint8_t> opcode)
+			{
+				Write(opcode);
+				return WriteRel32();
+			}
+
+			/*
+			writes call of runtime helper with vm, frame and instruction arguments. vm and frame are kept in rbx and r12 by native code
+			*/
+			void WriteHelperCall(JitCompiler::Helper helper, const JitMethod::Instruction* instruction);
+			/*
+			writes jump to position returned for Patch() call if VM errors are set
+			*/
+			size_t WriteErrorCheck(int32_t errorsOffset);
+		};
+
+		#ifdef _WIN32
+		// Microsoft x64 calling convention: arguments are passed in rcx, rdx, r8
+		#define X64_MOV_RBX_ARG0 0x48, 0x89, 0xCB // mov rbx, rcx
+		#define X64_MOV_R12_ARG1 0x49, 0x89, 0xD4 // mov r12, rdx
+		#define X64_JMP_ARG2     0x41, 0xFF, 0xE0 // jmp r8
+		#define X64_MOV_ARG0_RBX 0x48, 0x89, 0xD9 // mov rcx, rbx
+		#define X64_MOV_ARG1_R12 0x4C, 0x89, 0xE2 // mov rdx, r12
+		#define X64_MOV_ARG2_IMM 0x49, 0xB8       // mov r8, imm64
+		#else
+		// System V calling convention: arguments are passed in rdi, rsi, rdx
+		#define X64_MOV_RBX_ARG0 0x48, 0x89, 0xFB // mov rbx, rdi
+		#define X64_MOV_R12_ARG1 0x49, 0x89, 0xF4 // mov r12, rsi
+		#define X64_JMP_ARG2     0xFF, 0xE2       // jmp rdx
+		#define X64_MOV_ARG0_RBX 0x48, 0x89, 0xDF // mov rdi, rbx
+		#define X64_MOV_ARG1_R12 0x4C, 0x89, 0xE6 // mov rsi, r12
+		#define X64_MOV_ARG2_IMM 0x48, 0xBA       // mov rdx, imm64
+		#endif
+
+		void X64Emitter::WriteHelperCall(JitCompiler::Helper helper, const JitMethod::Instruction* instruction)
+		{
+			Write({ X64_MOV_ARG0_RBX });
+			Write({ X64_MOV_ARG1_R12 });
+			Write({ X64_MOV_ARG2_IMM });
+			WriteValue(reinterpret_cast<uint64_t>(instruction));
+			Write({ 0x48, 0xB8 }); // mov rax, imm64
+			WriteValue(reinterpret_cast<uint64_t>(helper));
+			Write({ 0xFF, 0xD0 }); // call rax
+		}
+
+		size_t X64Emitter::WriteErrorCheck(int32_t errorsOffset)
+		{
+			Write({ 0x83, 0xBB }); // cmp dword [rbx + disp32], 0
+			WriteValue(errorsOffset);
+			Write({ 0x00 });
+			return WriteJump({ 0x0F, 0x85 }); // jne rel32
+		}
+
+		/*
+		writes unwind information of native code after it and returns its offset. Prologue pushes rbx and r12 and reserves 40 bytes of stack,
+		which are not changed until epilogue, so helpers called by native code can throw exceptions unwound through it (see JitMethod::Enter)
+		*/
+		static size_t WriteUnwindInfo(X64Emitter& emitter, size_t codeSize)
+		{
+			#ifdef _WIN32
+			// RUNTIME_FUNCTION with addresses relative to the code start, followed by UNWIND_INFO
+			emitter.Align(sizeof(uint32_t));
+			size_t offset = emitter.Size();
+			emitter.WriteValue<uint32_t>(0);
+			emitter.WriteValue(static_cast<uint32_t>(codeSize));
+			emitter.WriteValue(static_cast<uint32_t>(offset + 3 * sizeof(uint32_t)));
+			emitter.Write({ 0x01, 0x07, 0x03, 0x00 }); // version 1, prologue size 7, 3 unwind codes, no frame register
+			emitter.Write({ 0x07, 0x42 }); // sub rsp, 40: UWOP_ALLOC_SMALL (40 - 8) / 8
+			emitter.Write({ 0x03, 0xC0 }); // push r12: UWOP_PUSH_NONVOL
+			emitter.Write({ 0x01, 0x30 }); // push rbx: UWOP_PUSH_NONVOL
+			emitter.Write({ 0x00, 0x00 }); // unwind codes are padded to even count
+			return offset;
+			#else
+			// .eh_frame section with one CIE and one FDE, terminated by zero length
+			emitter.Align(sizeof(uint64_t));
+			size_t cie = emitter.Size();
+			emitter.WriteValue<uint32_t>(20); // length
+			emitter.WriteValue<uint32_t>(0); // CIE id
+			emitter.Write({ 0x01, 'z', 'R', 0x00 }); // version 1, augmentation "zR"
+			emitter.Write({ 0x01, 0x78, 0x10 }); // code alignment 1, data alignment -8, return address in column 16
+			emitter.Write({ 0x01, 0x1B }); // augmentation data: FDE addresses are pc-relative sdata4
+			emitter.Write({ 0x0C, 0x07, 0x08 }); // DW_CFA_def_cfa: rsp + 8
+			emitter.Write({ 0x90, 0x01 }); // DW_CFA_offset: return address at cfa - 8
+			emitter.Write({ 0x00, 0x00 }); // DW_CFA_nop padding
+
+			size_t fde = emitter.Size();
+			emitter.WriteValue<uint32_t>(28); // length
+			emitter.WriteValue(static_cast<uint32_t>(emitter.Size() - cie)); // offset of CIE
+			emitter.WriteValue(static_cast<int32_t>(-static_cast<int64_t>(emitter.Size()))); // code start
+			emitter.WriteValue(static_cast<uint32_t>(codeSize));
+			emitter.Write({ 0x00 }); // no augmentation data
+			emitter.Write({ 0x41, 0x0E, 0x10, 0x83, 0x02 }); // after push rbx: cfa = rsp + 16, rbx at cfa - 16
+			emitter.Write({ 0x42, 0x0E, 0x18, 0x8C, 0x03 }); // after push r12: cfa = rsp + 24, r12 at cfa - 24
+			emitter.Write({ 0x44, 0x0E, 0x40 }); // after sub rsp, 40: cfa = rsp + 64
+			emitter.Write({ 0x00, 0x00 }); // DW_CFA_nop padding
+			emitter.PatchValue(fde, static_cast<uint32_t>(emitter.Size() - fde - sizeof(uint32_t)));
+			emitter.WriteValue<uint32_t>(0); // terminator
+			return cie;
+			#endif
+		}
+
+		static bool RegisterUnwindInfo(uint8_t* code, size_t offset)
+		{
+			#ifdef _WIN32
+			return RtlAddFunctionTable(reinterpret_cast<PRUNTIME_FUNCTION>(code + offset), 1, reinterpret_cast<DWORD64>(code)) != FALSE;
+			#else
+			__register_frame(code + offset);
+			return true;
+			#endif
+		}
+
+		static void DeregisterUnwindInfo(uint8_t* code, size_t offset)
+		{
+			#ifdef _WIN32
+			RtlDeleteFunctionTable(reinterpret_cast<PRUNTIME_FUNCTION>(code + offset));
+			#else
+			__deregister_frame(code + offset);
+			#endif
+		}
+
+		/*
+		returns size of instruction operands in bytes or false if opcode cannot be compiled
+		*/
+		static bool GetOperandSize(OPCODE op, size_t& size)
+		{
+			switch (op)
+			{
+			case OPCODE::PUSH_OBJECT:
+			case OPCODE::PUSH_STRING:
+			case OPCODE::PUSH_INTEGER:
+			case OPCODE::PUSH_FLOAT:
+			case OPCODE::ALLOC_VAR:
+			case OPCODE::ALLOC_CONST_VAR:
+			case OPCODE::GET_MEMBER:
+			case OPCODE::LOAD_LOCAL:
+			case OPCODE::STORE_LOCAL:
+				size = sizeof(size_t);
+				return true;
+			case OPCODE::CALL_FUNCTION:
+			case OPCODE::CALL_METHOD:
+			case OPCODE::TAIL_CALL:
+				size = sizeof(size_t) + sizeof(uint8_t);
+				return true;
+			case OPCODE::ITER_INIT:
+				size = 2 * sizeof(size_t);
+				return true;
+			case OPCODE::ITER_NEXT:
+				size = 3 * sizeof(size_t) + sizeof(uint16_t);
+				return true;
+			case OPCODE::SET_LABEL:
+			case OPCODE::JUMP:
+			case OPCODE::JUMP_IF_TRUE:
+			case OPCODE::JUMP_IF_FALSE:
+			case OPCODE::JUMP_IF_TRUE_KEEP:
+			case OPCODE::JUMP_IF_FALSE_KEEP:
+			case OPCODE::PUSH_CATCH:
+				size = sizeof(uint16_t);
+				return true;
+			case OPCODE::PUSH_THIS:
+			case OPCODE::PUSH_NULL:
+			case OPCODE::PUSH_TRUE:
+			case OPCODE::PUSH_FALSE:
+			case OPCODE::POP_TO_RETURN:
+			case OPCODE::RETURN:
+			case OPCODE::POP_STACK_TOP:
+			case OPCODE::POP_CATCH:
+			case OPCODE::SET_ALU_INCR:
+			case OPCODE::GET_INDEX:
+			case OPCODE::NEGATION_OP:
+			case OPCODE::NEGATIVE_OP:
+			case OPCODE::POSITIVE_OP:
+			case OPCODE::SUM_OP:
+			case OPCODE::SUB_OP:
+			case OPCODE::MULT_OP:
+			case OPCODE::DIV_OP:
+			case OPCODE::MOD_OP:
+			case OPCODE::POWER_OP:
+			case OPCODE::CMP_EQ:
+			case OPCODE::CMP_NEQ:
+			case OPCODE::CMP_L:
+			case OPCODE::CMP_G:
+			case OPCODE::CMP_LE:
+			case OPCODE::CMP_GE:
+			case OPCODE::CMP_AND:
+			case OPCODE::CMP_OR:
+			case OPCODE::ASSIGN_OP:
+			case OPCODE::SUM_INT:
+			case OPCODE::SUB_INT:
+			case OPCODE::MULT_INT:
+			case OPCODE::CMP_EQ_INT:
+			case OPCODE::CMP_NEQ_INT:
+			case OPCODE::CMP_L_INT:
+			case OPCODE::CMP_G_INT:
+			case OPCODE::CMP_LE_INT:
+			case OPCODE::CMP_GE_INT:
+			case OPCODE::SUM_FLOAT:
+			case OPCODE::SUB_FLOAT:
+			case OPCODE::MULT_FLOAT:
+			case OPCODE::DIV_FLOAT:
+			case OPCODE::CMP_L_FLOAT:
+			case OPCODE::CMP_G_FLOAT:
+			case OPCODE::CMP_LE_FLOAT:
+			case OPCODE::CMP_GE_FLOAT:
+			case OPCODE::SUM_STRING:
+				size = 0;
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		/*
+		returns true if instruction operand is a dependency hash
+		*/
+		static bool HasHashOperand(OPCODE op)
+		{
+			switch (op)
+			{
+			case OPCODE::PUSH_OBJECT:
+			case OPCODE::PUSH_STRING:
+			case OPCODE::PUSH_INTEGER:
+			case OPCODE::PUSH_FLOAT:
+			case OPCODE::ALLOC_VAR:
+			case OPCODE::ALLOC_CONST_VAR:
+			case OPCODE::LOAD_LOCAL:
+			case OPCODE::GET_MEMBER:
+			case OPCODE::CALL_FUNCTION:
+			case OPCODE::CALL_METHOD:
+			case OPCODE::TAIL_CALL:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		/*
+		returns type of operands of integer and float ALU instruction, which is checked by native code, or Type::BASE for other instructions
+		*/
+		static Type GetGuardedType(OPCODE op)
+		{
+			OPCODE generic = ToGenericOpcode(op);
+			if (generic == op) return Type::BASE;
+			if (ToIntegerOpcode(generic) == op) return Type::INTEGER;
+			if (ToFloatOpcode(generic) == op) return Type::FLOAT;
+			return Type::BASE;
+		}
+
+		bool JitCompiler::IsNop(OPCODE op)
+		{
+			return op == OPCODE::SET_LABEL || op == OPCODE::PUSH_CATCH || op == OPCODE::POP_CATCH;
+		}
+
+		bool JitCompiler::IsConditionalJump(OPCODE op)
+		{
+			switch (op)
+			{
+			case OPCODE::JUMP_IF_TRUE:
+			case OPCODE::JUMP_IF_FALSE:
+			case OPCODE::JUMP_IF_TRUE_KEEP:
+			case OPCODE::JUMP_IF_FALSE_KEEP:
+			case OPCODE::ITER_NEXT:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		static uint8_t* AllocExecutableMemory(const std::vector<uint8_t>& code, size_t& allocatedSize)
+		{
+			#ifdef _WIN32
+			allocatedSize = code.size();
+			void* memory = VirtualAlloc(nullptr, allocatedSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			if (memory == nullptr) return nullptr;
+			std::memcpy(memory, code.data(), code.size());
+			DWORD oldProtection;
+			if (!VirtualProtect(memory, allocatedSize, PAGE_EXECUTE_READ, &oldProtection))
+			{
+				VirtualFree(memory, 0, MEM_RELEASE);
+				return nullptr;
+			}
+			FlushInstructionCache(GetCurrentProcess(), memory, allocatedSize);
+			#else
+			size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+			allocatedSize = (code.size() + pageSize - 1) / pageSize * pageSize;
+			void* memory = mmap(nullptr, allocatedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (memory == MAP_FAILED) return nullptr;
+			std::memcpy(memory, code.data(), code.size());
+			if (mprotect(memory, allocatedSize, PROT_READ | PROT_EXEC) != 0)
+			{
+				munmap(memory, allocatedSize);
+				return nullptr;
+			}
+			#endif
+			return static_cast<uint8_t*>(memory);
+		}
+
+		constexpr uint32_t JitMethod::NO_ENTRY; // odr-used by std::vector::assign, which takes value by reference
+
+		const uint8_t* JitMethod::GetEntry(size_t offset) const
+		{
+			if (offset >= entries.size() || entries[offset] == NO_ENTRY) return nullptr;
+			return code + entries[offset];
+		}
+
+		int JitMethod::Enter(VirtualMachine* vm, Frame* frame, const uint8_t* entry) const
+		{
+			EntryFunction function = reinterpret_cast<EntryFunction>(code);
+			return function(vm, frame, entry);
+		}
+
+		JitMethod::~JitMethod()
+		{
+			if (code == nullptr) return;
+			#ifdef MSL_JIT_X64
+			if (unwindInfoOffset != 0)
+				DeregisterUnwindInfo(code, unwindInfoOffset);
+			#endif
+			#ifdef _WIN32
+			VirtualFree(code, 0, MEM_RELEASE);
+			#else
+			munmap(code, allocatedSize);
+			#endif
+		}
+
+		bool JitCompiler::Decode(const MethodType* method, std::vector<JitMethod::Instruction>& instructions)
+		{
+			// operands are validated here, so helpers can use them directly
+			const auto& body = method->body;
+			std::vector<bool> isInstructionStart(body.size() + 1, false);
+			size_t offset = 0;
+			while (offset < body.size())
+			{
+				JitMethod::Instruction instruction;
+				instruction.op = static_cast<OPCODE>(body[offset]);
+				size_t operandSize = 0;
+				if (!GetOperandSize(instruction.op, operandSize) || offset + 1 + operandSize > body.size())
+					return false;
+
+				instruction.offset = offset;
+				instruction.next = offset + 1 + operandSize;
+				if (HasHashOperand(instruction.op))
+				{
+					std::memcpy(&instruction.operand, &body[offset + 1], sizeof(size_t));
+					if (instruction.operand >= method->dependencies.size())
+						return false;
+				}
+				else if (instruction.op == OPCODE::JUMP || IsConditionalJump(instruction.op))
+				{
+					// label is the last operand of jump instructions
+					uint16_t label;
+					std::memcpy(&label, &body[instruction.next - sizeof(uint16_t)], sizeof(uint16_t));
+					if (label >= method->labels.size())
+						return false;
+					instruction.operand = method->labels[label];
+				}
+				instruction.helper = GetHelper(instruction.op);
+				instructions.push_back(instruction);
+				isInstructionStart[offset] = true;
+				offset = instruction.next;
+			}
+			// method end is an instruction which is left to interpreter, so jumps to it are resolved
+			JitMethod::Instruction end;
+			end.offset = end.next = body.size();
+			instructions.push_back(end);
+			isInstructionStart[body.size()] = true;
+
+			// jump target which is not an instruction start is treated as invalid bytecode
+			for (const JitMethod::Instruction& instruction : instructions)
+			{
+				bool isJump = instruction.op == OPCODE::JUMP || IsConditionalJump(instruction.op);
+				if (isJump && (instruction.operand > body.size() || !isInstructionStart[instruction.operand]))
+					return false;
+			}
+			return true;
+		}
+
+		void JitCompiler::ResolveLayout(const VirtualMachine* vm)
+		{
+			if (layout.resolved) return;
+			const uint8_t* base = reinterpret_cast<const uint8_t*>(vm);
+			layout.errors = static_cast<int32_t>(reinterpret_cast<const uint8_t*>(&vm->errors) - base);
+
+			// pointers of object stack are found by their values in a vector of the same type
+			VirtualMachine::ObjectStack probe;
+			probe.reserve(4);
+			probe.resize(2);
+			uintptr_t words[sizeof(probe) / sizeof(uintptr_t)];
+			std::memcpy(words, &probe, sizeof(words));
+			int32_t stackOffset = static_cast<int32_t>(reinterpret_cast<const uint8_t*>(&vm->objectStack) - base);
+			for (size_t i = 0; i < sizeof(words) / sizeof(uintptr_t); i++)
+			{
+				if (words[i] == reinterpret_cast<uintptr_t>(probe.data()))
+					layout.stackBegin = stackOffset + static_cast<int32_t>(i * sizeof(uintptr_t));
+				if (words[i] == reinterpret_cast<uintptr_t>(probe.data() + probe.size()))
+					layout.stackEnd = stackOffset + static_cast<int32_t>(i * sizeof(uintptr_t));
+			}
+
+			NullObject object;
+			const BaseObject* objectBase = &object;
+			layout.type = static_cast<int32_t>(reinterpret_cast<const uint8_t*>(&objectBase->type) - reinterpret_cast<const uint8_t*>(objectBase));
+			layout.resolved = true;
+		}
+
+		const JitMethod* JitCompiler::Compile(const VirtualMachine* vm, const MethodType* method, const std::string& name, bool writePerfMap)
+		{
+			#ifndef MSL_JIT_X64
+			return nullptr;
+			#else
+			if (rejected.find(method) != rejected.end()) return nullptr;
+			ResolveLayout(vm);
+
+			std::unique_ptr<JitMethod> jitMethod = std::make_unique<JitMethod>();
+			const auto& body = method->body;
+			if (!Decode(method, jitMethod->instructions))
+			{
+				rejected.insert(method);
+				return nullptr;
+			}
+
+			X64Emitter emitter;
+			std::vector<size_t> leaveFixups;
+			std::vector<size_t> errorFixups;
+			std::vector<std::pair<size_t, size_t>> jumpFixups; // rel32 position, target offset in method body
+			jitMethod->entries.assign(body.size() + 1, JitMethod::NO_ENTRY);
+			std::vector<size_t> nativeOffsets(body.size() + 1, JitMethod::NO_ENTRY);
+			const bool canGuardTypes = layout.stackBegin >= 0 && layout.stackEnd >= 0;
+
+			// prologue: vm and frame are kept in callee-saved rbx and r12 during all helper calls
+			emitter.Write({ 0x53 }); // push rbx
+			emitter.Write({ 0x41, 0x54 }); // push r12
+			emitter.Write({ 0x48, 0x83, 0xEC, 0x28 }); // sub rsp, 40 (stack alignment and shadow space)
+			emitter.Write({ X64_MOV_RBX_ARG0 });
+			emitter.Write({ X64_MOV_R12_ARG1 });
+			emitter.Write({ X64_JMP_ARG2 }); // jump to entry instruction
+
+			for (const JitMethod::Instruction& instruction : jitMethod->instructions)
+			{
+				nativeOffsets[instruction.offset] = emitter.Size();
+				if (IsNop(instruction.op))
+				{
+					jitMethod->entries[instruction.offset] = static_cast<uint32_t>(emitter.Size());
+					continue;
+				}
+				if (instruction.op == OPCODE::JUMP)
+				{
+					jitMethod->entries[instruction.offset] = static_cast<uint32_t>(emitter.Size());
+					jumpFixups.push_back({ emitter.WriteJump({ 0xE9 }), instruction.operand }); // jmp rel32
+					continue;
+				}
+				if (instruction.helper == nullptr)
+				{
+					emitter.WriteHelperCall(Interpret, &instruction);
+					leaveFixups.push_back(emitter.WriteJump({ 0xE9 })); // jmp rel32
+					continue;
+				}
+				jitMethod->entries[instruction.offset] = static_cast<uint32_t>(emitter.Size());
+
+				Type guardedType = GetGuardedType(instruction.op);
+				if (guardedType != Type::BASE && canGuardTypes)
+				{
+					// operands are checked here, so fast helper only computes result. Otherwise TypedALU performs generic ALU call
+					std::vector<size_t> slowFixups;
+					emitter.Write({ 0x48, 0x8B, 0x83 }); // mov rax, [rbx + stackEnd]
+					emitter.WriteValue(layout.stackEnd);
+					emitter.Write({ 0x48, 0x8B, 0x8B }); // mov rcx, [rbx + stackBegin]
+					emitter.WriteValue(layout.stackBegin);
+					emitter.Write({ 0x48, 0x83, 0xC1, 0x10 }); // add rcx, 16
+					emitter.Write({ 0x48, 0x39, 0xC8 }); // cmp rax, rcx
+					slowFixups.push_back(emitter.WriteJump({ 0x0F, 0x82 })); // jb rel32: less than two objects in stack
+					for (uint8_t displacement : { 0xF8, 0xF0 })
+					{
+						emitter.Write({ 0x48, 0x8B, 0x48, displacement }); // mov rcx, [rax - 8] / [rax - 16]
+						emitter.Write({ 0x80, 0xB9 }); // cmp byte [rcx + type], imm8
+						emitter.WriteValue(layout.type);
+						emitter.Write({ static_cast<uint8_t>(guardedType) });
+						slowFixups.push_back(emitter.WriteJump({ 0x0F, 0x85 })); // jne rel32
+					}
+					emitter.WriteHelperCall(guardedType == Type::INTEGER ? IntegerALU : FloatALU, &instruction);
+					size_t done = emitter.WriteJump({ 0xE9 }); // jmp rel32
+					for (size_t position : slowFixups)
+					{
+						emitter.Patch(position, emitter.Size());
+					}
+					emitter.WriteHelperCall(instruction.helper, &instruction);
+					emitter.Patch(done, emitter.Size());
+				}
+				else
+				{
+					emitter.WriteHelperCall(instruction.helper, &instruction);
+				}
+
+				if (IsConditionalJump(instruction.op))
+				{
+					errorFixups.push_back(emitter.WriteErrorCheck(layout.errors));
+					emitter.Write({ 0x83, 0xF8, static_cast<uint8_t>(BRANCH) }); // cmp eax, BRANCH
+					jumpFixups.push_back({ emitter.WriteJump({ 0x0F, 0x84 }), instruction.operand }); // je rel32
+					leaveFixups.push_back(emitter.WriteJump({ 0x0F, 0x8F })); // jg rel32
+				}
+				else
+				{
+					// status is checked first, as method may be returned after error
+					emitter.Write({ 0x85, 0xC0 }); // test eax, eax
+					leaveFixups.push_back(emitter.WriteJump({ 0x0F, 0x85 })); // jnz rel32
+					errorFixups.push_back(emitter.WriteErrorCheck(layout.errors));
+				}
+			}
+
+			// native code is left with LEAVE status on errors and with status of the last helper otherwise
+			size_t errorExit = emitter.Size();
+			emitter.Write({ 0xB8 }); // mov eax, imm32
+			emitter.WriteValue<int32_t>(LEAVE);
+			size_t epilogue = emitter.Size();
+			emitter.Write({ 0x48, 0x83, 0xC4, 0x28 }); // add rsp, 40
+			emitter.Write({ 0x41, 0x5C }); // pop r12
+			emitter.Write({ 0x5B }); // pop rbx
+			emitter.Write({ 0xC3 }); // ret
+			size_t codeSize = emitter.Size();
+
+			for (size_t position : leaveFixups)
+			{
+				emitter.Patch(position, epilogue);
+			}
+			for (size_t position : errorFixups)
+			{
+				emitter.Patch(position, errorExit);
+			}
+			for (const auto& fixup : jumpFixups)
+			{
+				emitter.Patch(fixup.first, nativeOffsets[fixup.second]);
+			}
+			size_t unwindInfoOffset = WriteUnwindInfo(emitter, codeSize);
+
+			// native code is not executed if exceptions cannot be unwound through it
+			jitMethod->code = AllocExecutableMemory(emitter.GetCode(), jitMethod->allocatedSize);
+			if (jitMethod->code == nullptr || !RegisterUnwindInfo(jitMethod->code, unwindInfoOffset))
+			{
+				rejected.insert(method);
+				return nullptr;
+			}
+			jitMethod->unwindInfoOffset = unwindInfoOffset;
+			jitMethod->codeSize = codeSize;
+			if (writePerfMap)
+				WritePerfMap(*jitMethod, name);
+
+			methods.push_back(std::move(jitMethod));
+			return methods.back().get();
+			#endif
+		}
+
+		void JitCompiler::WritePerfMap(const JitMethod& method, const std::string& name) const
+		{
+			// perf map files are read by Linux `perf` only, on other platforms nothing is written
+			#ifndef _WIN32
+			std::ofstream perfMap("/tmp/perf-" + std::to_string(getpid()) + ".map", std::ios::app);
+			perfMap << std::hex << reinterpret_cast<uintptr_t>(method.code) << ' ' << method.codeSize << std::dec << " MSL::" << name << '\n';
+			#endif
+		}
+
+		JitCompiler::Helper JitCompiler::GetHelper(OPCODE op)
+		{
+			switch (op)
+			{
+			case OPCODE::PUSH_INTEGER:
+				return PushInteger;
+			case OPCODE::PUSH_FLOAT:
+				return PushFloat;
+			case OPCODE::PUSH_STRING:
+				return PushString;
+			case OPCODE::PUSH_OBJECT:
+				return PushObject;
+			case OPCODE::PUSH_THIS:
+			case OPCODE::PUSH_NULL:
+			case OPCODE::PUSH_TRUE:
+			case OPCODE::PUSH_FALSE:
+				return PushConstant;
+			case OPCODE::LOAD_LOCAL:
+				return LoadLocal;
+			case OPCODE::STORE_LOCAL:
+				return StoreLocal;
+			case OPCODE::ALLOC_VAR:
+			case OPCODE::ALLOC_CONST_VAR:
+				return AllocVar;
+			case OPCODE::POP_STACK_TOP:
+				return PopStackTop;
+			case OPCODE::SET_ALU_INCR:
+				return SetAluIncr;
+			case OPCODE::NEGATION_OP:
+			case OPCODE::NEGATIVE_OP:
+			case OPCODE::POSITIVE_OP:
+			case OPCODE::SUM_OP:
+			case OPCODE::SUB_OP:
+			case OPCODE::MULT_OP:
+			case OPCODE::DIV_OP:
+			case OPCODE::MOD_OP:
+			case OPCODE::POWER_OP:
+			case OPCODE::CMP_EQ:
+			case OPCODE::CMP_NEQ:
+			case OPCODE::CMP_L:
+			case OPCODE::CMP_G:
+			case OPCODE::CMP_LE:
+			case OPCODE::CMP_GE:
+			case OPCODE::CMP_AND:
+			case OPCODE::CMP_OR:
+			case OPCODE::ASSIGN_OP:
+				return GenericALU;
+			case OPCODE::SUM_INT:
+			case OPCODE::SUB_INT:
+			case OPCODE::MULT_INT:
+			case OPCODE::CMP_EQ_INT:
+			case OPCODE::CMP_NEQ_INT:
+			case OPCODE::CMP_L_INT:
+			case OPCODE::CMP_G_INT:
+			case OPCODE::CMP_LE_INT:
+			case OPCODE::CMP_GE_INT:
+			case OPCODE::SUM_FLOAT:
+			case OPCODE::SUB_FLOAT:
+			case OPCODE::MULT_FLOAT:
+			case OPCODE::DIV_FLOAT:
+			case OPCODE::CMP_L_FLOAT:
+			case OPCODE::CMP_G_FLOAT:
+			case OPCODE::CMP_LE_FLOAT:
+			case OPCODE::CMP_GE_FLOAT:
+			case OPCODE::SUM_STRING:
+				return TypedALU;
+			case OPCODE::JUMP_IF_TRUE:
+			case OPCODE::JUMP_IF_FALSE:
+				return JumpIf;
+			case OPCODE::JUMP_IF_TRUE_KEEP:
+			case OPCODE::JUMP_IF_FALSE_KEEP:
+				return JumpIfKeep;
+			case OPCODE::ITER_INIT:
+				return IterationInit;
+			case OPCODE::ITER_NEXT:
+				return IterationNext;
+			case OPCODE::GET_MEMBER:
+				return GetMember;
+			case OPCODE::CALL_FUNCTION:
+			case OPCODE::TAIL_CALL:
+				return CallFunction;
+			case OPCODE::CALL_METHOD:
+				return CallMethod;
+			case OPCODE::RETURN:
+			case OPCODE::POP_TO_RETURN:
+				return Return;
+			default: // indexing and exception handlers are executed by interpreter
+				return nullptr;
+			}
+		}
+
+		// each helper moves frame offset to the next instruction and collects garbage as interpreter loop does
+		// errors are not returned as status: native code checks them after each helper call
+		#define JIT_HELPER_BEGIN \
+			frame->offset = instruction->next; \
+			vm->CollectGarbage()
+
+		#define JIT_HELPER_END return CONTINUE
+
+		// helpers of instructions which can leave the frame return how interpreter must continue it
+		#define JIT_HELPER_FRAME_ACTION(action) \
+			switch (action) \
+			{ \
+			case VirtualMachine::FrameAction::RETURN: return RETURN; \
+			case VirtualMachine::FrameAction::TAIL_CALL: return TAIL_CALL; \
+			default: return CONTINUE; \
+			}
+
+		int JitCompiler::Interpret(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			frame->offset = instruction->offset;
+			return LEAVE;
+		}
+
+		int JitCompiler::PushInteger(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			size_t hash = instruction->operand;
+			if (!frame->integerCache.Has(hash))
+				frame->integerCache.Add(hash,
+					IntegerObject::InnerType(frame->_method->dependencies[hash])
+				);
+			vm->objectStack.push_back(vm->AllocInteger(frame->integerCache[hash]));
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::PushFloat(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			size_t hash = instruction->operand;
+			if (!frame->floatCache.Has(hash))
+				frame->floatCache.Add(hash,
+					FloatObject::InnerType(std::stod(frame->_method->dependencies[hash]))
+				);
+			vm->objectStack.push_back(vm->AllocFloat(frame->floatCache[hash]));
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::PushString(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			vm->objectStack.push_back(vm->AllocString(frame->_method->dependencies[instruction->operand]));
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::PushObject(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			vm->objectStack.push_back(vm->AllocUnknown(&frame->_method->dependencies[instruction->operand]));
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::PushConstant(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			switch (instruction->op)
+			{
+			case OPCODE::PUSH_THIS:
+				vm->objectStack.push_back(frame->classObject);
+				break;
+			case OPCODE::PUSH_TRUE:
+				vm->objectStack.push_back(vm->AllocTrue());
+				break;
+			case OPCODE::PUSH_FALSE:
+				vm->objectStack.push_back(vm->AllocFalse());
+				break;
+			default:
+				vm->objectStack.push_back(vm->AllocNull());
+				break;
+			}
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::LoadLocal(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			Local* local = vm->GetLocalSlot(frame, instruction->operand);
+			if (local != nullptr)
+				vm->objectStack.push_back(local->object);
+			else // local is not declared yet, name will be resolved as after PUSH_OBJECT
+				vm->objectStack.push_back(vm->AllocUnknown(&frame->_method->dependencies[instruction->operand]));
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::StoreLocal(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			frame->offset = instruction->offset + 1; // operands are decoded by VM
+			vm->PerformStoreLocal(frame);
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::AllocVar(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			const std::string& name = frame->_method->dependencies[instruction->operand];
+			bool isConst = instruction->op == OPCODE::ALLOC_CONST_VAR;
+			vm->objectStack.push_back(vm->AllocLocal(name, frame->locals[name] = { vm->AllocNull(), isConst }));
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::PopStackTop(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			if (vm->objectStack.empty()) return Interpret(vm, frame, instruction); // error is reported by interpreter
+			JIT_HELPER_BEGIN;
+			vm->objectStack.pop_back();
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::SetAluIncr(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			vm->AluIncrMode = true;
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::GenericALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			bool isUnary = instruction->op == OPCODE::NEGATION_OP || instruction->op == OPCODE::NEGATIVE_OP || instruction->op == OPCODE::POSITIVE_OP;
+			vm->PerformALUCall(instruction->op, isUnary ? 1 : 2, frame);
+			JIT_HELPER_END;
+		}
+
+		#define BOOLEAN_RESULT(predicate) ((predicate) ? static_cast<BaseObject*>(vm->AllocTrue()) : vm->AllocFalse())
+		/*
+		computes result of integer ALU instruction. Operand types are checked by caller
+		*/
+		static BaseObject* ComputeInteger(VirtualMachine* vm, OPCODE op, const IntegerObject::InnerType& lhs, const IntegerObject::InnerType& rhs)
+		{
+			switch (op)
+			{
+			case OPCODE::SUM_INT: return vm->AllocInteger(lhs + rhs);
+			case OPCODE::SUB_INT: return vm->AllocInteger(lhs - rhs);
+			case OPCODE::MULT_INT: return vm->AllocInteger(lhs * rhs);
+			case OPCODE::CMP_EQ_INT: return BOOLEAN_RESULT(lhs == rhs);
+			case OPCODE::CMP_NEQ_INT: return BOOLEAN_RESULT(lhs != rhs);
+			case OPCODE::CMP_L_INT: return BOOLEAN_RESULT(lhs < rhs);
+			case OPCODE::CMP_G_INT: return BOOLEAN_RESULT(lhs > rhs);
+			case OPCODE::CMP_LE_INT: return BOOLEAN_RESULT(lhs <= rhs);
+			default: return BOOLEAN_RESULT(lhs >= rhs);
+			}
+		}
+
+		/*
+		computes result of float ALU instruction. Operand types are checked by caller
+		*/
+		static BaseObject* ComputeFloat(VirtualMachine* vm, OPCODE op, FloatObject::InnerType lhs, FloatObject::InnerType rhs)
+		{
+			switch (op)
+			{
+			case OPCODE::SUM_FLOAT: return vm->AllocFloat(lhs + rhs);
+			case OPCODE::SUB_FLOAT: return vm->AllocFloat(lhs - rhs);
+			case OPCODE::MULT_FLOAT: return vm->AllocFloat(lhs * rhs);
+			case OPCODE::DIV_FLOAT: return vm->AllocFloat(lhs / rhs);
+			case OPCODE::CMP_L_FLOAT: return BOOLEAN_RESULT(lhs < rhs);
+			case OPCODE::CMP_G_FLOAT: return BOOLEAN_RESULT(lhs > rhs);
+			case OPCODE::CMP_LE_FLOAT: return BOOLEAN_RESULT(lhs <= rhs);
+			default: return BOOLEAN_RESULT(lhs >= rhs);
+			}
+		}
+		#undef BOOLEAN_RESULT
+
+		int JitCompiler::TypedALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			OPCODE op = instruction->op;
+			Type type = GetGuardedType(op);
+			if (type == Type::BASE) type = Type::STRING;
+
+			auto& stack = vm->objectStack;
+			const size_t size = stack.size();
+			// native code is not rewritten, so guard failure only results in generic ALU call
+			if (size < 2 || stack[size - 1]->type != type || stack[size - 2]->type != type)
+			{
+				vm->PerformALUCall(ToGenericOpcode(op), 2, frame);
+				JIT_HELPER_END;
+			}
+			BaseObject* result = nullptr;
+			if (type == Type::INTEGER)
+				result = ComputeInteger(vm, op, static_cast<IntegerObject*>(stack[size - 2])->value, static_cast<IntegerObject*>(stack[size - 1])->value);
+			else if (type == Type::FLOAT)
+				result = ComputeFloat(vm, op, static_cast<FloatObject*>(stack[size - 2])->value, static_cast<FloatObject*>(stack[size - 1])->value);
+			else
+				result = vm->AllocString(static_cast<StringObject*>(stack[size - 2])->value + static_cast<StringObject*>(stack[size - 1])->value);
+			stack.pop_back();
+			stack.back() = result;
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::IntegerALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			auto& stack = vm->objectStack;
+			BaseObject* result = ComputeInteger(vm, instruction->op, static_cast<IntegerObject*>(stack[stack.size() - 2])->value, static_cast<IntegerObject*>(stack.back())->value);
+			stack.pop_back();
+			stack.back() = result;
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::FloatALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			auto& stack = vm->objectStack;
+			BaseObject* result = ComputeFloat(vm, instruction->op, static_cast<FloatObject*>(stack[stack.size() - 2])->value, static_cast<FloatObject*>(stack.back())->value);
+			stack.pop_back();
+			stack.back() = result;
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::JumpIf(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			// only Boolean and null conditions are checked here, references and class objects are converted by interpreter
+			if (vm->objectStack.empty()) return Interpret(vm, frame, instruction);
+			Type type = vm->objectStack.back()->type;
+			if (type != Type::TRUE && type != Type::FALSE && type != Type::NULLPTR) return Interpret(vm, frame, instruction);
+
+			JIT_HELPER_BEGIN;
+			vm->objectStack.pop_back();
+			bool condition = (instruction->op == OPCODE::JUMP_IF_TRUE) ? (type == Type::TRUE) : (type != Type::TRUE);
+			return condition ? BRANCH : CONTINUE;
+		}
+
+		int JitCompiler::JumpIfKeep(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			if (vm->objectStack.empty()) return Interpret(vm, frame, instruction);
+			Type type = vm->objectStack.back()->type;
+			if (type != Type::TRUE && type != Type::FALSE) return Interpret(vm, frame, instruction);
+
+			JIT_HELPER_BEGIN;
+			Type result = (instruction->op == OPCODE::JUMP_IF_FALSE_KEEP) ? Type::FALSE : Type::TRUE;
+			return (type == result) ? BRANCH : CONTINUE;
+		}
+
+		int JitCompiler::IterationInit(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			frame->offset = instruction->offset + 1; // operands are decoded by VM
+			vm->PerformIterationInit(frame);
+			JIT_HELPER_END;
+		}
+
+		int JitCompiler::IterationNext(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			frame->offset = instruction->offset + 1; // operands are decoded by VM
+			vm->PerformIterationNext(frame);
+			// VM moves frame offset to the loop end label when iteration is finished
+			return (frame->offset != instruction->next) ? BRANCH : CONTINUE;
+		}
+
+		int JitCompiler::GetMember(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			frame->offset = instruction->offset + 1; // operands are decoded by VM
+			JIT_HELPER_FRAME_ACTION(vm->PerformGetMember(frame));
+		}
+
+		int JitCompiler::CallFunction(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			frame->offset = instruction->offset + 1; // operands are decoded by VM
+			JIT_HELPER_FRAME_ACTION(vm->PerformFunctionCall(frame, instruction->op));
+		}
+
+		int JitCompiler::CallMethod(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			frame->offset = instruction->offset + 1; // operands are decoded by VM
+			VirtualMachine::FrameAction action = vm->PerformMethodCall(frame);
+			if (action == VirtualMachine::FrameAction::CONTINUE && frame->offset == instruction->offset)
+			{
+				// inline cache missed and instruction is despecialized. Native code is not rewritten, so it is executed as CALL_FUNCTION
+				frame->offset = instruction->offset + 1;
+				action = vm->PerformFunctionCall(frame, OPCODE::CALL_FUNCTION);
+			}
+			JIT_HELPER_FRAME_ACTION(action);
+		}
+
+		int JitCompiler::Return(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction)
+		{
+			JIT_HELPER_BEGIN;
+			JIT_HELPER_FRAME_ACTION(vm->PerformReturn(frame, instruction->op));
+		}
+		#undef JIT_HELPER_FRAME_ACTION
+		#undef JIT_HELPER_END
+		#undef JIT_HELPER_BEGIN
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "opcode.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_set>
+
+namespace MSL
+{
+	namespace VM
+	{
+		class VirtualMachine;
+		struct Frame;
+		struct MethodType;
+
+		/*
+		native code of method compiled by JitCompiler. It can be entered at any instruction it supports
+		and leaves to interpreter on unsupported instructions, errors and method returns (see VirtualMachine::StartNewStackFrame)
+		*/
+		struct JitMethod
+		{
+			/*
+			instruction of method body decoded at compile time. Native code passes pointer to it to runtime helpers
+			*/
+			struct Instruction
+			{
+				size_t offset = 0; // offset of instruction in method body
+				size_t next = 0; // offset of the next instruction in method body
+				size_t operand = 0; // dependency hash or offset of jump target
+				OPCODE op = OPCODE::ERROR_SYMBOL;
+				int(*helper)(VirtualMachine* vm, Frame* frame, const Instruction* instruction) = nullptr; // runtime helper called by native code
+			};
+			using EntryFunction = int(*)(VirtualMachine* vm, Frame* frame, const uint8_t* entry);
+			static constexpr uint32_t NO_ENTRY = 0xFFFFFFFF;
+
+			std::vector<Instruction> instructions;
+			/*
+			offsets of native code indexed by body offset or NO_ENTRY if instruction must be interpreted
+			*/
+			std::vector<uint32_t> entries;
+			uint8_t* code = nullptr;
+			size_t codeSize = 0;
+			size_t allocatedSize = 0;
+			size_t unwindInfoOffset = 0; // unwind information registered for native code follows it in the same allocation, 0 if it is not registered
+
+			/*
+			returns native code of instruction at body offset or nullptr if it must be interpreted
+			*/
+			const uint8_t* GetEntry(size_t offset) const;
+			/*
+			executes native code from the entry provided until instruction which must be interpreted. Returns status with which native code was left
+			exceptions thrown by runtime helpers are unwound through native code, as its unwind information is registered when it is compiled
+			*/
+			int Enter(VirtualMachine* vm, Frame* frame, const uint8_t* entry) const;
+			~JitMethod();
+		};
+
+		/*
+		baseline template JIT for x86-64. Each instruction of hot method is translated to a direct call of its runtime helper followed by inline check of VM errors,
+		jumps are translated to native jumps and type guards of integer and float ALU instructions are emitted inline. Instructions without helper are left to interpreter
+		*/
+		class JitCompiler
+		{
+		public:
+			/*
+			status returned by runtime helpers to native code
+			*/
+			enum Status : int
+			{
+				CONTINUE = 0, // execute next instruction
+				BRANCH = 1, // jump to the target of instruction
+				LEAVE = 2, // return to interpreter, which continues from frame offset
+				RETURN = 3, // method returned, interpreter leaves the frame
+				TAIL_CALL = 4, // method called by TAIL_CALL is started by interpreter in the frame
+			};
+			using Helper = decltype(JitMethod::Instruction::helper);
+		private:
+			/*
+			offsets of VM state read by native code. They are taken from live objects, as VirtualMachine, BaseObject and std::vector are not standard-layout types
+			*/
+			struct NativeLayout
+			{
+				int32_t errors = 0; // VirtualMachine::errors
+				int32_t stackBegin = -1; // first and past-the-end pointers of VirtualMachine::objectStack, -1 if they are not found
+				int32_t stackEnd = -1;
+				int32_t type = 0; // BaseObject::type
+				bool resolved = false;
+			};
+			std::vector<std::unique_ptr<JitMethod>> methods;
+			std::unordered_set<const MethodType*> rejected;
+			NativeLayout layout;
+
+			void ResolveLayout(const VirtualMachine* vm);
+			void WritePerfMap(const JitMethod& method, const std::string& name) const;
+		public:
+			/*
+			decodes method body to instructions with resolved jump targets and helpers, last instruction marks the body end
+			returns false if body contains instructions which cannot be decoded or invalid operands
+			*/
+			static bool Decode(const MethodType* method, std::vector<JitMethod::Instruction>& instructions);
+			/*
+			returns runtime helper of instruction or nullptr if it must be executed by interpreter
+			*/
+			static Helper GetHelper(OPCODE op);
+			/*
+			returns true if helper of instruction may return BRANCH status
+			*/
+			static bool IsConditionalJump(OPCODE op);
+			/*
+			returns true if instruction does nothing at runtime: labels and bounds of try blocks, which are found in exception table of method
+			*/
+			static bool IsNop(OPCODE op);
+
+			// runtime helpers. They are called by JIT-compiled code, which checks VM errors after each call
+			static int Interpret(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int PushInteger(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int PushFloat(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int PushString(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int PushObject(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int PushConstant(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int LoadLocal(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int StoreLocal(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int AllocVar(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int PopStackTop(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int SetAluIncr(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int GenericALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int TypedALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			// fast paths of TypedALU, called by native code after it checked types of operands
+			static int IntegerALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int FloatALU(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int JumpIf(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int JumpIfKeep(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int IterationInit(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int IterationNext(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int GetMember(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int CallFunction(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int CallMethod(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+			static int Return(VirtualMachine* vm, Frame* frame, const JitMethod::Instruction* instruction);
+
+			/*
+			compiles method to native code. Returns nullptr if method cannot be compiled (or platform is not x86-64)
+			if writePerfMap is set, compiled code is added to /tmp/perf-[pid].map, so it is symbolized by `perf report`
+			*/
+			const JitMethod* Compile(const VirtualMachine* vm, const MethodType* method, const std::string& name, bool writePerfMap);
+		};
+	}
+}
@@ -2,46 +2,212 @@
 #include <sstream>
 using namespace MSL::utils;
 
-struct yy_buffer_state
-{
-    FILE* yy_input_file;
-    char* yy_ch_buf;
-    char* yy_buf_pos;
-    int yy_buf_size;
-    int yy_n_chars;
-    int yy_is_our_buffer;
-    int yy_is_interactive;
-    int yy_at_bol;
-    int yy_bs_lineno;
-    int yy_bs_column;
-    int yy_fill_buffer;
-    int yy_buffer_status;
-};
-
-typedef struct yy_buffer_state* YY_BUFFER_STATE;
-YY_BUFFER_STATE yy_scan_bytes(const char* buffer, int size);
-MSL::compiler::Token yy_lex();
-void yy_delete_buffer(YY_BUFFER_STATE);
-MSL::compiler::Token::Type yy_get_last();
-void yy_set_last(MSL::compiler::Token::Type type);
-
 namespace MSL
 {
 	namespace compiler
 	{
-		Lexer::Lexer(std::string stream)
+		/*
+		keywords of MSL language. Objects which names match one of them are returned as keyword tokens
+		*/
+		static const struct
+		{
+			StringView name;
+			Token::Type type;
+		} keywords[] =
+		{
+			{ "class", Token::Type::CLASS },
+			{ "for", Token::Type::FOR },
+			{ "if", Token::Type::IF },
+			{ "else", Token::Type::ELSE },
+			{ "elif", Token::Type::ELIF },
+			{ "while", Token::Type::WHILE },
+			{ "static", Token::Type::STATIC },
+			{ "var", Token::Type::VARIABLE },
+			{ "function", Token::Type::FUNCTION },
+			{ "const", Token::Type::CONST },
+			{ "public", Token::Type::PUBLIC },
+			{ "private", Token::Type::PRIVATE },
+			{ "namespace", Token::Type::NAMESPACE },
+			{ "return", Token::Type::RETURN },
+			{ "lambda", Token::Type::LAMBDA },
+			{ "this", Token::Type::THIS },
+			{ "in", Token::Type::IN },
+			{ "foreach", Token::Type::FOREACH },
+			{ "true", Token::Type::TRUE_CONSTANT },
+			{ "false", Token::Type::FALSE_CONSTANT },
+			{ "null", Token::Type::NULLPTR },
+			{ "using", Token::Type::USING },
+			{ "try", Token::Type::TRY },
+			{ "catch", Token::Type::CATCH },
+		};
+
+		/*
+		returns type of operator or punctuation token which begins at pos and sets its length. Longest operator is matched
+		returns Token::Type::ERROR with length 1 if symbol is not a part of any operator
+		*/
+		static Token::Type MatchOperator(const char* pos, const char* end, size_t& length)
+		{
+			char next = pos + 1 < end ? pos[1] : '\0';
+			length = 1;
+			switch (*pos)
+			{
+			case '.': return Token::Type::DOT;
+			case '\'': return Token::Type::APOS;
+			case ',': return Token::Type::COMMA;
+			case ';': return Token::Type::SEMICOLON;
+			case '(': return Token::Type::ROUND_BRACKET_O;
+			case ')': return Token::Type::ROUND_BRACKET_C;
+			case '[': return Token::Type::SQUARE_BRACKET_O;
+			case ']': return Token::Type::SQUARE_BRACKET_C;
+			case '{': return Token::Type::BRACE_BRACKET_O;
+			case '}': return Token::Type::BRACE_BRACKET_C;
+			case '&':
+				if (next != '&') return Token::Type::ERROR;
+				length = 2;
+				return Token::Type::LOGIC_AND;
+			case '|':
+				if (next != '|') return Token::Type::ERROR;
+				length = 2;
+				return Token::Type::LOGIC_OR;
+			case '*':
+				if (next == '*')
+				{
+					bool assign = pos + 2 < end && pos[2] == '=';
+					length = assign ? 3 : 2;
+					return assign ? Token::Type::POWER_ASSIGN_OP : Token::Type::POWER_OP;
+				}
+				break;
+			}
+
+			struct Operator
+			{
+				char symbol;
+				Token::Type type;
+				Token::Type assignType; // operator followed by `=`
+			};
+			static const Operator operators[] =
+			{
+				{ '=', Token::Type::ASSIGN_OP, Token::Type::LOGIC_EQUALS },
+				{ '!', Token::Type::NEGATION_OP, Token::Type::LOGIC_NOT_EQUALS },
+				{ '<', Token::Type::LOGIC_LESS, Token::Type::LOGIC_LESS_EQUALS },
+				{ '>', Token::Type::LOGIC_GREATER, Token::Type::LOGIC_GREATER_EQUALS },
+				{ '+', Token::Type::SUM_OP, Token::Type::SUM_ASSIGN_OP },
+				{ '-', Token::Type::SUB_OP, Token::Type::SUB_ASSIGN_OP },
+				{ '*', Token::Type::MULT_OP, Token::Type::MULT_ASSIGN_OP },
+				{ '/', Token::Type::DIV_OP, Token::Type::DIV_ASSIGN_OP },
+				{ '%', Token::Type::MOD_OP, Token::Type::MOD_ASSIGN_OP },
+			};
+			for (const Operator& op : operators)
+			{
+				if (op.symbol != *pos) continue;
+				if (next != '=') return op.type;
+				length = 2;
+				return op.assignType;
+			}
+			return Token::Type::ERROR;
+		}
+
+		static bool isLetter(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+		}
+
+		static bool isDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		Lexer::Lexer(std::string source)
+			: source(std::move(source)), iteratorPos(0), lineCount(0), EOFtoken(Token::Type::ENDOFFILE, "EOF")
+		{
+			Tokenize(this->source.data(), this->source.data() + this->source.size());
+		}
+
+		Lexer::Lexer(const char* data, size_t size)
 			: iteratorPos(0), lineCount(0), EOFtoken(Token::Type::ENDOFFILE, "EOF")
 		{
-            stream += "__EOF__"; // yy_lex will return Token::Type::ENDOFFILE when meet __EOF__
-            auto buffer = yy_scan_bytes(stream.c_str(), stream.size());
-            Token token = yy_lex();
-            while (token.type != Token::Type::ENDOFFILE)
-            {
-                yy_set_last(token.type);
-                tokens.push_back(std::move(token));
-                token = yy_lex();
-            }
-            yy_delete_buffer(buffer);
+			Tokenize(data, data + size);
+		}
+
+		void Lexer::Tokenize(const char* begin, const char* end)
+		{
+			tokens.reserve((end - begin) / 4); // source code has about one token per 4 characters
+			const char* pos = begin;
+			while (pos < end)
+			{
+				const char* start = pos;
+				char c = *pos;
+				if (c == ' ' || c == '\t' || c == '\r')
+				{
+					pos++;
+				}
+				else if (c == '\n')
+				{
+					tokens.emplace_back(Token::Type::ENDLINE, StringView(start, 1));
+					pos++;
+				}
+				else if (c == '/' && pos + 1 < end && pos[1] == '/') // line comment, ends before `\n`
+				{
+					while (pos < end && *pos != '\n') pos++;
+				}
+				else if (c == '/' && pos + 1 < end && pos[1] == '*') // block comment, line breaks inside are kept for line count
+				{
+					pos += 2;
+					while (pos < end && !(*pos == '*' && pos + 1 < end && pos[1] == '/'))
+					{
+						if (*pos == '\n') tokens.emplace_back(Token::Type::ENDLINE, StringView(pos, 1));
+						pos++;
+					}
+					pos = pos < end ? pos + 2 : end;
+				}
+				else if (c == '\"') // string constant, escape sequences are replaced by code generator
+				{
+					pos++;
+					while (pos < end && !(*pos == '\"' && pos[-1] != '\\')) pos++;
+					if (pos == end)
+					{
+						tokens.emplace_back(Token::Type::ERROR, "<error> closing `\"` not found");
+						break;
+					}
+					tokens.emplace_back(Token::Type::STRING_CONSTANT, StringView(start + 1, pos - start - 1));
+					pos++;
+				}
+				else if (isDigit(c))
+				{
+					while (pos < end && isDigit(*pos)) pos++;
+					Token::Type type = Token::Type::INTEGER_CONSTANT;
+					if (pos + 1 < end && *pos == '.' && isDigit(pos[1]))
+					{
+						type = Token::Type::FLOAT_CONSTANT;
+						pos++;
+						while (pos < end && isDigit(*pos)) pos++;
+					}
+					tokens.emplace_back(type, StringView(start, pos - start));
+				}
+				else if (isLetter(c))
+				{
+					while (pos < end && (isLetter(*pos) || isDigit(*pos))) pos++;
+					StringView name(start, pos - start);
+					Token::Type type = Token::Type::OBJECT;
+					for (const auto& keyword : keywords)
+					{
+						if (keyword.name == name)
+						{
+							type = keyword.type;
+							break;
+						}
+					}
+					tokens.emplace_back(type, name);
+				}
+				else
+				{
+					size_t length;
+					Token::Type type = MatchOperator(pos, end, length);
+					tokens.emplace_back(type, StringView(start, length));
+					pos += length;
+				}
+			}
+			ToBegin();
 		}
 
 		Token& Lexer::Peek()
@@ -121,7 +287,8 @@ namespace MSL
 			std::string line;
 			while (!End() && tokens[iteratorPos].type != Token::Type::ENDLINE)
 			{
-				line += tokens[iteratorPos].value + TOKEN_SEPARATOR;
+				line.append(tokens[iteratorPos].value.data, tokens[iteratorPos].value.size);
+				line += TOKEN_SEPARATOR;
 				iteratorPos++;
 			}
 			Prev();
@@ -134,7 +301,7 @@ namespace MSL
 			std::string line;
 			while (!Begin() && tokens[iteratorPos].type != Token::Type::ENDLINE)
 			{
-				line = tokens[iteratorPos].value + TOKEN_SEPARATOR + line;
+				line = std::string(tokens[iteratorPos].value) + TOKEN_SEPARATOR + line;
 				iteratorPos--;
 			}
 			Next();
@@ -145,32 +312,5 @@ namespace MSL
 		{
 			iteratorPos = pos;
 		}
-
-		void Lexer::ReplaceStrings(const std::unordered_map<std::string, std::string>& stringMap)
-		{
-			std::unordered_map<std::string, std::string> reversedMap;
-			reversedMap.reserve(stringMap.size());
-			for (const auto& pair : stringMap)
-			{
-				reversedMap.insert({ pair.second, pair.first });
-			}
-			while (!End())
-			{
-				if (Peek().type == Token::Type::STRING_CONSTANT)
-				{
-					std::string stringConstant = Peek().value;
-					if (reversedMap.find(stringConstant) == reversedMap.end())
-					{
-						Peek().type = Token::Type::ERROR;
-						Peek().value = "<error> closing `\"` not found";
-						break;
-					}
-					else
-						Peek().value = reversedMap.find(stringConstant)->second;
-				}
-				Next();
-			}
-			ToBegin();
-		}
 	}
 }
\ No newline at end of file
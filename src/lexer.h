@@ -1,7 +1,7 @@
 #pragma once
 #include "stringExtensions.h"
 #include "token.h"
-#include <unordered_map>
+#include <vector>
 
 namespace MSL
 {
@@ -9,10 +9,15 @@ namespace MSL
 	{
 		/*
 		Lexer object for analysing code and spliting it into tokens
-		accepts edited string with divided tokens, without strings and comments
+		source code is scanned in one pass: comments are skipped and string constants are read as single tokens
+		tokens refer to characters of source code instead of copying them
 		*/
 		class Lexer
 		{
+			/*
+			source code passed as string. It is empty if lexer refers to external buffer
+			*/
+			std::string source;
 			/*
 			array of tokens which can be iterated using Next(), Peek() and Prev()
 			*/
@@ -29,11 +34,21 @@ namespace MSL
 			current line in source file. Is used by GetLineCount()
 			*/
 			int lineCount;
+			/*
+			splits source code into tokens and inserts them into token array
+			*/
+			void Tokenize(const char* begin, const char* end);
 		public:
 			/*
-			creates lexer object using source code from StreamReader object
+			creates lexer object which owns source code provided
 			*/
-			Lexer(std::string stream);
+			Lexer(std::string source);
+			/*
+			creates lexer object over external buffer (for example, source file mapped to memory). Buffer must outlive lexer
+			*/
+			Lexer(const char* data, size_t size);
+			Lexer(const Lexer&) = delete;
+			Lexer& operator=(const Lexer&) = delete;
 
 			/*
 			returns current token or EOFToken if out of range
@@ -66,10 +81,6 @@ namespace MSL
 			*/
 			void SetIteratorPos(int pos);
 			/*
-			replace all string aliases which was set by StreamReader to their actual contents (stringMap can be get by StreamReader)
-			*/
-			void ReplaceStrings(const std::unordered_map<std::string, std::string>& stringMap);
-			/*
 			returns true if the iterator reaches end of the token array, false either
 			*/
 			bool End() const;
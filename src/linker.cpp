@@ -0,0 +1,265 @@
+#include "linker.h"
+#include "opcode.h"
+#include <cstring>
+#include <unordered_map>
+
+namespace MSL
+{
+	namespace VM
+	{
+		/*
+		names which are referenced by VM itself instead of bytecode: classes of primitive types, arrays of exception stack traces,
+		conversions, iteration and overloaded operators (see VirtualMachine::OpcodeToMethod)
+		*/
+		static const char* const IMPLICIT_NAMES[] =
+		{
+			"Integer", "Math", "String", "True", "False", "Null", "Array", "Range",
+			"ToString", "ToInteger", "ToFloat", "ToBoolean", "GetByIndex", "Begin", "End", "Next", "GetByIter",
+			"NegationOperator", "NegOperator", "PosOperator", "SumOperator", "SubOperator", "MultOperator", "DivOperator", "ModOperator", "PowerOperator",
+			"IsEqual", "IsNotEqual", "IsLess", "IsGreater", "IsLessEqual", "IsGreaterEqual", "AndOperator", "OrOperator",
+		};
+
+		/*
+		returns size of instruction in method body with fixed-size operands, as VM executes it
+		*/
+		static size_t GetInstructionSize(OPCODE op)
+		{
+			OperandLayout layout = GetOperandLayout(op);
+			return 1 + layout.hashCount * sizeof(size_t) + (layout.hasParamCount ? sizeof(uint8_t) : 0) + (layout.hasLabel ? sizeof(uint16_t) : 0);
+		}
+
+		/*
+		reads first dependency operand of instruction at offset provided
+		*/
+		static size_t ReadDependency(const MethodType::ByteArray& body, size_t offset)
+		{
+			size_t hash;
+			std::memcpy(&hash, &body[offset + 1], sizeof(size_t));
+			return hash;
+		}
+
+		std::string Linker::Report::ToString() const
+		{
+			return std::to_string(classesRemoved) + " of " + std::to_string(classesBefore) + " classes and " +
+				std::to_string(methodsRemoved) + " of " + std::to_string(methodsBefore) + " methods removed, " +
+				std::to_string(attributesInlined) + " constant attributes inlined into " + std::to_string(instructionsInlined) + " instructions";
+		}
+
+		std::string Linker::GetBaseName(const std::string& name)
+		{
+			const std::string staticSuffix = "_0static";
+			if (name.size() > staticSuffix.size() && name.compare(name.size() - staticSuffix.size(), staticSuffix.size(), staticSuffix) == 0)
+			{
+				return name.substr(0, name.size() - staticSuffix.size());
+			}
+			size_t suffix = name.find_last_not_of("0123456789");
+			if (suffix != std::string::npos && suffix + 1 < name.size() && name[suffix] == '_')
+			{
+				return name.substr(0, suffix);
+			}
+			return name;
+		}
+
+		void Linker::AddReachableMethod(const MethodType& method)
+		{
+			reachableMethods.insert(&method);
+			for (size_t i = 0; i < method.dependencies.size(); i++)
+			{
+				// string literals are added too, as classes and methods can be found by System.Reflection with them
+				names.insert(method.dependencies[i]);
+				names.insert(GetBaseName(method.dependencies[i]));
+			}
+		}
+
+		void Linker::MarkReachable()
+		{
+			for (const char* name : IMPLICIT_NAMES)
+			{
+				names.insert(name);
+			}
+			const ClassType* entryClass = nullptr;
+			if (entryPoint.GetNamespace() != nullptr && entryPoint.GetClass() != nullptr && entryPoint.GetMethod() != nullptr)
+			{
+				entryClass = &assembly.namespaces.at(*entryPoint.GetNamespace()).classes.at(*entryPoint.GetClass());
+				AddReachableMethod(entryClass->methods.at(*entryPoint.GetMethod()));
+			}
+
+			bool changed = true;
+			while (changed)
+			{
+				changed = false;
+				for (const auto& ns : assembly.namespaces)
+				{
+					for (const auto& c : ns.second.classes)
+					{
+						const ClassType& _class = c.second;
+						if (&_class != entryClass && names.find(_class.name) == names.end()) continue;
+						for (const auto& m : _class.methods)
+						{
+							const MethodType& method = m.second;
+							if (reachableMethods.find(&method) != reachableMethods.end()) continue;
+							// static constructor is called by VM when class is first used
+							if (method.isStaticConstructor() || names.find(GetBaseName(method.name)) != names.end())
+							{
+								AddReachableMethod(method);
+								changed = true;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		void Linker::RemoveUnreachable()
+		{
+			for (auto nsIt = assembly.namespaces.begin(); nsIt != assembly.namespaces.end();)
+			{
+				auto& classes = nsIt->second.classes;
+				for (auto classIt = classes.begin(); classIt != classes.end();)
+				{
+					ClassType& _class = classIt->second;
+					report.classesBefore++;
+					report.methodsBefore += _class.methods.size();
+					size_t methodCount = _class.methods.size();
+					for (auto methodIt = _class.methods.begin(); methodIt != _class.methods.end();)
+					{
+						if (reachableMethods.find(&methodIt->second) == reachableMethods.end())
+							methodIt = _class.methods.erase(methodIt);
+						else
+							methodIt++;
+					}
+					report.methodsRemoved += methodCount - _class.methods.size();
+
+					bool referenced = _class.isSystem() || !_class.methods.empty() || names.find(_class.name) != names.end();
+					if (referenced)
+					{
+						classIt++;
+						continue;
+					}
+					report.classesRemoved++;
+					classIt = classes.erase(classIt);
+				}
+				if (classes.empty() && names.find(nsIt->second.name) == names.end())
+					nsIt = assembly.namespaces.erase(nsIt);
+				else
+					nsIt++;
+			}
+		}
+
+		void Linker::InlineConstants(ClassType& _class)
+		{
+			auto constructorIt = _class.methods.find(_class.name + "_0static");
+			if (constructorIt == _class.methods.end()) return;
+			const MethodType& constructor = constructorIt->second;
+
+			// literal instruction and dependency assigned to attribute by static constructor
+			std::unordered_map<std::string, std::pair<OPCODE, const std::string*>> constants;
+			const auto& body = constructor.body;
+			const size_t pushSize = GetInstructionSize(OPCODE::PUSH_OBJECT);
+			size_t offset = 0;
+			// only assignments before any other instruction are taken, so no method of class can observe attribute before it
+			while (offset + 2 * pushSize + 2 <= body.size())
+			{
+				OPCODE literal = static_cast<OPCODE>(body[offset + pushSize]);
+				if (body[offset] != OPCODE::PUSH_OBJECT ||
+					(literal != OPCODE::PUSH_INTEGER && literal != OPCODE::PUSH_FLOAT && literal != OPCODE::PUSH_STRING) ||
+					body[offset + 2 * pushSize] != OPCODE::ASSIGN_OP ||
+					body[offset + 2 * pushSize + 1] != OPCODE::POP_STACK_TOP)
+				{
+					break;
+				}
+				size_t attribute = ReadDependency(body, offset);
+				size_t value = ReadDependency(body, offset + pushSize);
+				if (attribute >= constructor.dependencies.size() || value >= constructor.dependencies.size()) break;
+
+				const std::string& name = constructor.dependencies[attribute];
+				auto attributeIt = _class.staticAttributes.find(name);
+				if (attributeIt == _class.staticAttributes.end() || !attributeIt->second.isConst()) break;
+				if (!constants.insert({ name, { literal, &constructor.dependencies[value] } }).second) break;
+				offset += 2 * pushSize + 2;
+			}
+			if (constants.empty()) return;
+
+			NameSet inlined;
+			for (auto& m : _class.methods)
+			{
+				MethodType& method = m.second;
+				if (&method == &constructor) continue;
+
+				// locals and parameters with the same name hide attributes in method body
+				NameSet hidden(method.parameters.begin(), method.parameters.end());
+				for (size_t i = 0; i < method.body.size(); i += GetInstructionSize(static_cast<OPCODE>(method.body[i])))
+				{
+					OPCODE op = static_cast<OPCODE>(method.body[i]);
+					switch (op)
+					{
+					case OPCODE::ALLOC_VAR:
+					case OPCODE::ALLOC_CONST_VAR:
+					case OPCODE::LOAD_LOCAL:
+					case OPCODE::STORE_LOCAL:
+					case OPCODE::ITER_INIT:
+					case OPCODE::ITER_NEXT:
+						break;
+					default:
+						continue;
+					}
+					for (uint8_t hash = 0; hash < GetOperandLayout(op).hashCount && i + 1 + (hash + 1) * sizeof(size_t) <= method.body.size(); hash++)
+					{
+						size_t dependency;
+						std::memcpy(&dependency, &method.body[i + 1 + hash * sizeof(size_t)], sizeof(size_t));
+						if (dependency < method.dependencies.size()) hidden.insert(method.dependencies[dependency]);
+					}
+				}
+
+				for (size_t i = 0; i + pushSize <= method.body.size(); i += GetInstructionSize(static_cast<OPCODE>(method.body[i])))
+				{
+					if (method.body[i] != OPCODE::PUSH_OBJECT) continue;
+					size_t dependency = ReadDependency(method.body, i);
+					if (dependency >= method.dependencies.size()) continue;
+					const std::string& name = method.dependencies[dependency];
+					auto constant = constants.find(name);
+					if (constant == constants.end() || hidden.find(name) != hidden.end()) continue;
+
+					size_t value = method.dependencies.size();
+					for (size_t j = 0; j < method.dependencies.size(); j++)
+					{
+						if (&method.dependencies[j] == constant->second.second) value = j;
+					}
+					if (value == method.dependencies.size()) method.dependencies.push_back(constant->second.second);
+
+					method.body[i] = constant->second.first;
+					std::memcpy(&method.body[i + 1], &value, sizeof(size_t));
+					inlined.insert(name);
+					report.instructionsInlined++;
+				}
+			}
+			report.attributesInlined += inlined.size();
+		}
+
+		Linker::Linker(AssemblyType& assembly, const CallPath& entryPoint)
+			: assembly(assembly), entryPoint(entryPoint) { }
+
+		void Linker::Keep(const std::string& name)
+		{
+			names.insert(name);
+		}
+
+		void Linker::Link()
+		{
+			MarkReachable();
+			RemoveUnreachable();
+			for (auto& ns : assembly.namespaces)
+			{
+				for (auto& c : ns.second.classes)
+				{
+					InlineConstants(c.second);
+				}
+			}
+		}
+
+		const Linker::Report& Linker::GetReport() const
+		{
+			return report;
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "assemblyType.h"
+#include "callPath.h"
+#include <unordered_set>
+#include <string>
+
+namespace MSL
+{
+	namespace VM
+	{
+		/*
+		Linker class prepares assembly merged from several bytecode files to be written as one image (see MSL link command)
+		it removes classes and methods which cannot be reached from entry point and inlines constant static attributes
+		VM resolves calls by names at runtime, so method is considered reachable if its name is referenced by any reachable method
+		*/
+		class Linker
+		{
+		public:
+			/*
+			statistics of linking. Counters before linking are used to show how much of assembly is removed
+			*/
+			struct Report
+			{
+				size_t classesBefore = 0;
+				size_t classesRemoved = 0;
+				size_t methodsBefore = 0;
+				size_t methodsRemoved = 0;
+				size_t attributesInlined = 0;
+				size_t instructionsInlined = 0;
+				/*
+				returns human-read representation of report as string
+				*/
+				std::string ToString() const;
+			};
+		private:
+			using NameSet = std::unordered_set<std::string>;
+
+			/*
+			merged assembly which is linked in place
+			*/
+			AssemblyType& assembly;
+			/*
+			entry point of assembly. If it is not set, only names marked by Keep() are reachable
+			*/
+			const CallPath& entryPoint;
+			/*
+			names referenced by reachable methods: dependencies and their base names without parameter count
+			*/
+			NameSet names;
+			std::unordered_set<const MethodType*> reachableMethods;
+			Report report;
+
+			/*
+			returns name of method or call dependency without parameter count suffix (see AssemblyEditor::ReadClass)
+			*/
+			static std::string GetBaseName(const std::string& name);
+			/*
+			marks method as reachable and adds all its dependencies to referenced names
+			*/
+			void AddReachableMethod(const MethodType& method);
+			/*
+			finds all methods reachable from entry point until no new names are referenced
+			*/
+			void MarkReachable();
+			/*
+			erases unreachable methods, classes without reachable members and namespaces which become empty
+			*/
+			void RemoveUnreachable();
+			/*
+			replaces reads of constant static attributes, which are assigned by literals at the beginning of static constructor, by these literals
+			only methods of the class itself are changed, as static constructor is always called before any of them
+			*/
+			void InlineConstants(ClassType& _class);
+		public:
+			/*
+			creates linker for assembly with entry point provided
+			*/
+			Linker(AssemblyType& assembly, const CallPath& entryPoint);
+			/*
+			marks classes and methods with name provided as reachable, for example ones which are found by System.Reflection with computed names
+			*/
+			void Keep(const std::string& name);
+			/*
+			removes unreachable code from assembly and inlines constants
+			*/
+			void Link();
+			/*
+			returns statistics of linking
+			*/
+			const Report& GetReport() const;
+		};
+	}
+}
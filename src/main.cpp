@@ -1,26 +1,26 @@
 #include "lexer.h"
-#include "streamReader.h"
 #include "parser.h"
 #include "virtualMachine.h"
 #include "bytecodeReader.h"
 #include "codeGenerator.h"
+#include "optimizer.h"
+#include "aotTranslator.h"
+#include "linker.h"
+#include "compilationCache.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
 
 using namespace std;
 
 #define MSL_VM_DEBUG
 
-bool createAssembly(string fileName)
+bool compileSource(const char* source, size_t size, const string& fileName, int optimizationLevel, ostream& log, string& bytecode)
 {
-	ifstream file(fileName + ".msl");
-	MSL::compiler::StreamReader reader;
+	MSL::compiler::Lexer lexer(source, size);
 
-	reader.ReadToEnd(file);
-	file.close();
-
-	MSL::compiler::Lexer lexer(reader.GetBuffer());
-	lexer.ReplaceStrings(reader.GetReplacedStrings());
-
-	MSL::compiler::Parser parser(&lexer, &cout, MSL::compiler::Parser::MODE::ERROR_ONLY);
+	MSL::compiler::Parser parser(&lexer, &log, MSL::compiler::Parser::MODE::ERROR_ONLY);
 	parser.Parse();
 
 	if (!parser.ParsingSuccess())
@@ -29,12 +29,40 @@ bool createAssembly(string fileName)
 	}
 	MSL::compiler::Assembly assembly = parser.PullAssembly();
 
+	MSL::compiler::Optimizer optimizer(assembly, optimizationLevel);
+	optimizer.Optimize();
+	if (optimizationLevel > MSL::compiler::Optimizer::O0)
+	{
+		log << fileName << ".msl optimized: " << optimizer.GetReport().ToString() << endl;
+	}
+
 	MSL::compiler::CodeGenerator generator(assembly);
 	generator.GenerateBytecode();
+	bytecode = generator.GetBuffer();
+	return true;
+}
+
+bool createAssembly(string fileName, int optimizationLevel, ostream& log, MSL::compiler::CompilationCache* cache)
+{
+	MSL::VM::MappedFile file; // tokens refer to source file pages, so it stays mapped until file is compiled
+	if (!file.Open(fileName + ".msl"))
+	{
+		log << "cannot open file: " << fileName << ".msl" << endl;
+		return false;
+	}
+	const char* source = reinterpret_cast<const char*>(file.GetData());
+
+	string bytecode;
+	string key;
+	if (cache != nullptr) key = MSL::compiler::CompilationCache::GetKey(source, file.GetSize(), optimizationLevel);
+	if (cache == nullptr || !cache->Load(key, bytecode))
+	{
+		if (!compileSource(source, file.GetSize(), fileName, optimizationLevel, log, bytecode)) return false;
+		if (cache != nullptr) cache->Store(key, bytecode);
+	}
 
 	ofstream binary(fileName + ".emsl", ios::binary);
-	auto contents = generator.GetBuffer();
-	binary.write(contents.c_str(), contents.size());
+	binary.write(bytecode.c_str(), bytecode.size());
 	binary.close();
 
 #ifdef MSL_VM_DEBUG
@@ -46,14 +74,209 @@ bool createAssembly(string fileName)
 	return true;
 }
 
-void compileASC(stringstream& ss)
+bool createAssemblies(const std::vector<string>& fileNames, int optimizationLevel, MSL::compiler::CompilationCache* cache)
+{
+	// each file is compiled independently by a worker thread, output is buffered and printed in order of files
+	std::vector<stringstream> logs(fileNames.size());
+	std::vector<char> compiled(fileNames.size(), false);
+	std::atomic<size_t> nextFile(0);
+	auto compileFiles = [&]()
+	{
+		for (size_t i = nextFile++; i < fileNames.size(); i = nextFile++)
+		{
+			compiled[i] = createAssembly(fileNames[i], optimizationLevel, logs[i], cache);
+		}
+	};
+
+	size_t workerCount = std::max(1u, std::thread::hardware_concurrency());
+	workerCount = std::min(workerCount, fileNames.size());
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < workerCount; i++)
+	{
+		workers.emplace_back(compileFiles);
+	}
+	compileFiles();
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+	if (cache != nullptr) cache->Flush();
+
+	for (size_t i = 0; i < fileNames.size(); i++)
+	{
+		cout << logs[i].str();
+		if (!compiled[i]) return false;
+		cout << fileNames[i] << ".msl compiled" << endl;
+	}
+	return true;
+}
+
+bool translateAssembly(string fileName)
+{
+	MSL::VM::MappedFile binary;
+	if (!binary.Open(fileName + ".emsl"))
+	{
+		cout << "cannot open file: " << fileName << ".emsl" << endl;
+		return false;
+	}
+	MSL::VM::AssemblyType assembly;
+	MSL::VM::AssemblyEditor editor(binary.GetData(), binary.GetSize(), &cout);
+	if (!editor.MergeAssemblies(assembly, true, nullptr))
+	{
+		return false;
+	}
+
+	ofstream source(fileName + ".cpp");
+	MSL::VM::AotTranslator translator(assembly, source);
+	translator.Translate(fileName);
+	cout << fileName << ".emsl translated: " << translator.GetTranslatedCount() << " methods, " << translator.GetSkippedCount() << " skipped" << endl;
+	return true;
+}
+
+bool createSnapshot(const std::vector<string>& executables, const string& snapshotName, const string& warmup)
+{
+	MSL::VM::Configuration config;
+	config.streams = { &std::cin, &std::cout, &std::cerr };
+	config.GC.maxMemory = 128 * MSL::VM::MB;
+	config.compilation.lazyDecoding = false; // all method bodies are written to snapshot
+	MSL::VM::VirtualMachine VM(move(config));
+	for (const string& fileName : executables)
+	{
+		if (!VM.AddBytecodeFile(fileName)) return false;
+	}
+	if (!warmup.empty())
+	{
+		// warm-up method is written as Namespace.Class.Method, namespace can contain dots too
+		size_t methodBegin = warmup.rfind('.');
+		size_t classBegin = methodBegin == string::npos || methodBegin == 0 ? string::npos : warmup.rfind('.', methodBegin - 1);
+		if (classBegin == string::npos)
+		{
+			cout << "invalid warm-up method: " << warmup << endl;
+			return false;
+		}
+		string ns = warmup.substr(0, classBegin);
+		string className = warmup.substr(classBegin + 1, methodBegin - classBegin - 1);
+		if (!VM.Warmup(ns, className, warmup.substr(methodBegin + 1))) return false;
+	}
+
+	ofstream snapshot(snapshotName, ios::binary);
+	if (!VM.WriteSnapshot(snapshot))
+	{
+		cout << "cannot write snapshot: " << snapshotName << endl;
+		return false;
+	}
+	cout << snapshotName << " created from " << executables.size() << " files" << endl;
+	return true;
+}
+
+bool verifyLinkedAssembly(const MSL::VM::AssemblyType& assembly, stringstream& image)
+{
+	// linked image is read back and each of its method bodies must be equal to the one it was written from
+	MSL::VM::AssemblyType written;
+	MSL::VM::AssemblyEditor editor(&image, &cout);
+	if (!editor.MergeAssemblies(written, true, nullptr)) return false;
+	image.clear();
+	image.seekg(0);
+	for (const auto& ns : written.namespaces)
+	{
+		for (const auto& c : ns.second.classes)
+		{
+			const auto& source = assembly.namespaces.at(ns.first).classes.at(c.first);
+			for (const auto& m : c.second.methods)
+			{
+				const MSL::VM::MethodType& method = source.methods.at(m.first);
+				if (method.body != m.second.body || method.labels != m.second.labels)
+				{
+					cout << "method " << ns.first << '.' << c.first << '.' << method.name << " was written incorrectly" << endl;
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool linkAssembly(const std::vector<string>& executables, const string& outputName, const std::vector<string>& keepNames)
 {
-	MSL::compiler::StreamReader reader;
+	MSL::VM::AssemblyType assembly;
+	MSL::VM::CallPath entryPoint;
+	for (const string& fileName : executables)
+	{
+		MSL::VM::MappedFile binary;
+		if (!binary.Open(fileName))
+		{
+			cout << "cannot open file: " << fileName << endl;
+			return false;
+		}
+		MSL::VM::AssemblyEditor editor(binary.GetData(), binary.GetSize(), &cout);
+		if (!editor.MergeAssemblies(assembly, true, &entryPoint)) return false;
+	}
 
-	reader.ReadToEnd(ss);
+	MSL::VM::Linker linker(assembly, entryPoint);
+	for (const string& name : keepNames)
+	{
+		linker.Keep(name);
+	}
+	linker.Link();
+	stringstream image;
+	MSL::VM::AssemblyEditor::WriteAssembly(assembly, image);
+	if (!verifyLinkedAssembly(assembly, image))
+	{
+		cout << outputName << " was not written: linked assembly differs from one read back from it" << endl;
+		return false;
+	}
+	ofstream output(outputName, ios::binary);
+	output << image.rdbuf();
+	cout << outputName << " linked from " << executables.size() << " files: " << linker.GetReport().ToString() << endl;
+	return true;
+}
 
-	MSL::compiler::Lexer lexer(reader.GetBuffer());
-	lexer.ReplaceStrings(reader.GetReplacedStrings());
+bool benchmarkLexer(const std::vector<string>& fileNames)
+{
+	// every file is tokenized repeatedly for at least a second, source is mapped once so only lexer is measured
+	using Clock = std::chrono::steady_clock;
+	uint64_t totalBytes = 0;
+	double totalSeconds = 0.0;
+	for (const string& fileName : fileNames)
+	{
+		MSL::VM::MappedFile file;
+		if (!file.Open(fileName))
+		{
+			cout << "cannot open file: " << fileName << endl;
+			return false;
+		}
+		const char* source = reinterpret_cast<const char*>(file.GetData());
+		uint64_t bytes = 0;
+		auto start = Clock::now();
+		double seconds = 0.0;
+		do
+		{
+			MSL::compiler::Lexer lexer(source, file.GetSize());
+			bytes += file.GetSize();
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (seconds < 1.0);
+
+		MSL::compiler::Lexer lexer(source, file.GetSize());
+		size_t tokenCount = 0;
+		for (lexer.SetIteratorPos(0); !lexer.End(); lexer.SetIteratorPos(lexer.GetIteratorPos() + 1))
+		{
+			tokenCount++;
+		}
+
+		cout << fileName << ": " << tokenCount << " tokens, " << bytes / seconds / MSL::VM::MB << " MB/s" << endl;
+		totalBytes += bytes;
+		totalSeconds += seconds;
+	}
+	if (fileNames.size() > 1)
+	{
+		cout << "total: " << totalBytes / totalSeconds / MSL::VM::MB << " MB/s" << endl;
+	}
+	return true;
+}
+
+void compileASC(stringstream& ss)
+{
+	MSL::compiler::Lexer lexer(ss.str());
 
 	MSL::compiler::Parser parser(&lexer, &cout, MSL::compiler::Parser::MODE::ERROR_ONLY);
 	parser.Parse();
@@ -86,14 +309,28 @@ void compileFromArgs(int argc, char* argv[])
 	if (argc == 1)
 	{
 		cout << "MSL compiler usage:" << endl;
-		cout << "> MSL compile [file1.msl] [file2.msl] ... - compiles source files to .emsl" << endl;
-		cout << "> MSL run [file1.emsl] [file2.emsl] ... - runs bytecode files in VM" << endl;
-		cout << "> MSL vm [file1.msl] [file2.msl] ... - compiles and runs files in VM" << endl;
+		cout << "> MSL compile [-O0|-O1|-O2] [-cache dir] [-cachesize MB] [-verbose] [file1.msl] [file2.msl] ... - compiles source files to .emsl" << endl;
+		cout << "> MSL run [-stats] [-jit] [-aot module] [file1.emsl] [file2.emsl] ... - runs bytecode files or snapshots (.msnap) in VM" << endl;
+		cout << "> MSL vm [-O0|-O1|-O2] [-cache dir] [-cachesize MB] [-verbose] [-stats] [-jit] [file1.msl] [file2.msl] ... - compiles and runs files in VM" << endl;
+		cout << "> MSL aot [file1.emsl] [file2.emsl] ... - translates bytecode files to C++ source to be built as dll" << endl;
+		cout << "> MSL snapshot [-warmup Namespace.Class.Method] [image.msnap] [file1.emsl] [file2.emsl] ... - writes initialized VM to snapshot, which is run faster than bytecode files" << endl;
+		cout << "> MSL link [-keep Name] [output.emsl] [file1.emsl] [file2.emsl] ... - merges bytecode files to one, removing code unreachable from entry point" << endl;
+		cout << "> MSL lex [file1.msl] [file2.msl] ... - measures lexer throughput over source files in MB/s" << endl;
+		cout << "  -O0 disables bytecode optimizations, -O1 (default) folds constants and removes dead code," << endl;
+		cout << "  -O2 also propagates constants and threads jumps" << endl;
+		cout << "  -cache sets directory where compiled files are cached (default: .mslcache), unchanged files are not compiled again" << endl;
+		cout << "  -cachesize limits size of compilation cache (default: 64 MB), least recently used files are evicted. 0 disables cache" << endl;
+		cout << "  -verbose prints compilation cache statistics" << endl;
+		cout << "  -stats prints VM quickening statistics after execution" << endl;
+		cout << "  -jit compiles hot methods to native code (x86-64 only)" << endl;
+		cout << "  -warmup calls static method before snapshot is written, static state it creates is restored when snapshot is run" << endl;
+		cout << "  -aot loads dll built from source generated by aot command, its methods are executed as native code" << endl;
+		cout << "  -keep marks classes and methods with name provided as reachable, for example ones used by System.Reflection" << endl;
 		return;
 	}
 	std::string command = argv[1];
 
-	if (command != "compile" && command != "vm" && command != "run")
+	if (command != "compile" && command != "vm" && command != "run" && command != "aot" && command != "snapshot" && command != "link" && command != "lex")
 	{
 		cout << "invalid command: " << argv[1] << endl;
 		cout << "launch program with no args for full usage documentation" << endl;
@@ -101,26 +338,110 @@ void compileFromArgs(int argc, char* argv[])
 	}
 
 	std::vector<std::string> executables;
+	std::vector<std::string> aotModules;
+	bool printStats = false;
+	bool useJit = false;
+	for (int i = 2; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "-stats") printStats = true;
+		if (std::string(argv[i]) == "-jit") useJit = true;
+	}
 
 	if (command == "compile" || command == "vm")
 	{
+		int optimizationLevel = MSL::compiler::Optimizer::O1;
+		std::string cacheDirectory = ".mslcache";
+		size_t cacheSize = 64 * MSL::VM::MB;
+		bool verbose = false;
+		for (int i = 2; i < argc; i++)
+		{
+			std::string option = argv[i];
+			if (option.size() == 3 && option[0] == '-' && option[1] == 'O')
+			{
+				if (option[2] < '0' || option[2] > '2')
+				{
+					cout << "invalid optimization level: " << option << endl;
+					return;
+				}
+				optimizationLevel = option[2] - '0';
+			}
+			if (option == "-cache" && i + 1 < argc)
+			{
+				cacheDirectory = argv[++i];
+			}
+			if (option == "-cachesize" && i + 1 < argc)
+			{
+				char* end = nullptr;
+				unsigned long long megabytes = std::strtoull(argv[++i], &end, 10);
+				if (*end != '\0' || end == argv[i])
+				{
+					cout << "invalid cache size: " << argv[i] << endl;
+					return;
+				}
+				cacheSize = static_cast<size_t>(megabytes) * MSL::VM::MB;
+			}
+			if (option == "-verbose") verbose = true;
+		}
+		std::vector<std::string> fileNames;
 		for (int i = 2; i < argc; i++)
 		{
 			std::string fileName = argv[i];
+			if (fileName.size() == 3 && fileName[0] == '-' && fileName[1] == 'O') continue; // optimization level
+			if (fileName == "-stats" || fileName == "-jit" || fileName == "-verbose") continue;
+			if (fileName == "-cache" || fileName == "-cachesize")
+			{
+				i++; // option value
+				continue;
+			}
 			if (fileName.size() <= 4 || fileName.substr(fileName.size() - 4, fileName.size()) != ".msl")
 			{
 				cout << "invalid filename: " << fileName << endl;
 				return;
 			}
-			fileName = fileName.substr(0, fileName.size() - 4);
-			if (!createAssembly(fileName)) return;
-			cout << argv[i] << " compiled" << endl;
+			fileNames.push_back(fileName.substr(0, fileName.size() - 4));
+		}
+		std::unique_ptr<MSL::compiler::CompilationCache> cache;
+		if (cacheSize > 0) cache.reset(new MSL::compiler::CompilationCache(cacheDirectory, cacheSize));
+		bool compiled = createAssemblies(fileNames, optimizationLevel, cache.get());
+		if (verbose && cache != nullptr)
+		{
+			cout << "compilation cache " << cacheDirectory << ": " << cache->GetReport().ToString() << endl;
+		}
+		if (!compiled) return;
+		for (const std::string& fileName : fileNames)
+		{
 			executables.push_back(fileName + ".emsl");
 		}
 	}
-	else if (command == "run")
+	else if (command == "aot")
 	{
 		for (int i = 2; i < argc; i++)
+		{
+			std::string fileName = argv[i];
+			if (fileName.size() <= 5 || fileName.substr(fileName.size() - 5, fileName.size()) != ".emsl")
+			{
+				cout << "invalid filename: " << fileName << endl;
+				return;
+			}
+			if (!translateAssembly(fileName.substr(0, fileName.size() - 5))) return;
+		}
+	}
+	else if (command == "snapshot")
+	{
+		std::string warmup;
+		int firstFile = 2;
+		if (argc > 3 && std::string(argv[2]) == "-warmup")
+		{
+			warmup = argv[3];
+			firstFile = 4;
+		}
+		std::string snapshotName = argc > firstFile ? argv[firstFile] : "";
+		if (snapshotName.size() <= 6 || snapshotName.substr(snapshotName.size() - 6, snapshotName.size()) != ".msnap")
+		{
+			cout << "invalid snapshot filename: " << snapshotName << endl;
+			return;
+		}
+		for (int i = firstFile + 1; i < argc; i++)
 		{
 			std::string fileName = argv[i];
 			if (fileName.size() <= 5 || fileName.substr(fileName.size() - 5, fileName.size()) != ".emsl")
@@ -130,6 +451,74 @@ void compileFromArgs(int argc, char* argv[])
 			}
 			executables.push_back(fileName);
 		}
+		createSnapshot(executables, snapshotName, warmup);
+		return;
+	}
+	else if (command == "lex")
+	{
+		std::vector<std::string> fileNames;
+		for (int i = 2; i < argc; i++)
+		{
+			std::string fileName = argv[i];
+			if (fileName.size() <= 4 || fileName.substr(fileName.size() - 4, fileName.size()) != ".msl")
+			{
+				cout << "invalid filename: " << fileName << endl;
+				return;
+			}
+			fileNames.push_back(fileName);
+		}
+		benchmarkLexer(fileNames);
+		return;
+	}
+	else if (command == "link")
+	{
+		std::vector<std::string> keepNames;
+		std::string outputName;
+		for (int i = 2; i < argc; i++)
+		{
+			std::string fileName = argv[i];
+			if (fileName == "-keep" && i + 1 < argc)
+			{
+				keepNames.push_back(argv[++i]);
+				continue;
+			}
+			if (fileName.size() <= 5 || fileName.substr(fileName.size() - 5, fileName.size()) != ".emsl")
+			{
+				cout << "invalid filename: " << fileName << endl;
+				return;
+			}
+			if (outputName.empty())
+				outputName = fileName;
+			else
+				executables.push_back(fileName);
+		}
+		if (executables.empty())
+		{
+			cout << "no bytecode files to link" << endl;
+			return;
+		}
+		linkAssembly(executables, outputName, keepNames);
+		return;
+	}
+	else if (command == "run")
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			std::string fileName = argv[i];
+			if (fileName == "-stats" || fileName == "-jit") continue;
+			if (fileName == "-aot" && i + 1 < argc)
+			{
+				aotModules.push_back(argv[++i]);
+				continue;
+			}
+			bool isSnapshot = fileName.size() > 6 && fileName.substr(fileName.size() - 6, fileName.size()) == ".msnap";
+			if (!isSnapshot && (fileName.size() <= 5 || fileName.substr(fileName.size() - 5, fileName.size()) != ".emsl"))
+			{
+				cout << "invalid filename: " << fileName << endl;
+				return;
+			}
+			executables.push_back(fileName);
+		}
 	}
 
 	if (command == "vm" || command == "run")
@@ -137,11 +526,16 @@ void compileFromArgs(int argc, char* argv[])
 		MSL::VM::Configuration config;
 		config.streams = { &std::cin, &std::cout, &std::cerr };
 		config.GC.maxMemory = 128 * MSL::VM::MB;
+		if (printStats) config.quickening.log = &std::cout;
+		config.execution.useJit = useJit;
 		MSL::VM::VirtualMachine VM(move(config));
 		for (string& file : executables)
 		{
-			ifstream executable(file, ios::binary);
-			if (!VM.AddBytecodeFile(&executable)) return;
+			if (!VM.AddBytecodeFile(file)) return;
+		}
+		for (const string& module : aotModules)
+		{
+			if (!VM.LoadAotModule(module)) return;
 		}
 		cout << "launching MSL VM...\n\n";
 
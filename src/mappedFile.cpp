@@ -0,0 +1,97 @@
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace MSL
+{
+	namespace VM
+	{
+		MappedFile::~MappedFile()
+		{
+			Close();
+		}
+
+		bool MappedFile::Open(const std::string& fileName)
+		{
+			Close();
+			#ifdef _WIN32
+			HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return false;
+			fileHandle = file;
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+			{
+				Close();
+				return false;
+			}
+			HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping == nullptr)
+			{
+				Close();
+				return false;
+			}
+			mappingHandle = mapping;
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (view == nullptr)
+			{
+				Close();
+				return false;
+			}
+			data = static_cast<const uint8_t*>(view);
+			size = static_cast<size_t>(fileSize.QuadPart);
+			#else
+			int file = open(fileName.c_str(), O_RDONLY);
+			if (file < 0) return false;
+			struct stat fileStat;
+			if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+			{
+				close(file);
+				return false;
+			}
+			void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+			close(file); // mapping keeps its own reference to the file
+			if (view == MAP_FAILED) return false;
+			data = static_cast<const uint8_t*>(view);
+			size = static_cast<size_t>(fileStat.st_size);
+			#endif
+			return true;
+		}
+
+		void MappedFile::Close()
+		{
+			#ifdef _WIN32
+			if (data != nullptr) UnmapViewOfFile(data);
+			if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+			if (fileHandle != nullptr) CloseHandle(fileHandle);
+			mappingHandle = nullptr;
+			fileHandle = nullptr;
+			#else
+			if (data != nullptr) munmap(const_cast<uint8_t*>(data), size);
+			#endif
+			data = nullptr;
+			size = 0;
+		}
+
+		bool MappedFile::IsOpen() const
+		{
+			return data != nullptr;
+		}
+
+		const uint8_t* MappedFile::GetData() const
+		{
+			return data;
+		}
+
+		size_t MappedFile::GetSize() const
+		{
+			return size;
+		}
+	}
+}
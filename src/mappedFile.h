@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace MSL
+{
+	namespace VM
+	{
+		/*
+		read-only view of file mapped to memory. Pages of file are shared through OS page cache by all processes which map it
+		file is unmapped when object is destroyed, so data must not be referenced after it
+		AssemblyEditor decodes assembly directly from mapped pages, but copies strings (see AssemblyEditor::ReadString) and method bodies, which VM executes with fixed-size operands and rewrites by quickening
+		*/
+		class MappedFile
+		{
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			#ifdef _WIN32
+			void* fileHandle = nullptr;
+			void* mappingHandle = nullptr;
+			#endif
+
+			void Close();
+		public:
+			MappedFile() = default;
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+			~MappedFile();
+			/*
+			maps file with name provided, unmapping previous one. Returns false if file cannot be opened or mapped
+			*/
+			bool Open(const std::string& fileName);
+			/*
+			returns true if file is mapped. Empty files are never mapped
+			*/
+			bool IsOpen() const;
+			const uint8_t* GetData() const;
+			size_t GetSize() const;
+		};
+	}
+}
@@ -28,4 +28,26 @@ bool MSL::VM::MethodType::isStaticConstructor() const
 bool MSL::VM::MethodType::isEntryPoint() const
 {
 	return modifiers & Modifiers::ENTRY_POINT;
+}
+
+uint64_t MSL::VM::MethodType::GetBodyHash() const
+{
+	// FNV-1a hash
+	uint64_t hash = 14695981039346656037ull;
+	auto update = [&hash](const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	};
+	update(body.data(), body.size());
+	update(labels.data(), labels.size() * sizeof(size_t));
+	for (size_t i = 0; i < dependencies.size(); i++)
+	{
+		update(dependencies[i].c_str(), dependencies[i].size() + 1);
+	}
+	return hash;
 }
\ No newline at end of file
@@ -2,11 +2,17 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 namespace MSL
 {
 	namespace VM
 	{
+		struct ClassType;
+		struct JitMethod;
+		struct Frame;
+		class VirtualMachine;
+
 		struct MethodType
 		{
 			enum Modifiers
@@ -22,10 +28,81 @@ namespace MSL
 			using StringArray = std::vector<std::string>;
 			using ByteArray = std::vector<uint8_t>;
 			using LabelOffsetArray = std::vector<size_t>;
+			/*
+			strings of assembly symbol pool referenced by method (see AssemblyType::symbols), indexed by dependency hash
+			*/
+			class DependencyArray
+			{
+				std::vector<const std::string*> symbols;
+			public:
+				const std::string& operator[](size_t index) const { return *symbols[index]; }
+				size_t size() const { return symbols.size(); }
+				void reserve(size_t size) { symbols.reserve(size); }
+				void push_back(const std::string* symbol) { symbols.push_back(symbol); }
+			};
 			StringArray parameters;
-			StringArray dependencies;
+			DependencyArray dependencies;
 			LabelOffsetArray labels;
 			ByteArray body;
+			/*
+			method body in assembly image which is not decoded yet, body and labels are empty until then (see AssemblyEditor::DecodeMethodBody)
+			*/
+			mutable const uint8_t* encodedBody = nullptr;
+			mutable size_t encodedBodySize = 0;
+
+			/*
+			receiver class and its method resolved by CALL_METHOD instruction
+			*/
+			struct CallCache
+			{
+				const ClassType* receiver = nullptr;
+				const std::string* method = nullptr;
+				const MethodType* target = nullptr;
+			};
+			/*
+			runtime type feedback of VM quickening indexed by instruction offset. It is not a part of assembly
+			*/
+			mutable ByteArray feedback;
+			mutable std::unordered_map<size_t, CallCache> callCaches;
+			/*
+			number of invocations and loop back-edges executed by VM and native code compiled when it reaches JIT threshold
+			*/
+			mutable uint32_t hotness = 0;
+			mutable const JitMethod* jitMethod = nullptr;
+			/*
+			method body compiled ahead-of-time by AotTranslator. Executes method from frame offset and returns false if offset is not its entry
+			*/
+			using NativeMethod = bool(*)(VirtualMachine* vm, Frame* frame);
+			mutable NativeMethod aotMethod = nullptr;
+			/*
+			trivial method body recognized by VM at load time. Such method is executed at call site without creating a new frame
+			*/
+			enum class InlineKind : uint8_t
+			{
+				NONE, // method is called as usual
+				GETTER, // `return attribute;`
+				SETTER, // `attribute = parameter;`
+				RETURN_TRUE,
+				RETURN_FALSE,
+				RETURN_NULL,
+				RETURN_STRING, // `return "literal";`
+			};
+			mutable InlineKind inlineKind = InlineKind::NONE;
+			mutable const std::string* inlineOperand = nullptr; // attribute name or string literal
+			/*
+			try block of method body: errors of instructions in range [begin, end) are handled by code at label
+			*/
+			struct ExceptionHandler
+			{
+				size_t begin = 0;
+				size_t end = 0;
+				uint16_t label = 0;
+			};
+			/*
+			exception table built by VM from PUSH_CATCH / POP_CATCH pairs when it is first needed. Inner try blocks precede outer ones
+			*/
+			mutable std::vector<ExceptionHandler> exceptionTable;
+			mutable bool hasExceptionTable = false;
 
 			std::string name;
 			uint8_t modifiers = 0;
@@ -39,6 +116,10 @@ namespace MSL
 			bool isConstructor() const;
 			bool isStaticConstructor() const;
 			bool isEntryPoint() const;
+			/*
+			returns hash of method body, labels and dependencies. Native code is attached to method only if hashes are equal
+			*/
+			uint64_t GetBodyHash() const;
 		};
 	}
 }
\ No newline at end of file
@@ -25,6 +25,11 @@ namespace MSL
 			return classes;
 		}
 
+		Namespace::ClassArray& Namespace::GetMembers()
+		{
+			return classes;
+		}
+
 		bool Namespace::ContainsClass(const std::string& className) const
 		{
 			return table.find(className) != table.end();
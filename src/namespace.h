@@ -57,6 +57,10 @@ namespace MSL
 			*/
 			const ClassArray& GetMembers() const;
 			/*
+			returns reference to all classes in namespace
+			*/
+			ClassArray& GetMembers();
+			/*
 			checks if namespace already contains class with given name
 			*/
 			bool ContainsClass(const std::string& className) const;
@@ -217,7 +217,8 @@ namespace MSL
 		{
 			RET_IF_MARKED;
 			BaseObject::MarkMembers();
-			typeInstance->staticInstance->MarkMembers();
+			if (typeInstance->staticInstance != nullptr) // static state is allocated when class is first referenced
+				typeInstance->staticInstance->MarkMembers();
 		}
 
 		size_t ClassWrapper::GetSize() const
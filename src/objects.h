@@ -39,6 +39,7 @@ namespace MSL
 		{
 			Type type = Type::BASE;
 			GCstate state = GCstate::UNMARKED;
+			bool unique = false; // object is owned only by one local variable and can be modified in place
 
 			BaseObject(Type type);
 			virtual std::string ToString() const  = 0;
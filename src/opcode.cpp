@@ -1,5 +1,9 @@
 #include "opcode.h"
 #include "stringExtensions.h"
+#include <istream>
+#include <ostream>
+#include <cstring>
+#include <algorithm>
 
 namespace MSL
 {
@@ -64,9 +68,235 @@ namespace MSL
 			CASE_RETURN(RETURN);
 			CASE_RETURN(PUSH_CATCH);
 			CASE_RETURN(POP_CATCH);
+			CASE_RETURN(ITER_INIT);
+			CASE_RETURN(ITER_NEXT);
+			CASE_RETURN(LOAD_LOCAL);
+			CASE_RETURN(STORE_LOCAL);
+			CASE_RETURN(ASSEMBLY_VERSION_DECL);
+			CASE_RETURN(JUMP_IF_FALSE_KEEP);
+			CASE_RETURN(JUMP_IF_TRUE_KEEP);
+			CASE_RETURN(SUM_INT);
+			CASE_RETURN(SUB_INT);
+			CASE_RETURN(MULT_INT);
+			CASE_RETURN(CMP_EQ_INT);
+			CASE_RETURN(CMP_NEQ_INT);
+			CASE_RETURN(CMP_L_INT);
+			CASE_RETURN(CMP_G_INT);
+			CASE_RETURN(CMP_LE_INT);
+			CASE_RETURN(CMP_GE_INT);
+			CASE_RETURN(SUM_FLOAT);
+			CASE_RETURN(SUB_FLOAT);
+			CASE_RETURN(MULT_FLOAT);
+			CASE_RETURN(DIV_FLOAT);
+			CASE_RETURN(CMP_L_FLOAT);
+			CASE_RETURN(CMP_G_FLOAT);
+			CASE_RETURN(CMP_LE_FLOAT);
+			CASE_RETURN(CMP_GE_FLOAT);
+			CASE_RETURN(SUM_STRING);
+			CASE_RETURN(CALL_METHOD);
+			CASE_RETURN(TAIL_CALL);
+			CASE_RETURN(CONSTANT_POOL_DECL_SIZE);
 			default:
 				return "[[ unresolved symbol ]]";
 			}
 		}
+
+		OPCODE ToIntegerOpcode(OPCODE op)
+		{
+			switch (op)
+			{
+			case SUM_OP: return SUM_INT;
+			case SUB_OP: return SUB_INT;
+			case MULT_OP: return MULT_INT;
+			case CMP_EQ: return CMP_EQ_INT;
+			case CMP_NEQ: return CMP_NEQ_INT;
+			case CMP_L: return CMP_L_INT;
+			case CMP_G: return CMP_G_INT;
+			case CMP_LE: return CMP_LE_INT;
+			case CMP_GE: return CMP_GE_INT;
+			default: return op;
+			}
+		}
+
+		OPCODE ToFloatOpcode(OPCODE op)
+		{
+			switch (op)
+			{
+			case SUM_OP: return SUM_FLOAT;
+			case SUB_OP: return SUB_FLOAT;
+			case MULT_OP: return MULT_FLOAT;
+			case DIV_OP: return DIV_FLOAT;
+			case CMP_L: return CMP_L_FLOAT;
+			case CMP_G: return CMP_G_FLOAT;
+			case CMP_LE: return CMP_LE_FLOAT;
+			case CMP_GE: return CMP_GE_FLOAT;
+			default: return op;
+			}
+		}
+
+		OPCODE ToGenericOpcode(OPCODE op)
+		{
+			switch (op)
+			{
+			case SUM_INT: case SUM_FLOAT: case SUM_STRING: return SUM_OP;
+			case SUB_INT: case SUB_FLOAT: return SUB_OP;
+			case MULT_INT: case MULT_FLOAT: return MULT_OP;
+			case DIV_FLOAT: return DIV_OP;
+			case CMP_EQ_INT: return CMP_EQ;
+			case CMP_NEQ_INT: return CMP_NEQ;
+			case CMP_L_INT: case CMP_L_FLOAT: return CMP_L;
+			case CMP_G_INT: case CMP_G_FLOAT: return CMP_G;
+			case CMP_LE_INT: case CMP_LE_FLOAT: return CMP_LE;
+			case CMP_GE_INT: case CMP_GE_FLOAT: return CMP_GE;
+			case CALL_METHOD: return CALL_FUNCTION;
+			default: return op;
+			}
+		}
+
+		OperandLayout GetOperandLayout(OPCODE op)
+		{
+			OperandLayout layout;
+			switch (op)
+			{
+			case PUSH_STRING:
+			case PUSH_INTEGER:
+			case PUSH_FLOAT:
+			case PUSH_OBJECT:
+			case ALLOC_VAR:
+			case ALLOC_CONST_VAR:
+			case GET_MEMBER:
+			case LOAD_LOCAL:
+			case STORE_LOCAL:
+				layout.hashCount = 1;
+				break;
+			case CALL_FUNCTION:
+			case CALL_METHOD:
+			case TAIL_CALL:
+				layout.hashCount = 1;
+				layout.hasParamCount = true;
+				break;
+			case ITER_INIT:
+				layout.hashCount = 2;
+				break;
+			case ITER_NEXT:
+				layout.hashCount = 3;
+				layout.hasLabel = true;
+				break;
+			case SET_LABEL:
+			case PUSH_CATCH:
+			case JUMP:
+			case JUMP_IF_TRUE:
+			case JUMP_IF_FALSE:
+			case JUMP_IF_TRUE_KEEP:
+			case JUMP_IF_FALSE_KEEP:
+				layout.hasLabel = true;
+				break;
+			default:
+				break;
+			}
+			return layout;
+		}
+
+		void WriteVarint(std::ostream& out, uint64_t value)
+		{
+			do
+			{
+				uint8_t byte = value & 0x7F;
+				value >>= 7;
+				if (value != 0) byte |= 0x80;
+				out.put(static_cast<char>(byte));
+			} while (value != 0);
+		}
+
+		void WriteVarint(utils::ByteBuffer& out, uint64_t value)
+		{
+			do
+			{
+				uint8_t byte = value & 0x7F;
+				value >>= 7;
+				if (value != 0) byte |= 0x80;
+				out.Put(byte);
+			} while (value != 0);
+		}
+
+		static void EncodeLabels(const std::vector<std::pair<size_t, size_t>>& labels, size_t& next, size_t offset, utils::ByteBuffer& out)
+		{
+			for (; next < labels.size() && labels[next].first <= offset; next++)
+			{
+				out.Put(SET_LABEL);
+				WriteVarint(out, labels[next].second);
+			}
+		}
+
+		void EncodeMethodBody(const uint8_t* bytecode, size_t size, utils::ByteBuffer& out, const std::vector<size_t>* labels)
+		{
+			out.Reserve(out.GetSize() + size); // encoded body is usually shorter than the fixed-size one
+			std::vector<std::pair<size_t, size_t>> labelOffsets; // (offset, label) sorted by offset
+			if (labels != nullptr)
+			{
+				labelOffsets.reserve(labels->size());
+				for (size_t i = 0; i < labels->size(); i++)
+				{
+					labelOffsets.push_back({ (*labels)[i], i });
+				}
+				std::sort(labelOffsets.begin(), labelOffsets.end());
+			}
+			size_t nextLabel = 0;
+			size_t offset = 0;
+			while (offset < size)
+			{
+				EncodeLabels(labelOffsets, nextLabel, offset, out);
+				OPCODE op = static_cast<OPCODE>(bytecode[offset++]);
+				out.Put(op);
+				OperandLayout layout = GetOperandLayout(op);
+				for (uint8_t i = 0; i < layout.hashCount && offset + sizeof(size_t) <= size; i++)
+				{
+					size_t hash;
+					std::memcpy(&hash, &bytecode[offset], sizeof(size_t));
+					WriteVarint(out, hash);
+					offset += sizeof(size_t);
+				}
+				if (layout.hasParamCount && offset < size)
+				{
+					out.Put(bytecode[offset++]);
+				}
+				if (layout.hasLabel && offset + sizeof(uint16_t) <= size)
+				{
+					uint16_t label;
+					std::memcpy(&label, &bytecode[offset], sizeof(uint16_t));
+					WriteVarint(out, label);
+					offset += sizeof(uint16_t);
+				}
+			}
+			EncodeLabels(labelOffsets, nextLabel, size, out); // labels at the end of method body
+		}
+
+		bool ReadVarint(std::istream& in, uint64_t& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				int byte = in.get();
+				if (byte == std::char_traits<char>::eof()) return false;
+				if (shift == 63 && (byte & 0x7E) != 0) return false; // only one bit is left
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) return true;
+			}
+			return false;
+		}
+
+		bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (data == end) return false;
+				uint8_t byte = *data++;
+				if (shift == 63 && (byte & 0x7E) != 0) return false; // only one bit is left
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) return true;
+			}
+			return false;
+		}
 	}
 }
\ No newline at end of file
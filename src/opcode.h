@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <string>
+#include <iosfwd>
+
+#include "byteBuffer.h"
 
 namespace MSL
 {
@@ -65,8 +68,82 @@ namespace MSL
 			JUMP_IF_TRUE, // pops stack top. if true -> jumps by label index, else does nothing
 			JUMP_IF_FALSE, // pops stack top. if false -> jumps by label index, else does nothing
 			POP_STACK_TOP, // pops top of the stack
-			PUSH_CATCH, // pushes new catch handler on top of exception stack
-			POP_CATCH, // pops top catch handler from exception stack
+			PUSH_CATCH, // marks begin of try block with catch handler label, VM finds it in exception table of method
+			POP_CATCH, // marks end of try block
+			ITER_INIT, // pops container from the stack and stores it with its begin iterator into two locals provided
+			ITER_NEXT, // assigns current element of container to local provided and moves iterator forward. If container is ended -> jumps by label index
+			LOAD_LOCAL, // pushes value of local variable or parameter resolved by compiler. Falls back to PUSH_OBJECT if local was not declared yet
+			STORE_LOCAL, // pops value and assigns it to local variable resolved by compiler. Pushes assigned value
+			ASSEMBLY_VERSION_DECL, // declares version of bytecode format with uint16_t following by this opcode
+			JUMP_IF_FALSE_KEEP, // if stack top is FALSE -> jumps by label index keeping it on the stack, else does nothing. Used for short-circuit `&&`
+			JUMP_IF_TRUE_KEEP, // if stack top is TRUE -> jumps by label index keeping it on the stack, else does nothing. Used for short-circuit `||`
+			SUM_INT, // same as SUM_OP, but both operands are inferred as Integer by compiler. Falls back to SUM_OP if they are not
+			SUB_INT, // same as SUB_OP for operands inferred as Integer
+			MULT_INT, // same as MULT_OP for operands inferred as Integer
+			CMP_EQ_INT, // same as CMP_EQ for operands inferred as Integer
+			CMP_NEQ_INT, // same as CMP_NEQ for operands inferred as Integer
+			CMP_L_INT, // same as CMP_L for operands inferred as Integer
+			CMP_G_INT, // same as CMP_G for operands inferred as Integer
+			CMP_LE_INT, // same as CMP_LE for operands inferred as Integer
+			CMP_GE_INT, // same as CMP_GE for operands inferred as Integer
+			SUM_FLOAT, // same as SUM_OP, but both operands are inferred as Float by compiler. Falls back to SUM_OP if they are not
+			SUB_FLOAT, // same as SUB_OP for operands inferred as Float
+			MULT_FLOAT, // same as MULT_OP for operands inferred as Float
+			DIV_FLOAT, // same as DIV_OP for operands inferred as Float
+			CMP_L_FLOAT, // same as CMP_L for operands inferred as Float
+			CMP_G_FLOAT, // same as CMP_G for operands inferred as Float
+			CMP_LE_FLOAT, // same as CMP_LE for operands inferred as Float
+			CMP_GE_FLOAT, // same as CMP_GE for operands inferred as Float
+			SUM_STRING, // same as SUM_OP for two String operands. Produced only by VM quickening and never stored in assembly
+			CALL_METHOD, // same as CALL_FUNCTION, but method of receiver class is taken from inline cache. Produced only by VM quickening
+			TAIL_CALL, // same as CALL_FUNCTION followed by POP_TO_RETURN. Called method reuses frame of the caller if it has no active exception handlers
+			CONSTANT_POOL_DECL_SIZE, // declares assembly string pool with size following by this opcode. Method dependencies are indices in it
+		};
+
+		/*
+		version of bytecode format written by compiler. Assemblies without ASSEMBLY_VERSION_DECL are treated as version 1
+		version 2: LOAD_LOCAL and STORE_LOCAL instructions
+		version 3: JUMP_IF_FALSE_KEEP and JUMP_IF_TRUE_KEEP instructions
+		version 4: type-specialized ALU instructions (SUM_INT, CMP_L_FLOAT, ...)
+		version 5: TAIL_CALL instruction
+		version 6: compact format. File starts with BYTECODE_MAGIC and version instead of ASSEMBLY_VERSION_DECL,
+		           pool sizes, string sizes, dependency hashes and labels are written as LEB128 integers
+		version 7: CONSTANT_POOL_DECL_SIZE. Strings of all methods are stored once per assembly with escape sequences replaced,
+		           method dependency pool contains their indices
+		version 8: METHOD_BODY_BEGIN_DECL is followed by LEB128 size of method body, so loader can skip it and decode it on first call
+		*/
+		constexpr uint16_t BYTECODE_VERSION = 8;
+		/*
+		first version of compact bytecode format. Older assemblies are read with fixed-size operands
+		*/
+		constexpr uint16_t COMPACT_BYTECODE_VERSION = 6;
+		/*
+		first version of bytecode format with assembly constant pool
+		*/
+		constexpr uint16_t CONSTANT_POOL_BYTECODE_VERSION = 7;
+		/*
+		first version of bytecode format in which size of method body is written before it
+		*/
+		constexpr uint16_t BODY_SIZE_BYTECODE_VERSION = 8;
+		/*
+		first bytes of assembly file in compact format. Its first byte differs from ASSEMBLY_BEGIN_DECL, which starts older assemblies
+		*/
+		constexpr uint8_t BYTECODE_MAGIC[] = { 0x7F, 'M', 'S', 'L' };
+		/*
+		first bytes of assembly snapshot written by AssemblyEditor::WriteSnapshot(). Snapshot stores method bodies in the format VM executes them,
+		so it is valid only for the same BYTECODE_VERSION and size of hash operands (size_t)
+		*/
+		constexpr uint8_t SNAPSHOT_MAGIC[] = { 0x7F, 'M', 'S', 'S' };
+		constexpr uint16_t SNAPSHOT_VERSION = 2; // version 2: static state of VM follows assembly
+
+		/*
+		operands which follow opcode in method body: dependency hashes, then parameter count and label
+		*/
+		struct OperandLayout
+		{
+			uint8_t hashCount = 0;
+			bool hasParamCount = false;
+			bool hasLabel = false;
 		};
 
 		/*
@@ -74,6 +151,43 @@ namespace MSL
 		*/
 		std::string ToString(OPCODE op);
 		/*
+		returns ALU opcode specialized for two Integer operands or the same opcode if there is no such
+		*/
+		OPCODE ToIntegerOpcode(OPCODE op);
+		/*
+		returns ALU opcode specialized for two Float operands or the same opcode if there is no such
+		*/
+		OPCODE ToFloatOpcode(OPCODE op);
+		/*
+		returns generic opcode for type-specialized one or the same opcode if it is not specialized
+		*/
+		OPCODE ToGenericOpcode(OPCODE op);
+		/*
+		returns operands of instruction in method body (see OperandLayout)
+		*/
+		OperandLayout GetOperandLayout(OPCODE op);
+		/*
+		writes unsigned integer in LEB128 format: 7 bits per byte, high bit is set in all bytes except the last one
+		*/
+		void WriteVarint(std::ostream& out, uint64_t value);
+		/*
+		writes unsigned integer in LEB128 format to the end of buffer
+		*/
+		void WriteVarint(utils::ByteBuffer& out, uint64_t value);
+		/*
+		reads unsigned integer in LEB128 format. Returns false if stream ended or value does not fit in 64 bits
+		*/
+		bool ReadVarint(std::istream& in, uint64_t& value);
+		/*
+		reads unsigned integer in LEB128 format from memory range [data, end), moving data past it. Returns false if range ended or value does not fit in 64 bits
+		*/
+		bool ReadVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value);
+		/*
+		writes method body with fixed-size operands, as VM executes it, with its operands compacted to LEB128 integers.
+		If label offsets of decoded method are provided, SET_LABEL instruction is written at each of them
+		*/
+		void EncodeMethodBody(const uint8_t* bytecode, size_t size, utils::ByteBuffer& out, const std::vector<size_t>* labels = nullptr);
+		/*
 		Array of opcodes
 		*/
 		typedef std::vector<OPCODE> InstructionVector;
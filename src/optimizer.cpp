@@ -0,0 +1,1033 @@
+#include "optimizer.h"
+#include "assembly.h"
+#include "bigInteger.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cmath>
+
+namespace MSL
+{
+	namespace compiler
+	{
+		using namespace VM;
+
+		/*
+		returns number of hashes which follow opcode in bytecode or -1 if opcode is not an instruction
+		*/
+		static int GetHashOperandCount(OPCODE op)
+		{
+			switch (op)
+			{
+			case OPCODE::PUSH_STRING:
+			case OPCODE::PUSH_INTEGER:
+			case OPCODE::PUSH_FLOAT:
+			case OPCODE::PUSH_OBJECT:
+			case OPCODE::ALLOC_VAR:
+			case OPCODE::ALLOC_CONST_VAR:
+			case OPCODE::GET_MEMBER:
+			case OPCODE::CALL_FUNCTION:
+			case OPCODE::TAIL_CALL:
+			case OPCODE::LOAD_LOCAL:
+			case OPCODE::STORE_LOCAL:
+				return 1;
+			case OPCODE::ITER_INIT:
+				return 2;
+			case OPCODE::ITER_NEXT:
+				return 3;
+			case OPCODE::PUSH_THIS:
+			case OPCODE::PUSH_NULL:
+			case OPCODE::PUSH_TRUE:
+			case OPCODE::PUSH_FALSE:
+			case OPCODE::POP_TO_RETURN:
+			case OPCODE::NEGATION_OP:
+			case OPCODE::NEGATIVE_OP:
+			case OPCODE::POSITIVE_OP:
+			case OPCODE::SUM_OP:
+			case OPCODE::SUB_OP:
+			case OPCODE::MULT_OP:
+			case OPCODE::DIV_OP:
+			case OPCODE::MOD_OP:
+			case OPCODE::POWER_OP:
+			case OPCODE::ASSIGN_OP:
+			case OPCODE::SET_ALU_INCR:
+			case OPCODE::CMP_EQ:
+			case OPCODE::CMP_NEQ:
+			case OPCODE::CMP_L:
+			case OPCODE::CMP_G:
+			case OPCODE::CMP_LE:
+			case OPCODE::CMP_GE:
+			case OPCODE::CMP_AND:
+			case OPCODE::CMP_OR:
+			case OPCODE::GET_INDEX:
+			case OPCODE::RETURN:
+			case OPCODE::SET_LABEL:
+			case OPCODE::JUMP:
+			case OPCODE::JUMP_IF_TRUE:
+			case OPCODE::JUMP_IF_FALSE:
+			case OPCODE::JUMP_IF_FALSE_KEEP:
+			case OPCODE::JUMP_IF_TRUE_KEEP:
+			case OPCODE::POP_STACK_TOP:
+			case OPCODE::PUSH_CATCH:
+			case OPCODE::POP_CATCH:
+			case OPCODE::SUM_INT:
+			case OPCODE::SUB_INT:
+			case OPCODE::MULT_INT:
+			case OPCODE::CMP_EQ_INT:
+			case OPCODE::CMP_NEQ_INT:
+			case OPCODE::CMP_L_INT:
+			case OPCODE::CMP_G_INT:
+			case OPCODE::CMP_LE_INT:
+			case OPCODE::CMP_GE_INT:
+			case OPCODE::SUM_FLOAT:
+			case OPCODE::SUB_FLOAT:
+			case OPCODE::MULT_FLOAT:
+			case OPCODE::DIV_FLOAT:
+			case OPCODE::CMP_L_FLOAT:
+			case OPCODE::CMP_G_FLOAT:
+			case OPCODE::CMP_LE_FLOAT:
+			case OPCODE::CMP_GE_FLOAT:
+				return 0;
+			default:
+				return -1;
+			}
+		}
+
+		/*
+		checks if label index follows opcode in bytecode
+		*/
+		static bool HasLabelOperand(OPCODE op)
+		{
+			return op == OPCODE::SET_LABEL || op == OPCODE::PUSH_CATCH || op == OPCODE::JUMP ||
+				op == OPCODE::JUMP_IF_TRUE || op == OPCODE::JUMP_IF_FALSE || op == OPCODE::ITER_NEXT ||
+				op == OPCODE::JUMP_IF_FALSE_KEEP || op == OPCODE::JUMP_IF_TRUE_KEEP;
+		}
+
+		/*
+		checks if instruction can transfer control to its label
+		*/
+		static bool IsLabelReference(OPCODE op)
+		{
+			return HasLabelOperand(op) && op != OPCODE::SET_LABEL;
+		}
+
+		/*
+		checks if instruction pushes constant which is known at compile time
+		*/
+		static bool IsConstantPush(OPCODE op)
+		{
+			return op == OPCODE::PUSH_INTEGER || op == OPCODE::PUSH_FLOAT || op == OPCODE::PUSH_STRING ||
+				op == OPCODE::PUSH_TRUE || op == OPCODE::PUSH_FALSE || op == OPCODE::PUSH_NULL;
+		}
+
+		/*
+		checks if instruction only pushes object on stack and has no other side effects
+		*/
+		static bool IsPurePush(OPCODE op)
+		{
+			return IsConstantPush(op) || op == OPCODE::PUSH_OBJECT || op == OPCODE::LOAD_LOCAL || op == OPCODE::PUSH_THIS;
+		}
+
+		/*
+		checks if next instruction can not be reached from this one
+		*/
+		static bool EndsControlFlow(OPCODE op)
+		{
+			return op == OPCODE::JUMP || op == OPCODE::RETURN || op == OPCODE::POP_TO_RETURN;
+		}
+
+		static bool IsBoolean(OPCODE op)
+		{
+			return op == OPCODE::PUSH_TRUE || op == OPCODE::PUSH_FALSE;
+		}
+
+		static OPCODE PushBoolean(bool value)
+		{
+			return value ? OPCODE::PUSH_TRUE : OPCODE::PUSH_FALSE;
+		}
+
+		/*
+		evaluates comparison the same way as VM does for primitive types. Returns false if op is not a comparison
+		*/
+		template<typename T>
+		static bool EvaluateComparison(OPCODE op, const T& lhs, const T& rhs, bool& result)
+		{
+			switch (op)
+			{
+			case OPCODE::CMP_EQ:
+				result = lhs == rhs;
+				return true;
+			case OPCODE::CMP_NEQ:
+				result = lhs != rhs;
+				return true;
+			case OPCODE::CMP_L:
+				result = lhs < rhs;
+				return true;
+			case OPCODE::CMP_G:
+				result = lhs > rhs;
+				return true;
+			case OPCODE::CMP_LE:
+				result = lhs <= rhs;
+				return true;
+			case OPCODE::CMP_GE:
+				result = lhs >= rhs;
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		static bool EvaluateIntegers(OPCODE op, const std::string& lhs, const std::string& rhs, OPCODE& resultType, std::string& result)
+		{
+			momo::big_integer a(lhs), b(rhs), value;
+			if (a.is_inf() || b.is_inf()) return false;
+
+			bool comparison = false;
+			if (EvaluateComparison(op, a, b, comparison))
+			{
+				resultType = PushBoolean(comparison);
+				return true;
+			}
+			switch (op)
+			{
+			case OPCODE::SUM_OP:
+				value = a + b;
+				break;
+			case OPCODE::SUB_OP:
+				value = a - b;
+				break;
+			case OPCODE::MULT_OP:
+				value = a * b;
+				break;
+			case OPCODE::DIV_OP:
+				if (b.is_zero()) return false; // division by zero is left to the runtime
+				value = a / b;
+				break;
+			case OPCODE::MOD_OP:
+				if (b.is_zero()) return false;
+				value = a % b;
+				break;
+			case OPCODE::POWER_OP:
+			{
+				// huge powers would bloat the dependency pool, so only small results are folded
+				const size_t maxResultDigits = 1024;
+				if (b < 0 || b > momo::big_integer(static_cast<int>(maxResultDigits))) return false;
+				unsigned long long power = static_cast<unsigned long long>(b.to_double());
+				if (a.chars_size() * power > maxResultDigits) return false;
+				value = momo::pow(a, power);
+				break;
+			}
+			default:
+				return false;
+			}
+			if (value.is_inf()) return false;
+			resultType = OPCODE::PUSH_INTEGER;
+			result = value.to_string();
+			return true;
+		}
+
+		static bool EvaluateFloats(OPCODE op, const std::string& lhs, const std::string& rhs, OPCODE& resultType, std::string& result)
+		{
+			// VM parses float constants with std::stod, so the same conversion is used here
+			double a = std::stod(lhs), b = std::stod(rhs), value = 0.0;
+
+			bool comparison = false;
+			if (EvaluateComparison(op, a, b, comparison))
+			{
+				resultType = PushBoolean(comparison);
+				return true;
+			}
+			switch (op)
+			{
+			case OPCODE::SUM_OP:
+				value = a + b;
+				break;
+			case OPCODE::SUB_OP:
+				value = a - b;
+				break;
+			case OPCODE::MULT_OP:
+				value = a * b;
+				break;
+			case OPCODE::DIV_OP:
+				value = a / b;
+				break;
+			case OPCODE::POWER_OP:
+				value = std::pow(a, b);
+				break;
+			default:
+				return false;
+			}
+			if (!std::isfinite(value)) return false;
+
+			// shortest representation which is parsed back by std::stod to the same value
+			char buffer[32];
+			auto conversion = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			if (conversion.ec != std::errc()) return false;
+			resultType = OPCODE::PUSH_FLOAT;
+			result.assign(buffer, conversion.ptr);
+			return true;
+		}
+
+		/*
+		computes result of binary operation over two constants. Returns false if it must be left to the runtime
+		*/
+		static bool EvaluateBinary(OPCODE op, OPCODE lhsType, const std::string& lhs, OPCODE rhsType, const std::string& rhs, OPCODE& resultType, std::string& result)
+		{
+			if (lhsType == OPCODE::PUSH_INTEGER && rhsType == OPCODE::PUSH_INTEGER)
+			{
+				return EvaluateIntegers(op, lhs, rhs, resultType, result);
+			}
+			if (lhsType == OPCODE::PUSH_FLOAT && rhsType == OPCODE::PUSH_FLOAT)
+			{
+				return EvaluateFloats(op, lhs, rhs, resultType, result);
+			}
+			if (lhsType == OPCODE::PUSH_STRING && rhsType == OPCODE::PUSH_STRING && op == OPCODE::SUM_OP)
+			{
+				// escape tokens are replaced only when assembly is loaded, so they must not be split by concatenation
+				if (lhs.find('\\') != std::string::npos || rhs.find('\\') != std::string::npos) return false;
+				resultType = OPCODE::PUSH_STRING;
+				result = lhs + rhs;
+				return true;
+			}
+			if (IsBoolean(lhsType) && IsBoolean(rhsType))
+			{
+				bool a = lhsType == OPCODE::PUSH_TRUE, b = rhsType == OPCODE::PUSH_TRUE;
+				switch (op)
+				{
+				case OPCODE::CMP_EQ:
+					resultType = PushBoolean(a == b);
+					return true;
+				case OPCODE::CMP_NEQ:
+					resultType = PushBoolean(a != b);
+					return true;
+				case OPCODE::CMP_AND:
+					resultType = PushBoolean(a && b);
+					return true;
+				case OPCODE::CMP_OR:
+					resultType = PushBoolean(a || b);
+					return true;
+				default:
+					return false;
+				}
+			}
+			return false;
+		}
+
+		/*
+		computes result of unary operation over constant. Returns false if it must be left to the runtime
+		*/
+		static bool EvaluateUnary(OPCODE op, OPCODE type, const std::string& value, OPCODE& resultType, std::string& result)
+		{
+			if (type == OPCODE::PUSH_INTEGER)
+			{
+				momo::big_integer a(value);
+				if (a.is_inf()) return false;
+				switch (op)
+				{
+				case OPCODE::NEGATION_OP:
+					resultType = PushBoolean(a.is_zero());
+					return true;
+				case OPCODE::NEGATIVE_OP:
+					resultType = OPCODE::PUSH_INTEGER;
+					result = (-a).to_string();
+					return true;
+				case OPCODE::POSITIVE_OP:
+					resultType = OPCODE::PUSH_INTEGER;
+					result = value;
+					return true;
+				default:
+					return false;
+				}
+			}
+			if (type == OPCODE::PUSH_FLOAT && op == OPCODE::POSITIVE_OP)
+			{
+				resultType = OPCODE::PUSH_FLOAT;
+				result = value;
+				return true;
+			}
+			if (IsBoolean(type) && op == OPCODE::NEGATION_OP)
+			{
+				resultType = PushBoolean(type == OPCODE::PUSH_FALSE);
+				return true;
+			}
+			return false;
+		}
+
+		/*
+		type of value inferred by Optimizer::SpecializeArithmetic(). UNDEFINED is used until any assignment is found
+		*/
+		enum class InferredType : uint8_t
+		{
+			UNDEFINED,
+			INTEGER,
+			FLOAT,
+			BOOLEAN,
+			OTHER,
+		};
+
+		static InferredType JoinTypes(InferredType t1, InferredType t2)
+		{
+			if (t1 == InferredType::UNDEFINED) return t2;
+			if (t2 == InferredType::UNDEFINED || t1 == t2) return t1;
+			return InferredType::OTHER;
+		}
+
+		static bool IsNumeric(InferredType type)
+		{
+			return type == InferredType::INTEGER || type == InferredType::FLOAT;
+		}
+
+		/*
+		infers result type of ALU operation the same way as VM computes it for primitive types
+		*/
+		static InferredType InferBinaryResult(OPCODE op, InferredType lhs, InferredType rhs)
+		{
+			if (lhs == InferredType::UNDEFINED || rhs == InferredType::UNDEFINED) return InferredType::UNDEFINED;
+			switch (op)
+			{
+			case OPCODE::SUM_OP:
+			case OPCODE::SUB_OP:
+			case OPCODE::MULT_OP:
+			case OPCODE::DIV_OP:
+			case OPCODE::POWER_OP:
+				if (lhs == InferredType::INTEGER && rhs == InferredType::INTEGER) return InferredType::INTEGER;
+				if (IsNumeric(lhs) && IsNumeric(rhs)) return InferredType::FLOAT;
+				return InferredType::OTHER;
+			case OPCODE::MOD_OP:
+				if (lhs == InferredType::INTEGER && rhs == InferredType::INTEGER) return InferredType::INTEGER;
+				return InferredType::OTHER;
+			case OPCODE::CMP_EQ:
+			case OPCODE::CMP_NEQ:
+			case OPCODE::CMP_L:
+			case OPCODE::CMP_G:
+			case OPCODE::CMP_LE:
+			case OPCODE::CMP_GE:
+				return IsNumeric(lhs) && IsNumeric(rhs) ? InferredType::BOOLEAN : InferredType::OTHER;
+			case OPCODE::CMP_AND:
+			case OPCODE::CMP_OR:
+				return lhs == InferredType::BOOLEAN && rhs == InferredType::BOOLEAN ? InferredType::BOOLEAN : InferredType::OTHER;
+			default:
+				return InferredType::OTHER;
+			}
+		}
+
+		std::string Optimizer::Report::ToString() const
+		{
+			return std::to_string(instructionsBefore - instructionsAfter) + " of " + std::to_string(instructionsBefore) +
+				" instructions removed (constants folded: " + std::to_string(constantsFolded) +
+				", constants propagated: " + std::to_string(constantsPropagated) +
+				", dead code: " + std::to_string(deadInstructions) +
+				", jumps threaded: " + std::to_string(jumpsThreaded) +
+				", peephole: " + std::to_string(peepholeInstructions) +
+				"), " + std::to_string(instructionsSpecialized) + " instructions specialized";
+		}
+
+		bool Optimizer::Decode(const utils::ByteBuffer& bytecode, InstructionArray& code) const
+		{
+			const uint8_t* data = bytecode.GetData();
+			const size_t size = bytecode.GetSize();
+			size_t offset = 0;
+			auto ReadOperand = [data, size, &offset](void* operand, size_t operandSize)
+			{
+				if (offset + operandSize > size) return false;
+				std::memcpy(operand, data + offset, operandSize);
+				offset += operandSize;
+				return true;
+			};
+
+			while (offset < size)
+			{
+				Instruction instruction = { };
+				instruction.op = static_cast<OPCODE>(data[offset++]);
+				int hashCount = GetHashOperandCount(instruction.op);
+				if (hashCount < 0) return false;
+
+				for (int i = 0; i < hashCount; i++)
+				{
+					if (!ReadOperand(&instruction.hash[i], sizeof(size_t))) return false;
+				}
+				if ((instruction.op == OPCODE::CALL_FUNCTION || instruction.op == OPCODE::TAIL_CALL) &&
+					!ReadOperand(&instruction.paramCount, sizeof(uint8_t))) return false;
+				if (HasLabelOperand(instruction.op) &&
+					!ReadOperand(&instruction.label, sizeof(uint16_t))) return false;
+
+				code.push_back(instruction);
+			}
+			return true;
+		}
+
+		void Optimizer::Encode(const InstructionArray& code, Method& method) const
+		{
+			utils::ByteBuffer& out = method.bytecode;
+			out.Clear(); // memory of the original body is reused
+			for (const Instruction& instruction : code)
+			{
+				out.Write(instruction.op);
+				int hashCount = GetHashOperandCount(instruction.op);
+				for (int i = 0; i < hashCount; i++)
+				{
+					out.Write(instruction.hash[i]);
+				}
+				if (instruction.op == OPCODE::CALL_FUNCTION || instruction.op == OPCODE::TAIL_CALL)
+				{
+					out.Write(instruction.paramCount);
+				}
+				if (HasLabelOperand(instruction.op))
+				{
+					out.Write(instruction.label);
+				}
+			}
+		}
+
+		bool Optimizer::FoldConstants(InstructionArray& code, Method& method)
+		{
+			// instructions are folded on the tail of the result, so nested expressions like `1 + 2 * 3` collapse in one pass
+			InstructionArray folded;
+			folded.reserve(code.size());
+			size_t removed = 0;
+
+			auto ConstantValue = [&method](const Instruction& instruction) -> std::string
+			{
+				bool hasValue = instruction.op == OPCODE::PUSH_INTEGER ||
+					instruction.op == OPCODE::PUSH_FLOAT || instruction.op == OPCODE::PUSH_STRING;
+				return hasValue ? method.GetVariables()[instruction.hash[0]] : std::string();
+			};
+			auto MakeConstant = [&method](OPCODE type, const std::string& value)
+			{
+				Instruction instruction = { };
+				instruction.op = type;
+				if (type == OPCODE::PUSH_INTEGER || type == OPCODE::PUSH_FLOAT || type == OPCODE::PUSH_STRING)
+				{
+					method.InsertDependency(value);
+					instruction.hash[0] = method.GetHash(value);
+				}
+				return instruction;
+			};
+
+			for (const Instruction& instruction : code)
+			{
+				size_t size = folded.size();
+				OPCODE resultType = OPCODE::ERROR_SYMBOL;
+				std::string result;
+
+				if (size >= 2 && IsConstantPush(folded[size - 1].op) && IsConstantPush(folded[size - 2].op) &&
+					EvaluateBinary(instruction.op,
+						folded[size - 2].op, ConstantValue(folded[size - 2]),
+						folded[size - 1].op, ConstantValue(folded[size - 1]),
+						resultType, result))
+				{
+					folded.pop_back();
+					folded.back() = MakeConstant(resultType, result);
+					removed += 2;
+					continue;
+				}
+				if (size >= 1 && IsConstantPush(folded[size - 1].op) &&
+					EvaluateUnary(instruction.op, folded[size - 1].op, ConstantValue(folded[size - 1]), resultType, result))
+				{
+					folded.back() = MakeConstant(resultType, result);
+					removed += 1;
+					continue;
+				}
+				if (size >= 1 && IsBoolean(folded[size - 1].op) &&
+					(instruction.op == OPCODE::JUMP_IF_TRUE || instruction.op == OPCODE::JUMP_IF_FALSE))
+				{
+					bool predicate = folded[size - 1].op == OPCODE::PUSH_TRUE;
+					bool jumpIfTrue = instruction.op == OPCODE::JUMP_IF_TRUE;
+					if (predicate == jumpIfTrue)
+					{
+						folded.back() = instruction;
+						folded.back().op = OPCODE::JUMP;
+						removed += 1;
+					}
+					else
+					{
+						folded.pop_back();
+						removed += 2;
+					}
+					continue;
+				}
+				if (size >= 1 && IsBoolean(folded[size - 1].op) &&
+					(instruction.op == OPCODE::JUMP_IF_TRUE_KEEP || instruction.op == OPCODE::JUMP_IF_FALSE_KEEP))
+				{
+					// short-circuit over constant: Boolean stays on the stack in both cases
+					bool predicate = folded[size - 1].op == OPCODE::PUSH_TRUE;
+					if (predicate == (instruction.op == OPCODE::JUMP_IF_TRUE_KEEP))
+					{
+						folded.push_back(instruction);
+						folded.back().op = OPCODE::JUMP;
+					}
+					else
+					{
+						removed += 1;
+					}
+					continue;
+				}
+				folded.push_back(instruction);
+			}
+			code.swap(folded);
+			report.constantsFolded += removed;
+			return removed != 0;
+		}
+
+		bool Optimizer::PropagateConstants(InstructionArray& code, Method& method)
+		{
+			// the same name can be stored by several hashes (used before declaration), so locals are tracked by name
+			const auto& variables = method.GetVariables();
+			std::unordered_map<std::string, size_t> declarations;
+			std::unordered_map<uint16_t, size_t> labels;
+			for (size_t i = 0; i < code.size(); i++)
+			{
+				const Instruction& instruction = code[i];
+				if (instruction.op == OPCODE::ALLOC_VAR || instruction.op == OPCODE::ALLOC_CONST_VAR)
+					declarations[variables[instruction.hash[0]]]++;
+				else if (instruction.op == OPCODE::ITER_NEXT || instruction.op == OPCODE::STORE_LOCAL)
+					declarations[variables[instruction.hash[0]]] += 2; // local is reassigned
+				else if (instruction.op == OPCODE::SET_LABEL)
+					labels[instruction.label] = i;
+			}
+
+			size_t propagated = 0;
+			for (size_t i = 0; i + 2 < code.size(); i++)
+			{
+				// `const x = [constant];` which is the only declaration of x in method
+				if (code[i].op != OPCODE::ALLOC_CONST_VAR || declarations[variables[code[i].hash[0]]] != 1) continue;
+				if (!IsConstantPush(code[i + 1].op) || code[i + 1].op == OPCODE::PUSH_NULL) continue; // const null can be reassigned
+				if (code[i + 2].op != OPCODE::ASSIGN_OP) continue;
+
+				const std::string& name = variables[code[i].hash[0]];
+				if (std::find(method.params.begin(), method.params.end(), name) != method.params.end()) continue;
+				auto IsUse = [&variables, &name](const Instruction& instruction)
+				{
+					return (instruction.op == OPCODE::PUSH_OBJECT || instruction.op == OPCODE::LOAD_LOCAL) &&
+						variables[instruction.hash[0]] == name;
+				};
+
+				// declaration must be executed before every use: no uses before it and no jumps over it
+				bool dominates = true;
+				for (size_t j = 0; j < code.size() && dominates; j++)
+				{
+					const Instruction& instruction = code[j];
+					if (j < i && IsUse(instruction))
+					{
+						dominates = false;
+					}
+					else if (IsLabelReference(instruction.op))
+					{
+						auto target = labels.find(instruction.label);
+						dominates = target != labels.end() && !(j < i && target->second > i);
+					}
+				}
+				if (!dominates) continue;
+
+				Instruction constant = code[i + 1];
+				for (size_t j = i + 3; j < code.size(); j++)
+				{
+					if (IsUse(code[j]))
+					{
+						code[j] = constant;
+						propagated++;
+					}
+				}
+			}
+			report.constantsPropagated += propagated;
+			return propagated != 0;
+		}
+
+		bool Optimizer::RemoveDeadCode(InstructionArray& code)
+		{
+			size_t sizeBefore = code.size();
+			bool changed = true;
+			// removing code can make labels unreferenced, which can make more code unreachable
+			while (changed)
+			{
+				std::unordered_set<uint16_t> referenced;
+				for (const Instruction& instruction : code)
+				{
+					if (IsLabelReference(instruction.op)) referenced.insert(instruction.label);
+				}
+
+				InstructionArray live;
+				live.reserve(code.size());
+				bool reachable = true;
+				for (const Instruction& instruction : code)
+				{
+					if (instruction.op == OPCODE::SET_LABEL)
+					{
+						if (referenced.find(instruction.label) == referenced.end()) continue;
+						reachable = true;
+					}
+					// end of try block is kept even if it is unreachable, as VM builds exception table from it
+					if (!reachable && instruction.op != OPCODE::POP_CATCH) continue;
+
+					live.push_back(instruction);
+					if (EndsControlFlow(instruction.op)) reachable = false;
+				}
+				changed = live.size() != code.size();
+				code.swap(live);
+			}
+			report.deadInstructions += sizeBefore - code.size();
+			return sizeBefore != code.size();
+		}
+
+		bool Optimizer::ThreadJumps(InstructionArray& code)
+		{
+			std::unordered_map<uint16_t, size_t> labels;
+			for (size_t i = 0; i < code.size(); i++)
+			{
+				if (code[i].op == OPCODE::SET_LABEL) labels[code[i].label] = i;
+			}
+			// returns index of first instruction executed after jump to label
+			auto JumpDestination = [&code, &labels](uint16_t label)
+			{
+				auto it = labels.find(label);
+				if (it == labels.end()) return code.size();
+				size_t position = it->second;
+				while (position < code.size() && code[position].op == OPCODE::SET_LABEL) position++;
+				return position;
+			};
+
+			size_t threaded = 0;
+			for (Instruction& instruction : code)
+			{
+				if (instruction.op != OPCODE::JUMP && instruction.op != OPCODE::JUMP_IF_TRUE && instruction.op != OPCODE::JUMP_IF_FALSE &&
+					instruction.op != OPCODE::JUMP_IF_TRUE_KEEP && instruction.op != OPCODE::JUMP_IF_FALSE_KEEP)
+					continue;
+
+				// follow chain of unconditional jumps. Number of steps is limited to break infinite loops
+				uint16_t target = instruction.label;
+				for (size_t steps = 0; steps < labels.size(); steps++)
+				{
+					size_t destination = JumpDestination(target);
+					if (destination >= code.size() || code[destination].op != OPCODE::JUMP) break;
+					target = code[destination].label;
+				}
+				if (target != instruction.label)
+				{
+					instruction.label = target;
+					threaded++;
+				}
+
+				size_t destination = JumpDestination(target);
+				if (instruction.op == OPCODE::JUMP && destination < code.size() && code[destination].op == OPCODE::RETURN)
+				{
+					instruction.op = OPCODE::RETURN;
+					instruction.label = 0;
+					threaded++;
+				}
+			}
+
+			// jump to the instruction which follows it does nothing
+			InstructionArray result;
+			result.reserve(code.size());
+			for (size_t i = 0; i < code.size(); i++)
+			{
+				if (code[i].op == OPCODE::JUMP)
+				{
+					bool fallsThrough = false;
+					for (size_t j = i + 1; j < code.size() && code[j].op == OPCODE::SET_LABEL && !fallsThrough; j++)
+					{
+						fallsThrough = code[j].label == code[i].label;
+					}
+					if (fallsThrough)
+					{
+						threaded++;
+						continue;
+					}
+				}
+				result.push_back(code[i]);
+			}
+			code.swap(result);
+			report.jumpsThreaded += threaded;
+			return threaded != 0;
+		}
+
+		bool Optimizer::Peephole(InstructionArray& code, const Method& method)
+		{
+			// references are counted by name, as local can be used by another hash before its declaration
+			const auto& variables = method.GetVariables();
+			std::unordered_map<std::string, size_t> references;
+			for (const Instruction& instruction : code)
+			{
+				int hashCount = GetHashOperandCount(instruction.op);
+				for (int i = 0; i < hashCount; i++)
+				{
+					references[variables[instruction.hash[i]]]++;
+				}
+			}
+
+			InstructionArray result;
+			result.reserve(code.size());
+			for (size_t i = 0; i < code.size(); i++)
+			{
+				const Instruction& instruction = code[i];
+				// value which is discarded right after push: `x;`
+				if (IsPurePush(instruction.op) && i + 1 < code.size() && code[i + 1].op == OPCODE::POP_STACK_TOP)
+				{
+					i += 1;
+					continue;
+				}
+				// local which is never used after declaration: `var x;` or `var x = [constant];`
+				if ((instruction.op == OPCODE::ALLOC_VAR || instruction.op == OPCODE::ALLOC_CONST_VAR) &&
+					references[variables[instruction.hash[0]]] == 1)
+				{
+					if (i + 1 < code.size() && code[i + 1].op == OPCODE::POP_STACK_TOP)
+					{
+						i += 1;
+						continue;
+					}
+					if (i + 3 < code.size() && IsConstantPush(code[i + 1].op) &&
+						code[i + 2].op == OPCODE::ASSIGN_OP && code[i + 3].op == OPCODE::POP_STACK_TOP)
+					{
+						i += 3;
+						continue;
+					}
+				}
+				result.push_back(instruction);
+			}
+			size_t removed = code.size() - result.size();
+			code.swap(result);
+			report.peepholeInstructions += removed;
+			return removed != 0;
+		}
+
+		bool Optimizer::SpecializeArithmetic(InstructionArray& code, const Method& method)
+		{
+			// value on the stack as seen by compiler. Local is set if value is a reference to the local (assignment target)
+			struct StackValue
+			{
+				InferredType type;
+				const std::string* local;
+			};
+			const auto& variables = method.GetVariables();
+			std::unordered_map<std::string, InferredType> locals;
+			for (const auto& parameter : method.params)
+			{
+				locals[parameter] = InferredType::OTHER;
+			}
+
+			size_t specialized = 0;
+			bool localsChanged = false;
+			std::vector<StackValue> stack;
+			bool incrMode = false;
+
+			auto Pop = [&stack]()
+			{
+				if (stack.empty()) return StackValue{ InferredType::OTHER, nullptr };
+				StackValue value = stack.back();
+				stack.pop_back();
+				return value;
+			};
+			auto Push = [&stack](InferredType type, const std::string* local = nullptr)
+			{
+				stack.push_back(StackValue{ type, local });
+			};
+			auto Assign = [&locals, &localsChanged](const std::string& local, InferredType type)
+			{
+				InferredType& current = locals[local];
+				InferredType joined = JoinTypes(current, type);
+				if (joined != current)
+				{
+					current = joined;
+					localsChanged = true;
+				}
+			};
+			auto TypeOf = [&locals](const std::string& local)
+			{
+				auto it = locals.find(local);
+				return it != locals.end() ? it->second : InferredType::UNDEFINED;
+			};
+
+			// values are merged at labels, so the stack is not tracked through them. VM still checks types of operands
+			auto Interpret = [&](bool rewrite)
+			{
+				localsChanged = false;
+				incrMode = false;
+				stack.clear();
+				for (Instruction& instruction : code)
+				{
+					switch (instruction.op)
+					{
+					case OPCODE::PUSH_INTEGER:
+						Push(InferredType::INTEGER);
+						break;
+					case OPCODE::PUSH_FLOAT:
+						Push(InferredType::FLOAT);
+						break;
+					case OPCODE::PUSH_TRUE:
+					case OPCODE::PUSH_FALSE:
+						Push(InferredType::BOOLEAN);
+						break;
+					case OPCODE::PUSH_STRING:
+					case OPCODE::PUSH_THIS:
+					case OPCODE::PUSH_NULL:
+						Push(InferredType::OTHER);
+						break;
+					case OPCODE::PUSH_OBJECT:
+					case OPCODE::ALLOC_VAR:
+					case OPCODE::ALLOC_CONST_VAR:
+						Push(InferredType::OTHER, &variables[instruction.hash[0]]);
+						break;
+					case OPCODE::LOAD_LOCAL:
+						Push(TypeOf(variables[instruction.hash[0]]));
+						break;
+					case OPCODE::STORE_LOCAL:
+					{
+						StackValue value = Pop();
+						Assign(variables[instruction.hash[0]], value.type);
+						Push(value.type);
+						break;
+					}
+					case OPCODE::ASSIGN_OP:
+					{
+						StackValue value = Pop();
+						StackValue target = Pop();
+						if (target.local != nullptr) Assign(*target.local, value.type);
+						Push(InferredType::OTHER);
+						break;
+					}
+					case OPCODE::SET_ALU_INCR:
+						incrMode = true;
+						break;
+					case OPCODE::SUM_OP:
+					case OPCODE::SUB_OP:
+					case OPCODE::MULT_OP:
+					case OPCODE::DIV_OP:
+					case OPCODE::MOD_OP:
+					case OPCODE::POWER_OP:
+					case OPCODE::CMP_EQ:
+					case OPCODE::CMP_NEQ:
+					case OPCODE::CMP_L:
+					case OPCODE::CMP_G:
+					case OPCODE::CMP_LE:
+					case OPCODE::CMP_GE:
+					case OPCODE::CMP_AND:
+					case OPCODE::CMP_OR:
+					{
+						StackValue rhs = Pop();
+						StackValue lhs = Pop();
+						if (incrMode)
+						{
+							// compound assignment: result is assigned to the target and reference to it is pushed
+							if (lhs.local != nullptr) Assign(*lhs.local, InferBinaryResult(instruction.op, TypeOf(*lhs.local), rhs.type));
+							Push(InferredType::OTHER);
+							incrMode = false;
+							break;
+						}
+						Push(InferBinaryResult(instruction.op, lhs.type, rhs.type));
+						if (rewrite && lhs.type == rhs.type && IsNumeric(lhs.type))
+						{
+							OPCODE op = lhs.type == InferredType::INTEGER ? ToIntegerOpcode(instruction.op) : ToFloatOpcode(instruction.op);
+							if (op != instruction.op)
+							{
+								instruction.op = op;
+								specialized++;
+							}
+						}
+						break;
+					}
+					case OPCODE::NEGATIVE_OP:
+					case OPCODE::POSITIVE_OP:
+					{
+						StackValue value = Pop();
+						Push(IsNumeric(value.type) || value.type == InferredType::UNDEFINED ? value.type : InferredType::OTHER);
+						break;
+					}
+					case OPCODE::NEGATION_OP:
+					case OPCODE::GET_MEMBER:
+						Pop();
+						Push(InferredType::OTHER);
+						break;
+					case OPCODE::GET_INDEX:
+						Pop();
+						Pop();
+						Push(InferredType::OTHER);
+						break;
+					case OPCODE::CALL_FUNCTION:
+					case OPCODE::TAIL_CALL:
+						for (uint8_t i = 0; i <= instruction.paramCount; i++) Pop();
+						Push(InferredType::OTHER);
+						break;
+					case OPCODE::JUMP_IF_TRUE:
+					case OPCODE::JUMP_IF_FALSE:
+					case OPCODE::POP_STACK_TOP:
+						Pop();
+						break;
+					case OPCODE::ITER_INIT:
+						Pop();
+						Assign(variables[instruction.hash[0]], InferredType::OTHER);
+						Assign(variables[instruction.hash[1]], InferredType::OTHER);
+						break;
+					case OPCODE::ITER_NEXT:
+						Assign(variables[instruction.hash[0]], InferredType::OTHER);
+						break;
+					case OPCODE::JUMP_IF_FALSE_KEEP:
+					case OPCODE::JUMP_IF_TRUE_KEEP:
+					case OPCODE::PUSH_CATCH:
+					case OPCODE::POP_CATCH:
+						break;
+					default:
+						// labels, jumps and returns: next instruction is reached with unknown stack
+						stack.clear();
+						break;
+					}
+				}
+			};
+
+			// types of locals are joined over all assignments until they stop changing. Types only grow, so the loop always ends
+			do Interpret(false); while (localsChanged);
+			Interpret(true);
+			report.instructionsSpecialized += specialized;
+			return specialized != 0;
+		}
+
+		void Optimizer::OptimizeMethod(Method& method)
+		{
+			InstructionArray code;
+			if (!method.errors.empty() || !Decode(method.GetBytecode(), code)) return;
+			report.instructionsBefore += code.size();
+
+			// passes enable each other, so they are repeated until bytecode stops changing
+			const size_t maxIterations = 8;
+			for (size_t i = 0; i < maxIterations; i++)
+			{
+				bool changed = FoldConstants(code, method);
+				if (level >= Level::O2) changed |= PropagateConstants(code, method);
+				changed |= RemoveDeadCode(code);
+				if (level >= Level::O2) changed |= ThreadJumps(code);
+				changed |= Peephole(code, method);
+				if (!changed) break;
+			}
+			// specialized instructions are not folded by other passes, so they are emitted last
+			SpecializeArithmetic(code, method);
+
+			report.instructionsAfter += code.size();
+			Encode(code, method);
+		}
+
+		Optimizer::Optimizer(Assembly& assembly, int level)
+			: assembly(assembly), level(level) { }
+
+		void Optimizer::Optimize()
+		{
+			if (level <= Level::O0) return;
+			for (auto& _namespace : assembly.GetNamespaces())
+			{
+				for (auto& _class : _namespace.GetMembers())
+				{
+					for (auto& method : _class.GetMethods())
+					{
+						OptimizeMethod(method);
+					}
+				}
+			}
+		}
+
+		const Optimizer::Report& Optimizer::GetReport() const
+		{
+			return report;
+		}
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "opcode.h"
+#include "byteBuffer.h"
+#include <vector>
+#include <string>
+
+namespace MSL
+{
+	namespace compiler
+	{
+		class Assembly;
+		class Method;
+
+		/*
+		Optimizer class performs optimization passes over bytecode of all methods in assembly
+		it must be used after Parser::PullAssembly() and before CodeGenerator::GenerateBytecode() call
+		method bytecode is decoded to the array of instructions, optimized and encoded back
+		*/
+		class Optimizer
+		{
+		public:
+			/*
+			optimization levels which can be passed to the optimizer (see -O option of MSL compile command)
+			*/
+			enum Level
+			{
+				O0 = 0, // no optimizations are performed
+				O1 = 1, // constant folding, dead-code elimination, peephole optimizations and type specialization of arithmetic
+				O2 = 2, // all O1 optimizations, constant propagation and jump threading
+			};
+			/*
+			statistics of optimization passes. Each counter stores number of instructions removed or rewritten by the pass
+			*/
+			struct Report
+			{
+				size_t instructionsBefore = 0;
+				size_t instructionsAfter = 0;
+				size_t constantsFolded = 0;
+				size_t constantsPropagated = 0;
+				size_t deadInstructions = 0;
+				size_t jumpsThreaded = 0;
+				size_t peepholeInstructions = 0;
+				size_t instructionsSpecialized = 0;
+				/*
+				returns human-read representation of report as string
+				*/
+				std::string ToString() const;
+			};
+		private:
+			/*
+			decoded bytecode instruction. Unused operands are left zero
+			*/
+			struct Instruction
+			{
+				VM::OPCODE op;
+				size_t hash[3];
+				uint16_t label;
+				uint8_t paramCount;
+			};
+			using InstructionArray = std::vector<Instruction>;
+
+			/*
+			assembly which method bodies are optimized
+			*/
+			Assembly& assembly;
+			/*
+			optimization level (see Optimizer::Level)
+			*/
+			int level;
+			/*
+			statistics collected through all optimized methods
+			*/
+			Report report;
+
+			/*
+			decodes method bytecode to the instruction array. Returns false if bytecode contains unknown opcodes
+			*/
+			bool Decode(const utils::ByteBuffer& bytecode, InstructionArray& code) const;
+			/*
+			encodes instruction array back to the method bytecode
+			*/
+			void Encode(const InstructionArray& code, Method& method) const;
+			/*
+			runs all optimization passes enabled by level over the method body
+			*/
+			void OptimizeMethod(Method& method);
+			/*
+			evaluates operations over constant operands and branches over constant predicates
+			*/
+			bool FoldConstants(InstructionArray& code, Method& method);
+			/*
+			replaces references to const locals initialized by constant with the constant itself
+			*/
+			bool PropagateConstants(InstructionArray& code, Method& method);
+			/*
+			removes unreachable instructions and labels which are never referenced
+			*/
+			bool RemoveDeadCode(InstructionArray& code);
+			/*
+			retargets jumps which lead to another unconditional jump and removes jumps to the next instruction
+			*/
+			bool ThreadJumps(InstructionArray& code);
+			/*
+			removes pushes which are popped immediately and declarations of locals which are never used
+			*/
+			bool Peephole(InstructionArray& code, const Method& method);
+			/*
+			infers types of locals and stack values and replaces ALU instructions over Integer or Float operands by specialized ones
+			*/
+			bool SpecializeArithmetic(InstructionArray& code, const Method& method);
+		public:
+			/*
+			creates optimizer for assembly with level provided
+			*/
+			Optimizer(Assembly& assembly, int level);
+			/*
+			optimizes bytecode of all methods in assembly
+			*/
+			void Optimize();
+			/*
+			returns statistics of optimization passes
+			*/
+			const Report& GetReport() const;
+		};
+	}
+}
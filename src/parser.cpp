@@ -5,8 +5,7 @@
 
 using namespace MSL::utils;
 
-void yyset_lexer(MSL::compiler::Lexer* lexer);
-int yyparse(MSL::compiler::BaseAstNode** root);
+int yyparse(MSL::compiler::BaseAstNode** root, MSL::compiler::Lexer* lexer, MSL::compiler::AstArena* arena);
 
 namespace MSL
 {
@@ -20,20 +19,20 @@ namespace MSL
 
 		bool Parser::Parse()
 		{
-            yyset_lexer(this->lexer);
             BaseAstNode* AST = nullptr;
-            yyparse(&AST);
+            yyparse(&AST, this->lexer, &this->arena); // parser is reentrant, so files can be parsed concurrently
 
             if (AST == nullptr)
             {
+                arena.Release();
                 success = false;
                 return false;
             }
 
-             AST->DebugPrint(0, "\n");
+            if (mode & MODE::DEBUG_ONLY) AST->DebugPrint(0, "\n");
             
             CompileAST(AST);
-            delete AST;
+            arena.Release(); // whole AST is destroyed at once, as only the assembly is used after compilation
             return true;
 		}
 
@@ -42,23 +41,19 @@ namespace MSL
 			return std::move(assembly);
 		}
 
-        std::stringstream Parser::CompileMethodBody(Method& method, AstNodeList* body)
+        void Parser::CompileMethodBody(Method& method, AstNodeList* body)
         {
-            std::stringstream out;
-
             if (dynamic_cast<ReturnExprNode*>(body->vec.back()) == nullptr)
             {
-                body->vec.push_back(new ReturnExprNode(nullptr));
+                body->vec.push_back(arena.New<ReturnExprNode>(nullptr));
             }
 
-            body->GenerateBytecode(out, method);
+            body->GenerateBytecode(method.bytecode, method);
 
             for (const auto& error : method.errors)
             {
                 Error(error + " in method: " + method.name);
             }
-
-            return out;
         }
 
         Method Parser::CompileMethod(MethodDeclNode* method)
@@ -67,7 +62,7 @@ namespace MSL
             Method _method(method->name);
             _method.params = method->args->vec;
             if (method->body != nullptr) 
-                _method.bytecode = CompileMethodBody(_method, method->body);
+                CompileMethodBody(_method, method->body);
 
             for (const auto& modifier : method->modifiers->vec)
             {
@@ -322,9 +317,9 @@ namespace MSL
                 Method defaultConstructor(constructorName);
                 defaultConstructor.modifiers = Method::Modifiers::_PUBLIC | Method::Modifiers::_CONSTRUCTOR;
 
-                auto body = std::make_unique<AstNodeList>();
-                body->vec.push_back(new ReturnExprNode(nullptr));
-                defaultConstructor.bytecode = CompileMethodBody(defaultConstructor, body.get());
+                auto* body = arena.New<AstNodeList>();
+                body->vec.push_back(arena.New<ReturnExprNode>(nullptr));
+                CompileMethodBody(defaultConstructor, body);
 
                 defaultConstructor.name = _class.name;
                 _class.InsertMethod(constructorName, std::move(defaultConstructor));
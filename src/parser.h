@@ -34,6 +34,10 @@ namespace MSL
 			*/
 			Lexer* lexer;
 			/*
+			arena in which AST nodes are allocated while parsing. It is released after AST is compiled to assembly
+			*/
+			AstArena arena;
+			/*
 			stream to which debug / warning / error information is outputted	
 			*/
 			std::ostream* stream;
@@ -63,7 +67,7 @@ namespace MSL
 			*/
 			size_t currentErrorCount = 0;
 
-            std::stringstream CompileMethodBody(Method& method, AstNodeList* body);
+            void CompileMethodBody(Method& method, AstNodeList* body);
 
             Method CompileMethod(MethodDeclNode* method);
             
@@ -1,11 +1,31 @@
 #include "stringExtensions.h"
 #include <sstream>
 #include <regex>
+#include <cstring>
 
 namespace MSL
 {
 	namespace utils
 	{
+		StringView::StringView(const char* data, size_t size) : data(data), size(size) { }
+
+		StringView::StringView(const char* str) : data(str), size(std::strlen(str)) { }
+
+		StringView::operator std::string() const
+		{
+			return std::string(data, size);
+		}
+
+		bool StringView::operator==(const StringView& other) const
+		{
+			return size == other.size && (size == 0 || std::memcmp(data, other.data, size) == 0);
+		}
+
+		bool StringView::operator!=(const StringView& other) const
+		{
+			return !(*this == other);
+		}
+
 		void writeToStream(std::ostream* stream, std::string message)
 		{
 			message += '\n';
@@ -13,6 +13,28 @@ namespace MSL
 		
 		#define STRING(x) #x
 		#define STRBOOL(x) ((x) ? "true" : "false")
+
+		/*
+		non-owning reference to a range of characters. Characters are not copied, so they must outlive the view
+		*/
+		struct StringView
+		{
+			const char* data = nullptr;
+			size_t size = 0;
+
+			StringView() = default;
+			StringView(const char* data, size_t size);
+			/*
+			creates view of null-terminated string, for example string literal
+			*/
+			StringView(const char* str);
+			/*
+			copies characters of view to std::string object
+			*/
+			operator std::string() const;
+			bool operator==(const StringView& other) const;
+			bool operator!=(const StringView& other) const;
+		};
 		/*
 		writes string object to std::ostream and adds '\n' to the end
 		*/
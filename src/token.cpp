@@ -6,7 +6,7 @@ namespace MSL
 {
 	namespace compiler
 	{
-		Token::Token(Token::Type type, const std::string& value) : type(type), value(value) { }
+		Token::Token(Token::Type type, utils::StringView value) : type(type), value(value) { }
 
         Token::Token(Token::Type type) : type(type) { }
 
@@ -14,7 +14,7 @@ namespace MSL
 		{
 			std::string out = "[";
 			out += ToString(type);
-			out += ' ' + value + ']';
+			out += ' ' + std::string(value) + ']';
 			return out;
 		}
 
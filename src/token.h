@@ -104,14 +104,14 @@ namespace MSL
 			*/
 			Type type;
 			/*
-			underlying value of token (object name / constant)
+			underlying value of token (object name / constant). It refers to source code buffer of lexer, so token must not outlive it
 			*/
-			std::string value;
+			utils::StringView value;
 
 			/*
-			creates token using its type and string value
+			creates token using its type and value
 			*/
-			Token(Type type, const std::string& value);
+			Token(Type type, utils::StringView value);
 
             /*
             creates token using its type only (value will be empty)
@@ -2,6 +2,7 @@
 #include <Windows.h>
 #include <cstdlib>
 #include <iomanip>
+#include <algorithm>
 
 #undef ERROR
 #undef CONST
@@ -77,7 +78,11 @@ namespace MSL
 
 			// search for local variable in method
 			auto localsIt = locals.find(objectName);
-			if (localsIt != locals.end()) return localsIt->second.object;
+			if (localsIt != locals.end())
+			{
+				localsIt->second.object->unique = false; // value may be shared after it leaves the local
+				return localsIt->second.object;
+			}
 
 			// search for attribute in class object
 			const ClassType* actualClass = nullptr;
@@ -96,8 +101,9 @@ namespace MSL
 				actualClass = static_cast<const ClassWrapper*>(_class)->typeInstance;
 			}
 			// search for static attribute in class
-			auto classIt = actualClass->staticInstance->attributes.find(objectName);
-			if (classIt != actualClass->staticInstance->attributes.end())
+			ClassObject* staticInstance = GetStaticInstance(actualClass);
+			auto classIt = staticInstance->attributes.find(objectName);
+			if (classIt != staticInstance->attributes.end())
 			{
 				return classIt->second;
 			}
@@ -110,8 +116,11 @@ namespace MSL
 			const auto ns = GetNamespaceOrNull(objectName);
 			if (ns != nullptr) return AllocNamespaceWrapper(ns);
 
-			InvokeError(ERROR::MEMBER_NOT_FOUND, "object with name `" + objectName + "` was not found", objectName);
-			std::string className = _class->ToString() + (_method->isStatic() ? "[static]" : "[this]");
+			InvokeError(ERROR::MEMBER_NOT_FOUND, [objectName](std::string& message, std::string& argument)
+			{
+				message = "object with name `" + objectName + "` was not found";
+				argument = objectName;
+			});
 			return nullptr;
 		}
 
@@ -141,8 +150,9 @@ namespace MSL
 				}
 				else
 				{
-					auto staticAttr = obj->typeInstance->staticInstance->attributes.find(memberName);
-					if (staticAttr != obj->typeInstance->staticInstance->attributes.end())
+					ClassObject* staticInstance = GetStaticInstance(obj->typeInstance);
+					auto staticAttr = staticInstance->attributes.find(memberName);
+					if (staticAttr != staticInstance->attributes.end())
 					{
 						memberObject = staticAttr->second;
 					}
@@ -152,7 +162,7 @@ namespace MSL
 			case Type::CLASS:
 			{
 				ClassWrapper* cl = static_cast<ClassWrapper*>(object);
-				memberObject = GetMemberObject(cl->typeInstance->staticInstance, memberName);
+				memberObject = GetMemberObject(GetStaticInstance(cl->typeInstance), memberName);
 			}
 			break;
 			}
@@ -183,7 +193,11 @@ namespace MSL
 				cl = GetClassOrNull("System", "Null");
 				break;
 			default:
-				InvokeError(ERROR::INVALID_TYPE, "Cannot get primitive class of object with type: " + ToString(object->type), object->ToString());
+				InvokeError(ERROR::INVALID_TYPE, [object](std::string& message, std::string& argument)
+				{
+					message = "Cannot get primitive class of object with type: " + ToString(object->type);
+					argument = object->ToString();
+				});
 				return nullptr;
 			}
 			return cl->wrapper;
@@ -211,7 +225,11 @@ namespace MSL
 						}
 						else
 						{
-							InvokeError(ERROR::AMBIGUOUS_TYPE, "find two or more matching classes while resolving object type: " + objectName, objectName);
+							InvokeError(ERROR::AMBIGUOUS_TYPE, [objectName](std::string& message, std::string& argument)
+							{
+								message = "find two or more matching classes while resolving object type: " + objectName;
+								argument = objectName;
+							});
 							return nullptr;
 						}
 					}
@@ -236,6 +254,7 @@ namespace MSL
 			case MSL::VM::Type::UNKNOWN:
 				return object;
 			case MSL::VM::Type::LOCAL:
+				static_cast<LocalObject*>(object)->ref.object->unique = false;
 				return static_cast<LocalObject*>(object)->ref.object;
 			case MSL::VM::Type::ATTRIBUTE:
 				return static_cast<AttributeObject*>(object)->object;
@@ -275,14 +294,19 @@ namespace MSL
 				return;
 			}
 			// getting frame arguments
+		tailCall: // method called by TAIL_CALL instruction is started in the frame of the caller
 			CallPath& top = callStack.back();
-			top.SetFrame(AllocFrame());
+			if (top.GetFrame() == nullptr) top.SetFrame(AllocFrame());
 			Frame* frame = top.GetFrame();
+			const MethodType* previousMethod = frame->_method;
 			frame->_namespace = GetNamespaceOrNull(*callStack.back().GetNamespace());
 			frame->_class = GetClassOrNull(frame->_namespace, *callStack.back().GetClass());
 			frame->_method = GetMethodOrNull(frame->_class, *callStack.back().GetMethod());
+			if (previousMethod != nullptr && previousMethod != frame->_method) frame->ClearCaches();
 
 			#define RET_CS_POP callStack.pop_back(); return
+			// instructions which call or return from method are shared with JIT helpers, which report how frame must be left
+			#define FRAME_ACTION(action) switch (action) { case FrameAction::RETURN: return; case FrameAction::TAIL_CALL: goto tailCall; default: break; }
 
 			// in case method was not found
 			if (frame->_method == nullptr)
@@ -310,17 +334,29 @@ namespace MSL
 						}
 						else if (classType->isAbstract()) // if class is abstract, constructor is not found too
 						{
-							InvokeError(ERROR::ABSTRACT_MEMBER_ACCESS, "cannot create instance of abstract class: " + GetFullClassType(classType), classType->name);
+							InvokeError(ERROR::ABSTRACT_MEMBER_ACCESS, [this, classType](std::string& message, std::string& argument)
+							{
+								message = "cannot create instance of abstract class: " + GetFullClassType(classType);
+								argument = classType->name;
+							});
 
 						}
 						else if (classType->isStatic())
 						{
-							InvokeError(ERROR::MEMBER_NOT_FOUND, "cannot create instance of static class: " + GetFullClassType(classType), classType->name);
+							InvokeError(ERROR::MEMBER_NOT_FOUND, [this, classType](std::string& message, std::string& argument)
+							{
+								message = "cannot create instance of static class: " + GetFullClassType(classType);
+								argument = classType->name;
+							});
 
 						}
 						else // probably constructor is just missing
 						{
-							InvokeError(ERROR::METHOD_NOT_FOUND, "could not call class " + GetFullClassType(classType) + " constructor: " + methodName, classType->name);
+							InvokeError(ERROR::METHOD_NOT_FOUND, [this, classType, methodName](std::string& message, std::string& argument)
+							{
+								message = "could not call class " + GetFullClassType(classType) + " constructor: " + methodName;
+								argument = classType->name;
+							});
 						}
 					}
 				}
@@ -328,11 +364,11 @@ namespace MSL
 				{
 					if (errors == 0)
 					{
-						InvokeError(
-							ERROR::METHOD_NOT_FOUND,
-							"method " + GetFullClassType(frame->_class) + '.' + *callStack.back().GetMethod() + " was not found",
-							GetMethodActualName(*callStack.back().GetMethod())
-						);
+						InvokeError(ERROR::METHOD_NOT_FOUND, [this, _class = frame->_class, method = *callStack.back().GetMethod()](std::string& message, std::string& argument)
+						{
+							message = "method " + GetFullClassType(_class) + '.' + method + " was not found";
+							argument = GetMethodActualName(method);
+						});
 					}
 				}
 				RET_CS_POP;
@@ -343,33 +379,33 @@ namespace MSL
 				CallPath& prev = callStack[callStack.size() - 2];
 				if (*prev.GetNamespace() != frame->_namespace->name || *prev.GetClass() != frame->_class->name)
 				{
-					InvokeError(
-						ERROR::PRIVATE_MEMBER_ACCESS, 
-						"trying to call private method: " + GetFullClassType(frame->_class) + '.' + GetFullMethodType(frame->_method), 
-						GetMethodActualName(frame->_method->name)
-					);
+					InvokeError(ERROR::PRIVATE_MEMBER_ACCESS, [this, _class = frame->_class, method = frame->_method](std::string& message, std::string& argument)
+					{
+						message = "trying to call private method: " + GetFullClassType(_class) + '.' + GetFullMethodType(method);
+						argument = GetMethodActualName(method->name);
+					});
  					RET_CS_POP;
 				}
 			}
 			// if method is abstract, it cannot be called
 			if (frame->_method->isAbstract())
 			{
-				InvokeError(
-					ERROR::ABSTRACT_MEMBER_ACCESS, 
-					"trying to call abstract method: " + GetFullClassType(frame->_class) + '.' + GetFullMethodType(frame->_method), 
-					GetMethodActualName(frame->_method->name)
-				);
+				InvokeError(ERROR::ABSTRACT_MEMBER_ACCESS, [this, _class = frame->_class, method = frame->_method](std::string& message, std::string& argument)
+				{
+					message = "trying to call abstract method: " + GetFullClassType(_class) + '.' + GetFullMethodType(method);
+					argument = GetMethodActualName(method->name);
+				});
  				RET_CS_POP;
 			}
 			if (frame->_method->isStaticConstructor())
 			{
 				if (frame->_class->staticConstructorCalled)
 				{
-					InvokeError(
-						ERROR::INVALID_METHOD_CALL,
-						"static constructor of class cannot be called twice: " + GetFullClassType(frame->_class) + '.' + GetFullMethodType(frame->_method),
-						GetMethodActualName(frame->_method->name)
-					);
+					InvokeError(ERROR::INVALID_METHOD_CALL, [this, _class = frame->_class, method = frame->_method](std::string& message, std::string& argument)
+					{
+						message = "static constructor of class cannot be called twice: " + GetFullClassType(_class) + '.' + GetFullMethodType(method);
+						argument = GetMethodActualName(method->name);
+					});
  					RET_CS_POP;
 				}
 				else
@@ -401,6 +437,10 @@ namespace MSL
 				PerformSystemCall(frame->_class, frame->_method, frame);
 				return;
 			}
+			if (!DecodeMethod(frame->_class, frame->_method))
+			{
+				RET_CS_POP;
+			}
 
 			// read all parameters of method and add them to frame as const locals
 			for (auto it = frame->_method->parameters.rbegin(); it != frame->_method->parameters.rend(); it++)
@@ -413,6 +453,7 @@ namespace MSL
 					return;
 				}
 				frame->locals[*it] = { objectStack.back(), false };
+				objectStack.back()->unique = false;
 				objectStack.pop_back();
 			}
 			// `this` must be first parameter of any non-static non-constructor method (is added by compiler)
@@ -438,7 +479,11 @@ namespace MSL
 				// constructor cannot be called if the class is statics
 				if (frame->_class->isStatic())
 				{
-					InvokeError(ERROR::INVALID_METHOD_CALL, "can not create instance of static class: " + GetFullClassType(frame->_class), frame->_class->name);
+					InvokeError(ERROR::INVALID_METHOD_CALL, [this, _class = frame->_class](std::string& message, std::string& argument)
+					{
+						message = "can not create instance of static class: " + GetFullClassType(_class);
+						argument = _class->name;
+					});
  					RET_CS_POP;
 				}
 				else
@@ -448,26 +493,57 @@ namespace MSL
 				}
 			}
 
+			frame->stackBase = objectStack.size();
+
+			UpdateHotness(frame->_method);
+			bool nativeEntryAllowed = true;
 			while (frame->offset < frame->_method->body.size())
 			{
 				if (errors != 0)
 				{
-					// add stack trace
-					exception.AddTraceEntry(
-						GetFullClassType(frame->_class) + '.' + GetMethodActualName(frame->_method->name)
-					);
+					// add stack trace, it is formatted only if exception is read
+					exception.AddTraceEntry({ frame->_class, frame->_method, frame->offset });
+					if (frame->tailCalls > 0)
+					{
+						// method which started the frame and methods it tail called are elided from call stack
+						ExceptionTrace::TraceEntry caller = frame->tailCaller;
+						caller.tailCalls = frame->tailCalls;
+						exception.AddTraceEntry(caller);
+					}
+					// offset is already moved past the instruction which caused the error
+					const MethodType::ExceptionHandler* handler = nullptr;
+					if (!(errors & ERROR::FATAL_ERROR) && frame->offset > 0)
+						handler = FindExceptionHandler(frame->_method, frame->offset - 1);
 					// return if no catch statements in this frame
-					if (frame->exceptionStack.empty() || errors & ERROR::FATAL_ERROR)
+					if (handler == nullptr)
 					{
 						RET_CS_POP;
 					}
-					// get jump label for handler
+					// try block is always a statement, so stack is empty when it is entered (see FindExceptionHandler)
 					errors = 0;
-					auto catchStatement = frame->exceptionStack.back();
-					objectStack.resize(catchStatement.stackSize);
-					frame->exceptionStack.pop_back();
-					frame->offset = frame->_method->labels[catchStatement.label];
+					objectStack.resize(frame->stackBase);
+					frame->offset = frame->_method->labels[handler->label];
 				}
+				// compiled method (ahead-of-time or by JIT) is entered at any instruction it supports, including loops of running frame
+				// native code returns on instruction it leaves to interpreter, which executes it before entering native code again
+				if (nativeEntryAllowed && frame->_method->aotMethod != nullptr && frame->_method->aotMethod(this, frame))
+				{
+					nativeEntryAllowed = false;
+					continue;
+				}
+				if (nativeEntryAllowed && frame->_method->jitMethod != nullptr)
+				{
+					const uint8_t* entry = frame->_method->jitMethod->GetEntry(frame->offset);
+					if (entry != nullptr)
+					{
+						int status = frame->_method->jitMethod->Enter(this, frame, entry);
+						if (status == JitCompiler::RETURN) return;
+						if (status == JitCompiler::TAIL_CALL) goto tailCall;
+						nativeEntryAllowed = false;
+						continue;
+					}
+				}
+				nativeEntryAllowed = true;
 				OPCODE op = ReadOPCode(frame->_method->body, frame->offset);
 				CollectGarbage();
 				switch (op)
@@ -487,24 +563,70 @@ namespace MSL
 				ALU_1(OPCODE::NEGATIVE_OP);
 				ALU_1(OPCODE::POSITIVE_OP);
 				#define ALU_2(op) case op: PerformALUCall(op, 2, frame); break
-				ALU_2(OPCODE::SUM_OP);
-				ALU_2(OPCODE::SUB_OP);
-				ALU_2(OPCODE::MULT_OP);
-				ALU_2(OPCODE::DIV_OP);
+				#define ALU_2_QUICKENED(op) case op: QuickenALUCall(op, frame); PerformALUCall(op, 2, frame); break
+				ALU_2_QUICKENED(OPCODE::SUM_OP);
+				ALU_2_QUICKENED(OPCODE::SUB_OP);
+				ALU_2_QUICKENED(OPCODE::MULT_OP);
+				ALU_2_QUICKENED(OPCODE::DIV_OP);
 				ALU_2(OPCODE::MOD_OP);
 				ALU_2(OPCODE::POWER_OP);
-				ALU_2(OPCODE::CMP_EQ);
-				ALU_2(OPCODE::CMP_NEQ);
-				ALU_2(OPCODE::CMP_L);
-				ALU_2(OPCODE::CMP_G);
-				ALU_2(OPCODE::CMP_LE);
-				ALU_2(OPCODE::CMP_GE);
+				ALU_2_QUICKENED(OPCODE::CMP_EQ);
+				ALU_2_QUICKENED(OPCODE::CMP_NEQ);
+				ALU_2_QUICKENED(OPCODE::CMP_L);
+				ALU_2_QUICKENED(OPCODE::CMP_G);
+				ALU_2_QUICKENED(OPCODE::CMP_LE);
+				ALU_2_QUICKENED(OPCODE::CMP_GE);
 				ALU_2(OPCODE::CMP_AND);
 				ALU_2(OPCODE::CMP_OR);
 				ALU_2(OPCODE::ASSIGN_OP);
+				#undef ALU_2_QUICKENED
 				#undef ALU_2
 				#undef ALU_1
 
+				// type-specialized ALU: operands are used directly if both have type inferred by compiler or observed by quickening
+				// else instruction is despecialized and generic ALU call is performed
+				#define ALU_TYPED(op, generic, ObjectType, objectType, result) case op: \
+				{ \
+					const size_t size = objectStack.size(); \
+					if (size < 2 || !AssertType(objectStack[size - 1], objectType) || !AssertType(objectStack[size - 2], objectType)) \
+					{ \
+						Despecialize(frame, frame->offset - 1); \
+						PerformALUCall(generic, 2, frame); \
+						break; \
+					} \
+					const auto& rhs = static_cast<ObjectType*>(objectStack[size - 1])->value; \
+					const auto& lhs = static_cast<ObjectType*>(objectStack[size - 2])->value; \
+					BaseObject* object = result; \
+					objectStack.pop_back(); \
+					objectStack.back() = object; \
+					break; \
+				}
+				#define BOOLEAN_RESULT(predicate) ((predicate) ? static_cast<BaseObject*>(AllocTrue()) : AllocFalse())
+				#define ALU_INT(op, generic, result) ALU_TYPED(op, generic, IntegerObject, Type::INTEGER, result)
+				#define ALU_FLOAT(op, generic, result) ALU_TYPED(op, generic, FloatObject, Type::FLOAT, result)
+				ALU_INT(OPCODE::SUM_INT, OPCODE::SUM_OP, AllocInteger(lhs + rhs));
+				ALU_INT(OPCODE::SUB_INT, OPCODE::SUB_OP, AllocInteger(lhs - rhs));
+				ALU_INT(OPCODE::MULT_INT, OPCODE::MULT_OP, AllocInteger(lhs * rhs));
+				ALU_INT(OPCODE::CMP_EQ_INT, OPCODE::CMP_EQ, BOOLEAN_RESULT(lhs == rhs));
+				ALU_INT(OPCODE::CMP_NEQ_INT, OPCODE::CMP_NEQ, BOOLEAN_RESULT(lhs != rhs));
+				ALU_INT(OPCODE::CMP_L_INT, OPCODE::CMP_L, BOOLEAN_RESULT(lhs < rhs));
+				ALU_INT(OPCODE::CMP_G_INT, OPCODE::CMP_G, BOOLEAN_RESULT(lhs > rhs));
+				ALU_INT(OPCODE::CMP_LE_INT, OPCODE::CMP_LE, BOOLEAN_RESULT(lhs <= rhs));
+				ALU_INT(OPCODE::CMP_GE_INT, OPCODE::CMP_GE, BOOLEAN_RESULT(lhs >= rhs));
+				ALU_FLOAT(OPCODE::SUM_FLOAT, OPCODE::SUM_OP, AllocFloat(lhs + rhs));
+				ALU_FLOAT(OPCODE::SUB_FLOAT, OPCODE::SUB_OP, AllocFloat(lhs - rhs));
+				ALU_FLOAT(OPCODE::MULT_FLOAT, OPCODE::MULT_OP, AllocFloat(lhs * rhs));
+				ALU_FLOAT(OPCODE::DIV_FLOAT, OPCODE::DIV_OP, AllocFloat(lhs / rhs));
+				ALU_FLOAT(OPCODE::CMP_L_FLOAT, OPCODE::CMP_L, BOOLEAN_RESULT(lhs < rhs));
+				ALU_FLOAT(OPCODE::CMP_G_FLOAT, OPCODE::CMP_G, BOOLEAN_RESULT(lhs > rhs));
+				ALU_FLOAT(OPCODE::CMP_LE_FLOAT, OPCODE::CMP_LE, BOOLEAN_RESULT(lhs <= rhs));
+				ALU_FLOAT(OPCODE::CMP_GE_FLOAT, OPCODE::CMP_GE, BOOLEAN_RESULT(lhs >= rhs));
+				ALU_TYPED(OPCODE::SUM_STRING, OPCODE::SUM_OP, StringObject, Type::STRING, AllocString(lhs + rhs));
+				#undef ALU_FLOAT
+				#undef ALU_INT
+				#undef BOOLEAN_RESULT
+				#undef ALU_TYPED
+
 				case (OPCODE::GET_INDEX):
 				{
 					if (objectStack.size() < 2)
@@ -550,195 +672,25 @@ namespace MSL
 					}
 					break;
 					default:
-						InvokeError(
-							ERROR::INVALID_TYPE, 
-							"object with invalid type was passed to GetByIndex() call: " + ToString(object->type), 
-							object->ToString()
-						);
+						InvokeError(ERROR::INVALID_TYPE, [object](std::string& message, std::string& argument)
+						{
+							message = "object with invalid type was passed to GetByIndex() call: " + ToString(object->type);
+							argument = object->ToString();
+						});
 						return;
 					}
 					break;
 				}
 				case (OPCODE::CALL_FUNCTION):
-				{
-                    // CALL_FUNCTION [function hash] [arg count]
-                    size_t hash = ReadHash(frame->_method->body, frame->offset);
-                    if (!ValidateHashValue(hash, frame->_method->dependencies.size()))
-                        return;
-
-                    const std::string* functionName = &frame->_method->dependencies[hash];
-
-					uint8_t paramSize = ReadOPCode(frame->_method->body, frame->offset);
-					if (objectStack.size() < paramSize + 1u) // arg count + caller object
-					{
-						InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "not enough parameters in stack for function call", !objectStack.empty() ? GetMethodActualName(objectStack.back()->ToString()) : "");
- 						return;
-					}
-
-					for (size_t i = 0; i < paramSize; i++)
-					{
-						size_t index = objectStack.size() - i - 1;
-						BaseObject* obj = objectStack[index];
-						if (AssertType(obj, Type::UNKNOWN))
-						{
-							objectStack[index] = ResolveReference(objectStack[index], frame->locals, frame->_method, frame->classObject, frame->_namespace);
-							if (objectStack[index] == nullptr) return;
-						}
-					}
-					CallPath newFrame;
-					BaseObject* caller = objectStack[objectStack.size() - paramSize - 1];
-					if (AssertType(caller, Type::UNKNOWN)) caller = ResolveReference(caller, frame->locals, frame->_method, frame->classObject, frame->_namespace);
-					if (caller == nullptr) return; // check performed in ResolveReference method
-
-					caller = GetUnderlyingObject(caller);
-					switch (caller->type)
-					{
-					case Type::CLASS_OBJECT:
-					{
-						ClassObject* object = static_cast<ClassObject*>(caller);
-
-                        newFrame.SetNamespace(&object->typeInstance->namespaceName);
-                        newFrame.SetClass(&object->typeInstance->name);
-						
-                        // as class method has extra implicit argument `this`, we must modify function name
-						std::string objectFunctionName = GetMethodActualName(*functionName) + '_' + std::to_string(paramSize + 1);
-						if (object->typeInstance->methods.find(objectFunctionName) != object->typeInstance->methods.end())
-						{
-                            objectStack[objectStack.size() - paramSize - 1] = object; // unknown object is resolved now
-							frame->localStorage.push_back(std::make_unique<std::string>(objectFunctionName));
-                            newFrame.SetMethod(frame->localStorage.back().get());
-						}
-                        else
-                        {
-                            newFrame.SetMethod(functionName);
-                        }
-						callStack.push_back(std::move(newFrame));
-					}
+				case (OPCODE::TAIL_CALL):
+					FRAME_ACTION(PerformFunctionCall(frame, op));
 					break;
-					case Type::CLASS:
-					{
-						ClassWrapper* object = static_cast<ClassWrapper*>(caller);
-						objectStack[objectStack.size() - paramSize - 1] = object;
-						newFrame.SetNamespace(&object->typeInstance->namespaceName);
-						newFrame.SetClass(&object->typeInstance->name);
-						newFrame.SetMethod(functionName);
-						callStack.push_back(std::move(newFrame));
-					}
+				case (OPCODE::CALL_METHOD):
+					FRAME_ACTION(PerformMethodCall(frame));
 					break;
-					case Type::NAMESPACE:
-					{
-						UnknownObject* function = static_cast<UnknownObject*>(objectStack.back());
-						// top of stack must be unknown object (function name)
-						std::string className = GetMethodActualName(*functionName);
-						const NamespaceType* ns = static_cast<NamespaceWrapper*>(caller)->type;
-						auto classIt = ns->classes.find(className);
-						if (classIt == ns->classes.end())
-						{
-							InvokeError(ERROR::MEMBER_NOT_FOUND, "class `" + className + "` was not found in namespace: " + ns->name, className);
- 							return;
-						}
-						else if (classIt->second.IsPrivate() && ns->name != frame->_namespace->name)
-						{
-							InvokeError(ERROR::PRIVATE_MEMBER_ACCESS, "trying to access namespace internal member: " + GetFullClassType(&classIt->second), className);
- 							return;
-						}
-						objectStack[objectStack.size() - paramSize - 1] = classIt->second.wrapper;
-						newFrame.SetNamespace(GetObjectName(caller));
-						newFrame.SetClass(&classIt->second.name);
-						newFrame.SetMethod(functionName);
-						callStack.push_back(std::move(newFrame));
-						break;
-					}
-					case Type::INTEGER:
-					case Type::FLOAT:
-					case Type::STRING:
-					case Type::TRUE:
-					case Type::FALSE:
-					case Type::NULLPTR:
-					{
-						objectStack[objectStack.size() - paramSize - 1] = caller;
-						const ClassType* cl = GetClassPrimitive(caller)->typeInstance;
-						newFrame.SetNamespace(&cl->namespaceName);
-						newFrame.SetClass(&cl->name);
-						newFrame.SetMethod(functionName);
-						callStack.push_back(std::move(newFrame));
-						break;
-					}
-					default:
-						InvokeError(ERROR::INVALID_TYPE, "caller of method was neither class object nor class type", caller->ToString());
-						return;
-						break;
-					}
-					
-					StartNewStackFrame();
-					break;
-				}
 				case (OPCODE::GET_MEMBER):
-				{
-					if (objectStack.size() < 1)
-					{
-						InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "not enough objects in stack to get member", !objectStack.empty() ? objectStack.back()->ToString() : "");
-						break;
-					}
-                    size_t hash = ReadHash(frame->_method->body, frame->offset);
-                    if (!ValidateHashValue(hash, frame->_method->dependencies.size()))
-                        return;
-
-                    const std::string* memberName = &frame->_method->dependencies[hash];
-
-					BaseObject* calledObject = objectStack.back();
-					objectStack.pop_back();
-					if (AssertType(calledObject, Type::UNKNOWN)) calledObject = ResolveReference(calledObject, frame->locals, frame->_method, frame->classObject, frame->_namespace);
-					if (calledObject == nullptr) break; // check performed in ResolveReference method
-
-					BaseObject* memberObject = GetMemberObject(calledObject, *memberName);
-					if (memberObject == nullptr)
-					{
-						InvokeError(ERROR::MEMBER_NOT_FOUND, "member was not found: " + calledObject->ToString() + '.' + *memberName, *memberName);
-						break;
-					}
-					if (AssertType(memberObject, Type::ATTRIBUTE))
-					{
-						const AttributeType* type = static_cast<AttributeObject*>(memberObject)->type;
-						if (!AssertType(calledObject, Type::CLASS_OBJECT) &&
-							!AssertType(calledObject, Type::CLASS, "trying to get attribute from object which is neither class, nor class object", frame))
-							break;
-
-						if (!type->isPublic())
-						{
-							const ClassType* classType = nullptr;
-							if (AssertType(calledObject, Type::CLASS))
-							{
-								classType = static_cast<ClassWrapper*>(calledObject)->typeInstance;
-							}
-							else
-							{
-								classType = static_cast<ClassObject*>(calledObject)->typeInstance;
-							}
-							if (classType != frame->_class)
-							{
-								InvokeError(ERROR::PRIVATE_MEMBER_ACCESS, "trying to access class private member: " + GetFullClassType(classType) + '.' + type->name, type->name);
-								break;
-							}
-						}
-					}
-					objectStack.push_back(memberObject);
+					FRAME_ACTION(PerformGetMember(frame));
 					break;
-				}
-				case (OPCODE::POP_TO_RETURN):
-					if (objectStack.empty())
-					{
-						InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "object stack is empty, but `return` instruction called", "");
-					}
-					else
-					{
-						BaseObject* obj = objectStack.back();
-						if (AssertType(obj, Type::UNKNOWN)) obj = ResolveReference(obj, frame->locals, frame->_method, frame->classObject, frame->_namespace);
-						if (obj == nullptr) break; // ResolveReference handles errors
-						objectStack.back() = obj;
-					}
-					callStack.pop_back();
-					return;
 				case (OPCODE::ALLOC_VAR):
 				{
 					size_t hash = ReadHash(frame->_method->body, frame->offset);
@@ -770,18 +722,10 @@ namespace MSL
 					objectStack.push_back(AllocFalse());
 					break;
 				case (OPCODE::PUSH_CATCH):
-					frame->exceptionStack.push_back({
-						objectStack.size(),
-						ReadLabel(frame->_method->body, frame->offset)
-					});
+					// try blocks are found in exception table of method, so entering them costs nothing
+					ReadLabel(frame->_method->body, frame->offset);
 					break;
 				case (OPCODE::POP_CATCH):
-					if (frame->exceptionStack.empty())
-					{
-						InvokeError(ERROR::EXCEPTIONSTACK_EMPTY | ERROR::FATAL_ERROR, "exception handler was already popped", GetMethodActualName(frame->_method->name));
- 						return;
-					}
-					frame->exceptionStack.pop_back();
 					break;
 				case (OPCODE::JUMP_IF_TRUE):
 				{
@@ -808,7 +752,11 @@ namespace MSL
 						frame->offset = frame->_method->labels[label];
 					else if (object->type != Type::FALSE && object->type != Type::NULLPTR)
 					{
-						InvokeError(ERROR::INVALID_TYPE, "objects cannot be implicitly converted to Boolean", object->ToString());
+						InvokeError(ERROR::INVALID_TYPE, [object](std::string& message, std::string& argument)
+						{
+							message = "objects cannot be implicitly converted to Boolean";
+							argument = object->ToString();
+						});
 					}
 					break;
 				}
@@ -842,77 +790,991 @@ namespace MSL
 						break;
 					break;
 				}
+				case (OPCODE::JUMP_IF_FALSE_KEEP):
+				case (OPCODE::JUMP_IF_TRUE_KEEP):
+				{
+					// short-circuit of `&&` and `||`: jumps only if stack top is Boolean which already is the result
+					// any other object stays on the stack and is passed to CMP_AND / CMP_OR with the right operand
+					auto label = ReadLabel(frame->_method->body, frame->offset);
+					if (objectStack.empty())
+					{
+						InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "object stack is empty, but " + OpcodeToMethod(op) + " needs operand", OpcodeToMethod(op));
+						return;
+					}
+					BaseObject* object = objectStack.back();
+					if (AssertType(object, Type::UNKNOWN)) object = ResolveReference(object, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+					if (object == nullptr) break;
+					object = GetUnderlyingObject(object);
+					objectStack.back() = object;
+
+					Type result = (op == OPCODE::JUMP_IF_FALSE_KEEP) ? Type::FALSE : Type::TRUE;
+					if (AssertType(object, result))
+						frame->offset = frame->_method->labels[label];
+					break;
+				}
 				case (OPCODE::PUSH_STRING):
 				{
-					size_t hash = ReadHash(frame->_method->body, frame->offset);
-					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
-						objectStack.push_back(AllocString(frame->_method->dependencies[hash]));
-					break;
+					size_t hash = ReadHash(frame->_method->body, frame->offset);
+					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
+						objectStack.push_back(AllocString(frame->_method->dependencies[hash]));
+					break;
+				}
+				case (OPCODE::PUSH_INTEGER):
+				{
+					size_t hash = ReadHash(frame->_method->body, frame->offset);
+					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
+					{
+						if (!frame->integerCache.Has(hash))
+							frame->integerCache.Add(hash, 
+								IntegerObject::InnerType(frame->_method->dependencies[hash])
+							);
+						objectStack.push_back(AllocInteger(frame->integerCache[hash]));
+					}
+					break;
+				}
+				case (OPCODE::PUSH_FLOAT):
+				{
+					size_t hash = ReadHash(frame->_method->body, frame->offset);
+					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
+					{
+						if (!frame->floatCache.Has(hash))
+							frame->floatCache.Add(hash,
+								FloatObject::InnerType(std::stod(frame->_method->dependencies[hash]))
+							);
+						objectStack.push_back(AllocFloat(frame->floatCache[hash]));
+					}
+					break;
+				}
+				case (OPCODE::PUSH_THIS):
+					objectStack.push_back(frame->classObject);
+					break;
+				case (OPCODE::PUSH_NULL):
+					objectStack.push_back(AllocNull());
+					break;
+				case (OPCODE::SET_ALU_INCR):
+					AluIncrMode = true;
+					break;
+				case (OPCODE::RETURN):
+				case (OPCODE::POP_TO_RETURN):
+					FRAME_ACTION(PerformReturn(frame, op));
+					break;
+				case (OPCODE::JUMP):
+				{
+					size_t target = frame->_method->labels[ReadLabel(frame->_method->body, frame->offset)];
+					if (target < frame->offset) UpdateHotness(frame->_method); // loop back-edge
+					frame->offset = target;
+					break;
+				}
+				case (OPCODE::POP_STACK_TOP):
+					if (objectStack.empty())
+					{
+						InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "pop_stack_top instruction called, but object stack was empty", "pop_stack_top");
+ 						return;
+					}
+					objectStack.pop_back();
+					break;
+				case (OPCODE::ITER_INIT):
+					PerformIterationInit(frame);
+					break;
+				case (OPCODE::ITER_NEXT):
+					PerformIterationNext(frame);
+					break;
+				case (OPCODE::LOAD_LOCAL):
+				{
+					size_t hash = ReadHash(frame->_method->body, frame->offset);
+					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
+					{
+						// value is only read here, so the local keeps ownership of it (see PerformALUCall)
+						Local* local = GetLocalSlot(frame, hash);
+						if (local != nullptr)
+							objectStack.push_back(local->object);
+						else // local is not declared yet, name will be resolved as after PUSH_OBJECT
+							objectStack.push_back(AllocUnknown(&frame->_method->dependencies[hash]));
+					}
+					break;
+				}
+				case (OPCODE::STORE_LOCAL):
+					PerformStoreLocal(frame);
+					break;
+				default:
+					InvokeError(ERROR::INVALID_BYTECODE | ERROR::FATAL_ERROR, "opcode " + OpcodeToMethod(op) + " was found, but not expected", OpcodeToMethod(op));
+					break;
+				}
+			}
+			InvokeError(ERROR::INVALID_BYTECODE | ERROR::FATAL_ERROR, "execution of method went out of frame", std::to_string(frame->offset));
+		}
+
+		VirtualMachine::FrameAction VirtualMachine::PerformFunctionCall(Frame* frame, OPCODE op)
+		{
+            // CALL_FUNCTION [function hash] [arg count]
+            const size_t instructionOffset = frame->offset - 1;
+            size_t hash = ReadHash(frame->_method->body, frame->offset);
+            if (!ValidateHashValue(hash, frame->_method->dependencies.size()))
+                return FrameAction::RETURN;
+
+            const std::string* functionName = &frame->_method->dependencies[hash];
+
+			uint8_t paramSize = ReadOPCode(frame->_method->body, frame->offset);
+			if (objectStack.size() < paramSize + 1u) // arg count + caller object
+			{
+				InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "not enough parameters in stack for function call", !objectStack.empty() ? GetMethodActualName(objectStack.back()->ToString()) : "");
+				return FrameAction::RETURN;
+			}
+
+			if (!ResolveCallArguments(frame, paramSize)) return FrameAction::RETURN;
+			CallPath newFrame;
+			BaseObject* caller = objectStack[objectStack.size() - paramSize - 1];
+			if (AssertType(caller, Type::UNKNOWN)) caller = ResolveReference(caller, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+			if (caller == nullptr) return FrameAction::RETURN; // check performed in ResolveReference method
+
+			caller = GetUnderlyingObject(caller);
+			caller->unique = false;
+			// trivial methods found by FindInlineMethods() are executed without creating a frame
+			const ClassType* inlineClass = nullptr;
+			const MethodType* inlineMethod = nullptr;
+			switch (caller->type)
+			{
+			case Type::CLASS_OBJECT:
+			{
+				ClassObject* object = static_cast<ClassObject*>(caller);
+
+                newFrame.SetNamespace(&object->typeInstance->namespaceName);
+                newFrame.SetClass(&object->typeInstance->name);
+				
+                // as class method has extra implicit argument `this`, we must modify function name
+				std::string objectFunctionName = GetMethodActualName(*functionName) + '_' + std::to_string(paramSize + 1);
+				auto methodIt = object->typeInstance->methods.find(objectFunctionName);
+				if (methodIt != object->typeInstance->methods.end())
+				{
+                    objectStack[objectStack.size() - paramSize - 1] = object; // unknown object is resolved now
+                    newFrame.SetMethod(&methodIt->first);
+					if (op == OPCODE::CALL_FUNCTION)
+						QuickenMethodCall(frame, instructionOffset, object->typeInstance, &methodIt->first);
+					inlineClass = object->typeInstance;
+					inlineMethod = &methodIt->second;
+				}
+                else
+                {
+                    newFrame.SetMethod(functionName);
+                }
+				callStack.push_back(std::move(newFrame));
+			}
+			break;
+			case Type::CLASS:
+			{
+				ClassWrapper* object = static_cast<ClassWrapper*>(caller);
+				objectStack[objectStack.size() - paramSize - 1] = object;
+				newFrame.SetNamespace(&object->typeInstance->namespaceName);
+				newFrame.SetClass(&object->typeInstance->name);
+				newFrame.SetMethod(functionName);
+				callStack.push_back(std::move(newFrame));
+				if (config.execution.inlineMethods)
+				{
+					const MethodType* method = GetMethodOrNull(object->typeInstance, *functionName);
+					if (method != nullptr && method->isStatic())
+					{
+						inlineClass = object->typeInstance;
+						inlineMethod = method;
+					}
+				}
+			}
+			break;
+			case Type::NAMESPACE:
+			{
+				UnknownObject* function = static_cast<UnknownObject*>(objectStack.back());
+				// top of stack must be unknown object (function name)
+				std::string className = GetMethodActualName(*functionName);
+				const NamespaceType* ns = static_cast<NamespaceWrapper*>(caller)->type;
+				auto classIt = ns->classes.find(className);
+				if (classIt == ns->classes.end())
+				{
+					InvokeError(ERROR::MEMBER_NOT_FOUND, [className, ns](std::string& message, std::string& argument)
+					{
+						message = "class `" + className + "` was not found in namespace: " + ns->name;
+						argument = className;
+					});
+					return FrameAction::RETURN;
+				}
+				else if (classIt->second.IsPrivate() && ns->name != frame->_namespace->name)
+				{
+					InvokeError(ERROR::PRIVATE_MEMBER_ACCESS, [this, _class = &classIt->second](std::string& message, std::string& argument)
+					{
+						message = "trying to access namespace internal member: " + GetFullClassType(_class);
+						argument = _class->name;
+					});
+					return FrameAction::RETURN;
+				}
+				objectStack[objectStack.size() - paramSize - 1] = classIt->second.wrapper;
+				newFrame.SetNamespace(GetObjectName(caller));
+				newFrame.SetClass(&classIt->second.name);
+				newFrame.SetMethod(functionName);
+				callStack.push_back(std::move(newFrame));
+				break;
+			}
+			case Type::INTEGER:
+			case Type::FLOAT:
+			case Type::STRING:
+			case Type::TRUE:
+			case Type::FALSE:
+			case Type::NULLPTR:
+			{
+				objectStack[objectStack.size() - paramSize - 1] = caller;
+				const ClassType* cl = GetClassPrimitive(caller)->typeInstance;
+				newFrame.SetNamespace(&cl->namespaceName);
+				newFrame.SetClass(&cl->name);
+				newFrame.SetMethod(functionName);
+				callStack.push_back(std::move(newFrame));
+				break;
+			}
+			default:
+				InvokeError(ERROR::INVALID_TYPE, [caller](std::string& message, std::string& argument)
+				{
+					message = "caller of method was neither class object nor class type";
+					argument = caller->ToString();
+				});
+				return FrameAction::RETURN;
+			}
+
+			if (inlineMethod != nullptr && TryInlineCall(frame, inlineClass, inlineMethod, paramSize))
+			{
+				callStack.pop_back(); // frame of called method is not needed
+				return FrameAction::CONTINUE;
+			}
+			// frame can be reused only if no exception handler of this method can catch errors of called method
+			if (op == OPCODE::TAIL_CALL && FindExceptionHandler(frame->_method, instructionOffset) == nullptr && CanReuseFrame(frame, callStack.back()))
+			{
+				// arguments cannot reference locals of the frame, as they are cleared. Other arguments are passed as by CALL_FUNCTION
+				for (size_t i = objectStack.size() - paramSize - 1; i < objectStack.size(); i++)
+				{
+					if (AssertType(objectStack[i], Type::LOCAL) && IsFrameLocal(frame, static_cast<LocalObject*>(objectStack[i])))
+						objectStack[i] = GetUnderlyingObject(objectStack[i]);
+				}
+				if (frame->tailCalls == 0) frame->tailCaller = { frame->_class, frame->_method, frame->offset };
+				frame->tailCalls++;
+				CallPath callee = std::move(callStack.back());
+				callStack.pop_back();
+				frame->Reset();
+				callee.SetFrame(frame);
+				callStack.back() = std::move(callee);
+				return FrameAction::TAIL_CALL;
+			}
+			StartNewStackFrame();
+			return FrameAction::CONTINUE;
+		}
+
+		VirtualMachine::FrameAction VirtualMachine::PerformMethodCall(Frame* frame)
+		{
+			// CALL_METHOD [function hash] [arg count], method is taken from inline cache if receiver class matches it
+			const size_t instructionOffset = frame->offset - 1;
+			ReadHash(frame->_method->body, frame->offset);
+			uint8_t paramSize = ReadOPCode(frame->_method->body, frame->offset);
+			const MethodType::CallCache& cache = frame->_method->callCaches[instructionOffset];
+
+			BaseObject* caller = objectStack.size() > paramSize ? objectStack[objectStack.size() - paramSize - 1] : nullptr;
+			if (caller != nullptr && AssertType(caller, Type::UNKNOWN))
+			{
+				caller = ResolveReference(caller, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+				if (caller == nullptr) return FrameAction::RETURN; // check performed in ResolveReference method
+			}
+			if (caller != nullptr) caller = GetUnderlyingObject(caller);
+			if (caller == nullptr || !AssertType(caller, Type::CLASS_OBJECT) || static_cast<ClassObject*>(caller)->typeInstance != cache.receiver)
+			{
+				// guard failed: generic instruction is restored and executed again
+				Despecialize(frame, instructionOffset);
+				frame->offset = instructionOffset;
+				return FrameAction::CONTINUE;
+			}
+			if (!ResolveCallArguments(frame, paramSize)) return FrameAction::RETURN;
+			caller->unique = false;
+			objectStack[objectStack.size() - paramSize - 1] = caller;
+			if (cache.target != nullptr && TryInlineCall(frame, cache.receiver, cache.target, paramSize))
+				return FrameAction::CONTINUE;
+
+			CallPath newFrame;
+			newFrame.SetNamespace(&cache.receiver->namespaceName);
+			newFrame.SetClass(&cache.receiver->name);
+			newFrame.SetMethod(cache.method);
+			callStack.push_back(std::move(newFrame));
+			StartNewStackFrame();
+			return FrameAction::CONTINUE;
+		}
+
+		VirtualMachine::FrameAction VirtualMachine::PerformGetMember(Frame* frame)
+		{
+			if (objectStack.size() < 1)
+			{
+				InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "not enough objects in stack to get member", !objectStack.empty() ? objectStack.back()->ToString() : "");
+				return FrameAction::CONTINUE;
+			}
+            size_t hash = ReadHash(frame->_method->body, frame->offset);
+            if (!ValidateHashValue(hash, frame->_method->dependencies.size()))
+                return FrameAction::RETURN;
+
+            const std::string* memberName = &frame->_method->dependencies[hash];
+
+			BaseObject* calledObject = objectStack.back();
+			objectStack.pop_back();
+			if (AssertType(calledObject, Type::UNKNOWN)) calledObject = ResolveReference(calledObject, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+			if (calledObject == nullptr) return FrameAction::CONTINUE; // check performed in ResolveReference method
+
+			BaseObject* memberObject = GetMemberObject(calledObject, *memberName);
+			if (memberObject == nullptr)
+			{
+				InvokeError(ERROR::MEMBER_NOT_FOUND, [calledObject, memberName](std::string& message, std::string& argument)
+				{
+					message = "member was not found: " + calledObject->ToString() + '.' + *memberName;
+					argument = *memberName;
+				});
+				return FrameAction::CONTINUE;
+			}
+			if (AssertType(memberObject, Type::ATTRIBUTE))
+			{
+				const AttributeType* type = static_cast<AttributeObject*>(memberObject)->type;
+				if (!AssertType(calledObject, Type::CLASS_OBJECT) &&
+					!AssertType(calledObject, Type::CLASS, "trying to get attribute from object which is neither class, nor class object", frame))
+					return FrameAction::CONTINUE;
+
+				if (!type->isPublic())
+				{
+					const ClassType* classType = nullptr;
+					if (AssertType(calledObject, Type::CLASS))
+					{
+						classType = static_cast<ClassWrapper*>(calledObject)->typeInstance;
+					}
+					else
+					{
+						classType = static_cast<ClassObject*>(calledObject)->typeInstance;
+					}
+					if (classType != frame->_class)
+					{
+						InvokeError(ERROR::PRIVATE_MEMBER_ACCESS, [this, classType, type](std::string& message, std::string& argument)
+						{
+							message = "trying to access class private member: " + GetFullClassType(classType) + '.' + type->name;
+							argument = type->name;
+						});
+						return FrameAction::CONTINUE;
+					}
+				}
+			}
+			objectStack.push_back(memberObject);
+			return FrameAction::CONTINUE;
+		}
+
+		VirtualMachine::FrameAction VirtualMachine::PerformReturn(Frame* frame, OPCODE op)
+		{
+			if (op == OPCODE::RETURN)
+			{
+				if (frame->_method->isConstructor())
+				{
+					objectStack.push_back(frame->locals["this"].object);
+				}
+				else
+				{
+					objectStack.push_back(AllocNull());
+				}
+				callStack.pop_back();
+				return FrameAction::RETURN;
+	
+			}
+			if (objectStack.empty())
+			{
+				InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "object stack is empty, but `return` instruction called", "");
+			}
+			else
+			{
+				BaseObject* obj = objectStack.back();
+				if (AssertType(obj, Type::UNKNOWN)) obj = ResolveReference(obj, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+				if (obj == nullptr) return FrameAction::CONTINUE; // ResolveReference handles errors
+				obj->unique = false;
+				objectStack.back() = obj;
+			}
+			callStack.pop_back();
+			return FrameAction::RETURN;
+		}
+
+		Local* VirtualMachine::GetLocalSlot(Frame* frame, size_t hash)
+		{
+			// locals are never erased from frame, so found local can be cached by its hash
+			if (frame->localSlots.empty())
+			{
+				frame->localSlots.resize(frame->_method->dependencies.size(), nullptr);
+			}
+			Local*& slot = frame->localSlots[hash];
+			if (slot == nullptr)
+			{
+				auto localIt = frame->locals.find(frame->_method->dependencies[hash]);
+				if (localIt != frame->locals.end()) slot = &localIt->second;
+			}
+			return slot;
+		}
+
+		void VirtualMachine::PerformStoreLocal(Frame* frame)
+		{
+			// STORE_LOCAL [local hash]
+			size_t hash = ReadHash(frame->_method->body, frame->offset);
+			if (!ValidateHashValue(hash, frame->_method->dependencies.size())) return;
+			PerformStoreLocal(frame, hash);
+		}
+
+		void VirtualMachine::PerformStoreLocal(Frame* frame, size_t hash)
+		{
+			if (objectStack.empty())
+			{
+				InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "object stack is empty, but store_local needs value to assign", "store_local");
+				return;
+			}
+			const std::string& localName = frame->_method->dependencies[hash];
+			Local* local = GetLocalSlot(frame, hash);
+			if (local == nullptr)
+			{
+				// local is not declared yet, so assignment target is resolved by name as in ASSIGN_OP
+				BaseObject* value = objectStack.back();
+				objectStack.back() = AllocUnknown(&localName);
+				objectStack.push_back(value);
+				PerformALUCall(OPCODE::ASSIGN_OP, 2, frame);
+				return;
+			}
+
+			BaseObject* value = objectStack.back();
+			if (AssertType(value, Type::UNKNOWN))
+			{
+				value = ResolveReference(value, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+				if (value == nullptr) return; // ResolveReference handles errors
+			}
+			value = GetUnderlyingObject(value);
+			if (local->isConst && local->object->type != Type::NULLPTR)
+			{
+				InvokeError(ERROR::CONST_MEMBER_MODIFICATION, [&localName, value](std::string& message, std::string& argument)
+				{
+					message = "trying to modify const local variable: " + localName + " = " + value->ToString();
+					argument = localName;
+				});
+				return;
+			}
+			local->object = value;
+			value->unique = false;
+			objectStack.back() = value;
+		}
+
+		bool VirtualMachine::ResolveCallArguments(Frame* frame, uint8_t paramSize)
+		{
+			for (size_t i = 0; i < paramSize; i++)
+			{
+				size_t index = objectStack.size() - i - 1;
+				BaseObject* obj = objectStack[index];
+				if (AssertType(obj, Type::UNKNOWN))
+				{
+					objectStack[index] = ResolveReference(objectStack[index], frame->locals, frame->_method, frame->classObject, frame->_namespace);
+					if (objectStack[index] == nullptr) return false;
+				}
+				objectStack[index]->unique = false; // arguments read by LOAD_LOCAL can be stored by system methods
+			}
+			return true;
+		}
+
+		// instruction which was despecialized once is never quickened again
+		constexpr uint8_t MEGAMORPHIC_SITE = 0xFF;
+
+		static uint8_t& GetTypeFeedback(const MethodType* method, size_t offset)
+		{
+			if (method->feedback.size() != method->body.size())
+			{
+				method->feedback.resize(method->body.size(), 0);
+			}
+			return method->feedback[offset];
+		}
+
+		void VirtualMachine::QuickenALUCall(OPCODE op, Frame* frame)
+		{
+			if (!config.quickening.enabled || AluIncrMode || objectStack.size() < 2) return;
+
+			const BaseObject* lhs = objectStack[objectStack.size() - 2];
+			const BaseObject* rhs = objectStack.back();
+			OPCODE specialized = op;
+			if (lhs->type == rhs->type)
+			{
+				if (AssertType(lhs, Type::INTEGER)) specialized = ToIntegerOpcode(op);
+				else if (AssertType(lhs, Type::FLOAT)) specialized = ToFloatOpcode(op);
+				else if (AssertType(lhs, Type::STRING) && op == OPCODE::SUM_OP) specialized = OPCODE::SUM_STRING;
+			}
+
+			// feedback stores specialization observed by previous execution of the instruction
+			const size_t offset = frame->offset - 1;
+			uint8_t& feedback = GetTypeFeedback(frame->_method, offset);
+			if (feedback == MEGAMORPHIC_SITE) return;
+			if (specialized != op && feedback == specialized)
+			{
+				// methods are owned by VM, so body can be rewritten in place: specialized instruction has the same size
+				const_cast<MethodType*>(frame->_method)->body[offset] = specialized;
+				quickeningStats.aluSpecialized++;
+			}
+			feedback = (specialized != op) ? static_cast<uint8_t>(specialized) : 0;
+		}
+
+		void VirtualMachine::QuickenMethodCall(Frame* frame, size_t offset, const ClassType* receiver, const std::string* method)
+		{
+			if (!config.quickening.enabled) return;
+
+			uint8_t& feedback = GetTypeFeedback(frame->_method, offset);
+			if (feedback == MEGAMORPHIC_SITE) return;
+			MethodType::CallCache& cache = frame->_method->callCaches[offset];
+			// JIT-compiled code keeps calling generic instruction, so it is counted only once
+			if (cache.receiver == receiver && frame->_method->body[offset] != OPCODE::CALL_METHOD)
+			{
+				const_cast<MethodType*>(frame->_method)->body[offset] = OPCODE::CALL_METHOD;
+				quickeningStats.callsSpecialized++;
+			}
+			cache.receiver = receiver;
+			cache.method = method;
+			cache.target = &receiver->methods.find(*method)->second;
+			feedback = OPCODE::CALL_METHOD;
+		}
+
+		void VirtualMachine::Despecialize(Frame* frame, size_t offset)
+		{
+			if (!config.quickening.enabled) return;
+
+			MethodType* method = const_cast<MethodType*>(frame->_method);
+			method->body[offset] = ToGenericOpcode(static_cast<OPCODE>(method->body[offset]));
+			GetTypeFeedback(method, offset) = MEGAMORPHIC_SITE;
+			quickeningStats.despecialized++;
+		}
+
+		void VirtualMachine::UpdateHotness(const MethodType* method)
+		{
+			if (!config.execution.useJit || method->jitMethod != nullptr || method->aotMethod != nullptr) return;
+
+			method->hotness++;
+			if (method->hotness == config.execution.jitThreshold)
+			{
+				method->jitMethod = jit.Compile(this, method, GetFullMethodType(method), config.execution.writePerfMap);
+			}
+		}
+
+		void VirtualMachine::FindInlineMethods()
+		{
+			for (const auto& ns : assembly.namespaces)
+			{
+				for (const auto& cl : ns.second.classes)
+				{
+					const ClassType& classType = cl.second;
+					if (classType.isSystem()) continue;
+					for (const auto& methodPair : classType.methods)
+					{
+						// methods which are not decoded yet are checked by DecodeMethod() on first call
+						if (methodPair.second.encodedBody == nullptr)
+							FindInlineKind(classType, methodPair.second);
+					}
+				}
+			}
+		}
+
+		bool VirtualMachine::DecodeMethod(const ClassType* _class, const MethodType* method)
+		{
+			if (method->encodedBody == nullptr) return true;
+			if (!AssemblyEditor::DecodeMethodBody(*method, config.streams.error))
+			{
+				InvokeError(ERROR::INVALID_BYTECODE | ERROR::FATAL_ERROR, "body of method " + GetFullClassType(_class) + '.' + GetFullMethodType(method) + " is invalid", GetMethodActualName(method->name));
+				return false;
+			}
+			if (config.execution.inlineMethods) FindInlineKind(*_class, *method);
+			return true;
+		}
+
+		void VirtualMachine::FindInlineKind(const ClassType& classType, const MethodType& method)
+		{
+			using InlineKind = MethodType::InlineKind;
+			std::vector<JitMethod::Instruction> code;
+			method.inlineKind = InlineKind::NONE;
+			if (method.isConstructor() || method.isAbstract()) return;
+
+			// shortest pattern is two instructions, last instruction marks the body end
+			if (!JitCompiler::Decode(&method, code) || code.size() < 3) return;
+			// implicit `this` is the first parameter of instance methods
+			const size_t thisParam = method.isStatic() ? 0 : 1;
+			auto isAttribute = [&](const std::string& name)
+			{
+				if (std::find(method.parameters.begin(), method.parameters.end(), name) != method.parameters.end()) return false;
+				return classType.staticAttributes.count(name) != 0 || (!method.isStatic() && classType.objectAttributes.count(name) != 0);
+			};
+			// attribute reference is either `attr` or `this.attr`
+			size_t i = 0;
+			const std::string* attribute = nullptr;
+			if (code[0].op == OPCODE::PUSH_OBJECT && isAttribute(method.dependencies[code[0].operand]))
+			{
+				attribute = &method.dependencies[code[0].operand];
+				i = 1;
+			}
+			else if (code[0].op == OPCODE::PUSH_THIS && code[1].op == OPCODE::GET_MEMBER)
+			{
+				size_t hash;
+				std::memcpy(&hash, &method.body[code[1].offset + 1], sizeof(size_t));
+				if (hash < method.dependencies.size() && isAttribute(method.dependencies[hash]))
+					attribute = &method.dependencies[hash];
+				i = 2;
+			}
+
+			InlineKind kind = InlineKind::NONE;
+			const std::string* operand = attribute;
+			if (attribute != nullptr && code[i].op == OPCODE::POP_TO_RETURN && method.parameters.size() == thisParam)
+			{
+				kind = InlineKind::GETTER;
+				i += 1;
+			}
+			else if (attribute != nullptr && method.parameters.size() == thisParam + 1 && code.size() > i + 4 &&
+				(code[i].op == OPCODE::PUSH_OBJECT || code[i].op == OPCODE::LOAD_LOCAL) &&
+				method.dependencies[code[i].operand] == method.parameters.back() &&
+				code[i + 1].op == OPCODE::ASSIGN_OP && code[i + 2].op == OPCODE::POP_STACK_TOP && code[i + 3].op == OPCODE::RETURN)
+			{
+				kind = InlineKind::SETTER;
+				i += 4;
+			}
+			else if (attribute == nullptr && code[1].op == OPCODE::POP_TO_RETURN)
+			{
+				switch (code[0].op)
+				{
+				case OPCODE::PUSH_TRUE:
+					kind = InlineKind::RETURN_TRUE;
+					break;
+				case OPCODE::PUSH_FALSE:
+					kind = InlineKind::RETURN_FALSE;
+					break;
+				case OPCODE::PUSH_NULL:
+					kind = InlineKind::RETURN_NULL;
+					break;
+				case OPCODE::PUSH_STRING:
+					kind = InlineKind::RETURN_STRING;
+					operand = &method.dependencies[code[0].operand];
+					break;
+				default:
+					break;
+				}
+				i = 2;
+			}
+			// only unreachable returns may follow the pattern, last instruction marks the body end
+			while (i < code.size() - 1 && code[i].op == OPCODE::RETURN) i++;
+			if (kind == InlineKind::NONE || i != code.size() - 1) return;
+
+			method.inlineKind = kind;
+			method.inlineOperand = operand;
+		}
+
+		const MethodType::ExceptionHandler* VirtualMachine::FindExceptionHandler(const MethodType* method, size_t offset)
+		{
+			if (!method->hasExceptionTable)
+			{
+				method->hasExceptionTable = true;
+				std::vector<JitMethod::Instruction> code;
+				if (JitCompiler::Decode(method, code))
+				{
+					// handlers rely on try block being a statement: PUSH_CATCH is generated only for TRY_STATEMENT, which parser accepts
+					// only in statement position, and foreach keeps its iterator in locals, so object stack is at Frame::stackBase
+					// at the beginning of every block and StartNewStackFrame() restores it by resizing stack to stackBase before handler is entered
+					std::vector<MethodType::ExceptionHandler> tryBlocks;
+					for (const JitMethod::Instruction& instruction : code)
+					{
+						if (instruction.op == OPCODE::PUSH_CATCH)
+						{
+							uint16_t label;
+							std::memcpy(&label, &method->body[instruction.offset + 1], sizeof(uint16_t));
+							// handler code follows try block, so it bounds block which is never closed
+							if (label < method->labels.size())
+								tryBlocks.push_back({ instruction.next, std::max(instruction.next, method->labels[label]), label });
+						}
+						else if (instruction.op == OPCODE::POP_CATCH && !tryBlocks.empty())
+						{
+							tryBlocks.back().end = instruction.offset;
+							method->exceptionTable.push_back(tryBlocks.back());
+							tryBlocks.pop_back();
+						}
+					}
+					method->exceptionTable.insert(method->exceptionTable.end(), tryBlocks.rbegin(), tryBlocks.rend());
+				}
+			}
+			for (const MethodType::ExceptionHandler& handler : method->exceptionTable)
+			{
+				if (handler.begin <= offset && offset < handler.end)
+					return &handler;
+			}
+			return nullptr;
+		}
+
+		std::string VirtualMachine::GetTraceString(const ExceptionTrace::TraceEntry& entry) const
+		{
+			std::string trace = GetFullClassType(entry._class) + '.' + GetMethodActualName(entry._method->name);
+			if (entry.tailCalls > 0) trace += " (" + std::to_string(entry.tailCalls) + " tail calls elided)";
+			return trace;
+		}
+
+		bool VirtualMachine::CanReuseFrame(const Frame* frame, const CallPath& callee) const
+		{
+			// constructor frame must return its `this` object
+			if (frame->_method->isConstructor()) return false;
+			// constructor of callee is delegated to a new frame and system methods do not use frame at all
+			const NamespaceType* ns = GetNamespaceOrNull(*callee.GetNamespace());
+			const ClassType* _class = ns != nullptr ? GetClassOrNull(ns, *callee.GetClass()) : nullptr;
+			const MethodType* method = _class != nullptr ? GetMethodOrNull(_class, *callee.GetMethod()) : nullptr;
+			return method != nullptr && !method->isConstructor() && !_class->isSystem();
+		}
+
+		bool VirtualMachine::IsFrameLocal(const Frame* frame, const LocalObject* local) const
+		{
+			auto it = frame->locals.find(local->name);
+			return it != frame->locals.end() && &it->second == &local->ref;
+		}
+
+		bool VirtualMachine::TryInlineCall(Frame* frame, const ClassType* _class, const MethodType* method, uint8_t paramSize)
+		{
+			using InlineKind = MethodType::InlineKind;
+			if (method->inlineKind == InlineKind::NONE) return false;
+			// cases in which StartNewStackFrame() reports an error or calls static constructor first
+			if (!method->isPublic() && frame->_class != _class) return false;
+			if (_class->HasStaticConstructor() && !_class->staticConstructorCalled) return false;
+
+			BaseObject* result = nullptr;
+			const size_t callerIndex = objectStack.size() - paramSize - 1;
+			switch (method->inlineKind)
+			{
+			case InlineKind::GETTER:
+			case InlineKind::SETTER:
+			{
+				BaseObject* receiver = method->isStatic() ? _class->wrapper : objectStack[callerIndex];
+				BaseObject* attribute = GetMemberObject(receiver, *method->inlineOperand);
+				if (attribute == nullptr) return false;
+				attribute->unique = false;
+				if (method->inlineKind == InlineKind::GETTER)
+				{
+					result = attribute;
+					break;
+				}
+				// stack is [attribute, value], both are already resolved by ResolveCallArguments()
+				objectStack[callerIndex] = attribute;
+				objectStack.back()->unique = false;
+				PerformALUCall(OPCODE::ASSIGN_OP, 2, frame);
+				if (errors != 0) return true;
+				result = AllocNull();
+				break;
+			}
+			case InlineKind::RETURN_TRUE:
+				result = AllocTrue();
+				break;
+			case InlineKind::RETURN_FALSE:
+				result = AllocFalse();
+				break;
+			case InlineKind::RETURN_NULL:
+				result = AllocNull();
+				break;
+			case InlineKind::RETURN_STRING:
+				result = AllocString(*method->inlineOperand);
+				break;
+			default:
+				return false;
+			}
+			// caller object and arguments are replaced by the returned value
+			objectStack.resize(callerIndex + 1);
+			objectStack.back() = result;
+			return true;
+		}
+
+		void VirtualMachine::PerformIterationInit(Frame* frame)
+		{
+			// ITER_INIT [container hash] [iterator hash]
+			size_t containerHash = ReadHash(frame->_method->body, frame->offset);
+			size_t iteratorHash = ReadHash(frame->_method->body, frame->offset);
+			if (!ValidateHashValue(containerHash, frame->_method->dependencies.size())) return;
+			if (!ValidateHashValue(iteratorHash, frame->_method->dependencies.size())) return;
+			PerformIterationInit(frame, containerHash, iteratorHash);
+		}
+
+		void VirtualMachine::PerformIterationInit(Frame* frame, size_t containerHash, size_t iteratorHash)
+		{
+
+			if (objectStack.empty())
+			{
+				InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "object stack is empty, but foreach needs container to iterate", "foreach");
+				return;
+			}
+			BaseObject* container = objectStack.back();
+			objectStack.pop_back();
+			if (AssertType(container, Type::UNKNOWN)) container = ResolveReference(container, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+			if (container == nullptr) return; // error is handled in ResolveReference method
+			container = GetUnderlyingObject(container);
+			container->unique = false; // container must not be modified in place while it is iterated
+
+			frame->locals[frame->_method->dependencies[containerHash]] = { container, false };
+			Local& iterator = frame->locals[frame->_method->dependencies[iteratorHash]] = { AllocNull(), false };
+
+			if (AssertType(container, Type::STRING) || GetNativeArrayOrNull(container) != nullptr)
+			{
+				iterator.object = AllocInteger(0);
+			}
+			else if (IsNativeRange(container))
+			{
+				// iterator is owned by foreach, so it can be safely modified by ITER_NEXT
+				BaseObject* first = static_cast<ClassObject*>(container)->attributes["first"]->object;
+				iterator.object = AllocInteger(static_cast<IntegerObject*>(first)->value);
+			}
+			else if (AssertType(container, Type::CLASS_OBJECT))
+			{
+				objectStack.push_back(container);
+				InvokeObjectMethod("Begin_1", static_cast<ClassObject*>(container));
+				if (errors != 0) return;
+				iterator.object = GetUnderlyingObject(objectStack.back());
+				objectStack.pop_back();
+			}
+			else
+			{
+				InvokeError(ERROR::INVALID_TYPE, [container](std::string& message, std::string& argument)
+				{
+					message = "object with type " + ToString(container->type) + " cannot be iterated in foreach statement";
+					argument = container->ToString();
+				});
+			}
+		}
+
+		void VirtualMachine::PerformIterationNext(Frame* frame)
+		{
+			// ITER_NEXT [element hash] [container hash] [iterator hash] [end label]
+			size_t elementHash = ReadHash(frame->_method->body, frame->offset);
+			size_t containerHash = ReadHash(frame->_method->body, frame->offset);
+			size_t iteratorHash = ReadHash(frame->_method->body, frame->offset);
+			uint16_t label = ReadLabel(frame->_method->body, frame->offset);
+			if (!ValidateHashValue(elementHash, frame->_method->dependencies.size())) return;
+			if (!ValidateHashValue(containerHash, frame->_method->dependencies.size())) return;
+			if (!ValidateHashValue(iteratorHash, frame->_method->dependencies.size())) return;
+			PerformIterationNext(frame, elementHash, containerHash, iteratorHash, label);
+		}
+
+		void VirtualMachine::PerformIterationNext(Frame* frame, size_t elementHash, size_t containerHash, size_t iteratorHash, uint16_t label)
+		{
+			auto elementIt = frame->locals.find(frame->_method->dependencies[elementHash]);
+			auto containerIt = frame->locals.find(frame->_method->dependencies[containerHash]);
+			auto iteratorIt = frame->locals.find(frame->_method->dependencies[iteratorHash]);
+			if (elementIt == frame->locals.end() || containerIt == frame->locals.end() || iteratorIt == frame->locals.end())
+			{
+				InvokeError(ERROR::INVALID_BYTECODE | ERROR::FATAL_ERROR, "foreach iteration was not initialized before iter_next instruction", "iter_next");
+				return;
+			}
+			Local& element = elementIt->second;
+			Local& iterator = iteratorIt->second;
+			BaseObject* container = containerIt->second.object;
+
+			if (AssertType(container, Type::STRING))
+			{
+				const StringObject::InnerType& str = static_cast<StringObject*>(container)->value;
+				IntegerObject::InnerType& index = static_cast<IntegerObject*>(iterator.object)->value;
+				if (index >= (unsigned long long)str.size())
+				{
+					frame->offset = frame->_method->labels[label];
+					return;
 				}
-				case (OPCODE::PUSH_INTEGER):
+				char c = str[(size_t)index.to_int64()];
+				if (ReuseIterationElement(element, Type::STRING))
+					static_cast<StringObject*>(element.object)->value.assign(1, c);
+				else
+					element.object = AllocString(StringObject::InnerType(1, c));
+				element.object->unique = true;
+				index += 1;
+				return;
+			}
+			ArrayObject* array = GetNativeArrayOrNull(container);
+			if (array != nullptr)
+			{
+				IntegerObject::InnerType& index = static_cast<IntegerObject*>(iterator.object)->value;
+				if (index >= (unsigned long long)array->array.size())
 				{
-					size_t hash = ReadHash(frame->_method->body, frame->offset);
-					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
-					{
-						if (!frame->integerCache.Has(hash))
-							frame->integerCache.Add(hash, 
-								IntegerObject::InnerType(frame->_method->dependencies[hash])
-							);
-						objectStack.push_back(AllocInteger(frame->integerCache[hash]));
-					}
-					break;
+					frame->offset = frame->_method->labels[label];
+					return;
 				}
-				case (OPCODE::PUSH_FLOAT):
+				element.object = array->array[(size_t)index.to_int64()].object;
+				index += 1;
+				return;
+			}
+			if (IsNativeRange(container) && AssertType(iterator.object, Type::INTEGER))
+			{
+				auto& attributes = static_cast<ClassObject*>(container)->attributes;
+				const IntegerObject::InnerType& last = static_cast<IntegerObject*>(attributes["last"]->object)->value;
+				const IntegerObject::InnerType& step = static_cast<IntegerObject*>(attributes["step"]->object)->value;
+				IntegerObject::InnerType& index = static_cast<IntegerObject*>(iterator.object)->value;
+				if (step > 0 ? index >= last : index <= last)
 				{
-					size_t hash = ReadHash(frame->_method->body, frame->offset);
-					if (ValidateHashValue(hash, frame->_method->dependencies.size()))
-					{
-						if (!frame->floatCache.Has(hash))
-							frame->floatCache.Add(hash,
-								FloatObject::InnerType(std::stod(frame->_method->dependencies[hash]))
-							);
-						objectStack.push_back(AllocFloat(frame->floatCache[hash]));
-					}
-					break;
-				}
-				case (OPCODE::PUSH_THIS):
-					objectStack.push_back(frame->classObject);
-					break;
-				case (OPCODE::PUSH_NULL):
-					objectStack.push_back(AllocNull());
-					break;
-				case (OPCODE::SET_ALU_INCR):
-					AluIncrMode = true;
-					break;
-				case (OPCODE::RETURN):
-					if (frame->_method->isConstructor())
-					{
-						objectStack.push_back(frame->locals["this"].object);
-					}
-					else
-					{
-						objectStack.push_back(AllocNull());
-					}
-					callStack.pop_back();
+					frame->offset = frame->_method->labels[label];
 					return;
-					break;
-				case (OPCODE::JUMP):
-					frame->offset = frame->_method->labels[ReadLabel(frame->_method->body, frame->offset)];
-					break;
-				case (OPCODE::POP_STACK_TOP):
-					if (objectStack.empty())
-					{
-						InvokeError(ERROR::OBJECTSTACK_EMPTY | ERROR::FATAL_ERROR, "pop_stack_top instruction called, but object stack was empty", "pop_stack_top");
- 						return;
-					}
-					objectStack.pop_back();
-					break;
-				default:
-					InvokeError(ERROR::INVALID_BYTECODE | ERROR::FATAL_ERROR, "opcode " + OpcodeToMethod(op) + " was found, but not expected", OpcodeToMethod(op));
-					break;
 				}
+				if (ReuseIterationElement(element, Type::INTEGER))
+					static_cast<IntegerObject*>(element.object)->value = index;
+				else
+					element.object = AllocInteger(index);
+				element.object->unique = true;
+				index += step;
+				return;
 			}
-			InvokeError(ERROR::INVALID_BYTECODE | ERROR::FATAL_ERROR, "execution of method went out of frame", std::to_string(frame->offset));
+
+			// generic iteration protocol: Begin(), End(), GetByIter(iter), Next(iter)
+			if (!AssertType(container, Type::CLASS_OBJECT, "object passed to foreach statement cannot be iterated", frame)) return;
+			ClassObject* object = static_cast<ClassObject*>(container);
+			objectStack.push_back(iterator.object);
+			objectStack.push_back(object);
+			InvokeObjectMethod("End_1", object);
+			if (errors != 0) return;
+			PerformALUCall(OPCODE::CMP_EQ, 2, frame);
+			if (errors != 0) return;
+			BaseObject* isEnd = GetUnderlyingObject(objectStack.back());
+			objectStack.pop_back();
+			if (AssertType(isEnd, Type::TRUE))
+			{
+				frame->offset = frame->_method->labels[label];
+				return;
+			}
+
+			objectStack.push_back(object);
+			objectStack.push_back(iterator.object);
+			InvokeObjectMethod("GetByIter_2", object);
+			if (errors != 0) return;
+			element.object = GetUnderlyingObject(objectStack.back());
+			objectStack.pop_back();
+
+			objectStack.push_back(object);
+			objectStack.push_back(iterator.object);
+			InvokeObjectMethod("Next_2", object);
+			if (errors != 0) return;
+			iterator.object = GetUnderlyingObject(objectStack.back());
+			objectStack.pop_back();
+		}
+
+		bool VirtualMachine::ReuseIterationElement(const Local& element, Type type)
+		{
+			// element which was not shared by loop body is owned only by foreach variable, so next element is written to it
+			if (element.object->type != type || !element.object->unique) return false;
+			// message of caught error, which is not built yet, may describe the element
+			exception.Format();
+			return true;
+		}
+
+		ArrayObject* VirtualMachine::GetNativeArrayOrNull(BaseObject* object) const
+		{
+			if (object->type != Type::CLASS_OBJECT) return nullptr;
+			ClassObject* classObject = static_cast<ClassObject*>(object);
+			if (classObject->typeInstance->name != "Array" || classObject->typeInstance->namespaceName != "System") return nullptr;
+
+			auto array = classObject->attributes.find("array");
+			if (array == classObject->attributes.end() || array->second->object->type != Type::BASE) return nullptr;
+			return static_cast<ArrayObject*>(array->second->object);
+		}
+
+		bool VirtualMachine::IsNativeRange(BaseObject* object) const
+		{
+			if (object->type != Type::CLASS_OBJECT) return false;
+			ClassObject* classObject = static_cast<ClassObject*>(object);
+			if (classObject->typeInstance->name != "Range" || classObject->typeInstance->namespaceName != "System") return false;
+
+			// range with non-integer bounds is iterated by its Begin() / End() / Next() methods
+			for (const char* member : { "first", "last", "step" })
+			{
+				auto attribute = classObject->attributes.find(member);
+				if (attribute == classObject->attributes.end() || attribute->second->object->type != Type::INTEGER) return false;
+			}
+			return !static_cast<IntegerObject*>(classObject->attributes["step"]->object)->value.is_zero();
 		}
 
 		void VirtualMachine::PerformSystemCall(const ClassType* _class, const MethodType* _method, Frame* frame)
@@ -951,12 +1813,20 @@ namespace MSL
 					
 					if (!dllLoader.HasLibrary(moduleName))
 					{
-						InvokeError(ERROR::DLL_NOT_FOUND, "module was not loaded before method call", moduleName);
+						InvokeError(ERROR::DLL_NOT_FOUND, [module](std::string& message, std::string& argument)
+						{
+							message = "module was not loaded before method call";
+							argument = static_cast<StringObject*>(module)->value;
+						});
 						return;
 					}
 					if (DllFunction == NULL) 
 					{
-						InvokeError(ERROR::METHOD_NOT_FOUND, "method " + functionName + " was not found in module: " + moduleName, functionName); 
+						InvokeError(ERROR::METHOD_NOT_FOUND, [module, function](std::string& message, std::string& argument)
+						{
+							argument = static_cast<StringObject*>(function)->value;
+							message = "method " + argument + " was not found in module: " + static_cast<StringObject*>(module)->value;
+						});
 						return; 
 					}
 					// DLL call
@@ -1044,7 +1914,10 @@ namespace MSL
 					BaseObject* object = objectStack.back();
 					objectStack.pop_back();
 					FloatObject::InnerType value = static_cast<FloatObject*>(object)->value;
-					objectStack.push_back(AllocInteger(std::to_string(value)));
+					if (std::abs(value) < 9.2e18)
+						objectStack.push_back(AllocInteger((int64_t)value));
+					else
+						objectStack.push_back(AllocInteger(std::to_string(value)));
 				}
 			}
 			else if (_class->name == "String")
@@ -1158,7 +2031,11 @@ namespace MSL
 					}
 					else
 					{
-						InvokeError(ERROR::INVALID_ARGUMENT, "cannot access String element with index = " + indexValue.to_string(), indexValue.to_string());
+						InvokeError(ERROR::INVALID_ARGUMENT, [idx](std::string& message, std::string& argument)
+						{
+							argument = static_cast<IntegerObject*>(idx)->value.to_string();
+							message = "cannot access String element with index = " + argument;
+						});
 						return;
 					}
 				}
@@ -1239,7 +2116,7 @@ namespace MSL
 			{
 				if (_method->name == "Instance_0")
 				{
-					objectStack.push_back(AllocString(exception.GetErrorType()));
+					objectStack.push_back(AllocString(ErrorToString(exception.GetError())));
 					objectStack.push_back(AllocString(exception.GetMessage()));
 					objectStack.push_back(AllocString(exception.GetArgument()));
 					PerformSystemCall(_class, &_class->methods.at("Exception_3"), frame);
@@ -1291,7 +2168,7 @@ namespace MSL
 					ArrayObject* gcArray = static_cast<ArrayObject*>(arrayInstance->attributes.at("array")->object);
 
 					for (size_t i = 0; i < gcArray->array.size(); i++)
-						gcArray->array[i] = { AllocString(exception.GetTraceEntry(i)), true };
+						gcArray->array[i] = { AllocString(GetTraceString(exception.GetTraceEntry(i))), true };
 					InitializeAttribute(ExceptionObject, "stackTrace", arrayInstance);
 
 					objectStack.push_back(ExceptionObject);
@@ -1315,6 +2192,10 @@ namespace MSL
  				return;
 			}	
 
+			// flag is reset before any nested method call can be made
+			const bool incrMode = AluIncrMode;
+			AluIncrMode = false;
+
 			BaseObject* object = nullptr;
 			BaseObject* value = nullptr;
 			BaseObject* originalValue = nullptr;
@@ -1325,18 +2206,30 @@ namespace MSL
 				originalValue = value;
 				if (AssertType(value, Type::UNKNOWN))
 				{
-					value = ResolveReference(value, frame->locals, frame->_method, frame->classObject, frame->_namespace);
+					// operand is only read by ALU, so the local keeps ownership of its value
+					auto localIt = frame->locals.find(*static_cast<UnknownObject*>(value)->ref);
+					if (localIt != frame->locals.end())
+						value = localIt->second.object;
+					else
+						value = ResolveReference(value, frame->locals, frame->_method, frame->classObject, frame->_namespace);
 					if (value == nullptr) return;
 				}
 				value = GetUnderlyingObject(value);
 			}
 			object = objectStack.back();
 			objectStack.pop_back();
+			bool ownedByLocal = false;
 			if (AssertType(object, Type::UNKNOWN))
 			{
 				auto localIt = frame->locals.find(*static_cast<UnknownObject*>(object)->ref);
 				if (localIt != frame->locals.end())
 				{
+					if (incrMode && !localIt->second.isConst && PerformInplaceALUCall(localIt->second.object, value, op))
+					{
+						objectStack.push_back(object); // reference to modified local, same as result of assignment
+						return;
+					}
+					ownedByLocal = true;
 					object = AllocLocal(localIt->first, localIt->second);
 				}
 				else
@@ -1352,9 +2245,13 @@ namespace MSL
 			{
 				LocalObject* local = static_cast<LocalObject*>(object);
 				if (local->ref.isConst && local->ref.object->type != Type::NULLPTR && 
-					(op == OPCODE::ASSIGN_OP || AluIncrMode))
+					(op == OPCODE::ASSIGN_OP || incrMode))
 				{
-					InvokeError(ERROR::CONST_MEMBER_MODIFICATION, "trying to modify const local variable: " + local->ToString() + " = " + (value ? value->ToString() : "null"), local->ToString());
+					InvokeError(ERROR::CONST_MEMBER_MODIFICATION, [local, value](std::string& message, std::string& argument)
+					{
+						argument = local->ToString();
+						message = "trying to modify const local variable: " + argument + " = " + (value ? value->ToString() : "null");
+					});
  					return;
 				}
 				objectReference = &local->ref.object;
@@ -1364,9 +2261,13 @@ namespace MSL
 			{
 				AttributeObject* attr = static_cast<AttributeObject*>(object);
 				if (attr->type->isConst() && attr->object->type != Type::NULLPTR && 
-					(op == OPCODE::ASSIGN_OP || AluIncrMode))
+					(op == OPCODE::ASSIGN_OP || incrMode))
 				{
-					InvokeError(ERROR::CONST_MEMBER_MODIFICATION, "trying to modify const class attribute: " + attr->type->name, attr->type->name);
+					InvokeError(ERROR::CONST_MEMBER_MODIFICATION, [attr](std::string& message, std::string& argument)
+					{
+						message = "trying to modify const class attribute: " + attr->type->name;
+						argument = attr->type->name;
+					});
  					return;
 				}
 				objectReference = &attr->object;
@@ -1381,34 +2282,50 @@ namespace MSL
 				objectReference = &object;
 				if (op == OPCODE::ASSIGN_OP)
 				{
-					InvokeError(ERROR::INVALID_TYPE, "primitive types are not assignable: " + object->ToString(), object->ToString());					
+					InvokeError(ERROR::INVALID_TYPE, [object](std::string& message, std::string& argument)
+					{
+						argument = object->ToString();
+						message = "primitive types are not assignable: " + argument;
+					});
 					return;
 				}
 				break;
 			default:
-				InvokeError(ERROR::INVALID_TYPE, "trying to perform operation with invalid object: " + object->ToString(), object->ToString());
+				InvokeError(ERROR::INVALID_TYPE, [object](std::string& message, std::string& argument)
+				{
+					argument = object->ToString();
+					message = "trying to perform operation with invalid object: " + argument;
+				});
  				return;
 			}
 
 			if (op == OPCODE::ASSIGN_OP)
 			{
 				*objectReference = value;
+				if (value != nullptr) value->unique = false;
 				objectStack.push_back(object);
 				return;
 			}
 
 			// call assign after operations in this method
-			if (AluIncrMode)
+			if (incrMode)
 			{
 				objectStack.push_back(object);
 			}
+			// results of ALU calls with primitives are always new objects
+			const bool primitiveTarget = AssertType(*objectReference, Type::INTEGER) ||
+				AssertType(*objectReference, Type::FLOAT) || AssertType(*objectReference, Type::STRING);
 
 			switch ((*objectReference)->type)
 			{
 			case Type::CLASS_OBJECT:
 			{
 				objectStack.push_back(*objectReference);
-				if (parameters == 2) objectStack.push_back(value);
+				if (parameters == 2)
+				{
+					value->unique = false;
+					objectStack.push_back(value);
+				}
 				ClassObject* classObject = static_cast<ClassObject*>(*objectReference);
 				PerformALUCallClassObject(classObject, op, frame);
 			}
@@ -1436,8 +2353,13 @@ namespace MSL
 					{
 						integerValue = &static_cast<IntegerObject*>(value)->value;
 					}
-					else if (!AssertType(value, Type::FLOAT, "cannot convert object to Integer: " + value->ToString(), frame))
+					else if (!AssertType(value, Type::FLOAT))
 					{
+						InvokeError(ERROR::INVALID_TYPE, [value](std::string& message, std::string& argument)
+						{
+							argument = value->ToString();
+							message = "cannot convert object to Integer: " + argument;
+						});
 						return;
 					}
 					else
@@ -1509,7 +2431,11 @@ namespace MSL
 					}
 					else
 					{
-						InvokeError(ERROR::METHOD_NOT_FOUND, "cannot convert object to String: " + value->ToString(), value->ToString());
+						InvokeError(ERROR::METHOD_NOT_FOUND, [value](std::string& message, std::string& argument)
+						{
+							argument = value->ToString();
+							message = "cannot convert object to String: " + argument;
+						});
  						return;
 					}
 				}
@@ -1536,7 +2462,11 @@ namespace MSL
 						}
 						else
 						{
-							InvokeError(ERROR::INVALID_METHOD_CALL, "cannot convert class object to Float: " + GetFullClassType(valueClassObject->typeInstance) + ".ToFloat() method not found", valueClassObject->ToString());
+							InvokeError(ERROR::INVALID_METHOD_CALL, [this, valueClassObject](std::string& message, std::string& argument)
+							{
+								message = "cannot convert class object to Float: " + GetFullClassType(valueClassObject->typeInstance) + ".ToFloat() method not found";
+								argument = valueClassObject->ToString();
+							});
  							return;
 						}
 					}
@@ -1552,7 +2482,11 @@ namespace MSL
 					}
 					else
 					{
-						InvokeError(ERROR::METHOD_NOT_FOUND, "cannot convert object to String: " + value->ToString(), value->ToString());
+						InvokeError(ERROR::METHOD_NOT_FOUND, [value](std::string& message, std::string& argument)
+						{
+							argument = value->ToString();
+							message = "cannot convert object to String: " + argument;
+						});
  						return;
 					}
 				}
@@ -1575,7 +2509,11 @@ namespace MSL
 					}
 					else
 					{
-						InvokeError(ERROR::METHOD_NOT_FOUND, "cannot convert object to String: " + value->ToString(), value->ToString());
+						InvokeError(ERROR::METHOD_NOT_FOUND, [value](std::string& message, std::string& argument)
+						{
+							argument = value->ToString();
+							message = "cannot convert object to String: " + argument;
+						});
  						return;
 					}
 				}
@@ -1585,9 +2523,13 @@ namespace MSL
 			case Type::FALSE:
 			case Type::TRUE:
 			{
-				if (AluIncrMode)
+				if (incrMode)
 				{
-					InvokeError(ERROR::INVALID_BYTECODE, "Boolean value cannot be incremented: " + (*objectReference)->ToString(), (*objectReference)->ToString());
+					InvokeError(ERROR::INVALID_BYTECODE, [object = *objectReference](std::string& message, std::string& argument)
+					{
+						argument = object->ToString();
+						message = "Boolean value cannot be incremented: " + argument;
+					});
  					return;
 				}
 				bool b1 = (*objectReference)->type == Type::TRUE ? true : false;
@@ -1596,14 +2538,109 @@ namespace MSL
 			}
 			break;
 			default:
-				InvokeError(ERROR::INVALID_TYPE, "unexpected object type found in ALU call: " + (*objectReference)->ToString(), (*objectReference)->ToString());
+				InvokeError(ERROR::INVALID_TYPE, [object = *objectReference](std::string& message, std::string& argument)
+				{
+					argument = object->ToString();
+					message = "unexpected object type found in ALU call: " + argument;
+				});
  				return;
 			}
 
-			if (AluIncrMode)
+			if (incrMode)
 			{
+				BaseObject* result = objectStack.back();
 				PerformALUCall(OPCODE::ASSIGN_OP, 2, frame);
-				AluIncrMode = false; // resets after call
+				// next compound assignment to this local can modify the result in place
+				if (errors == 0 && ownedByLocal && primitiveTarget && result != value)
+				{
+					result->unique = true;
+				}
+			}
+		}
+
+		bool VirtualMachine::PerformInplaceALUCall(BaseObject* object, const BaseObject* value, OPCODE op)
+		{
+			// compound assignment without allocation of the result, returns false if it cannot be done
+			if (!object->unique || object == value) return false;
+			// message of caught error, which is not built yet, may describe the object
+			exception.Format();
+			switch (object->type)
+			{
+			case Type::INTEGER:
+			{
+				if (!AssertType(value, Type::INTEGER)) return false;
+				IntegerObject::InnerType& int1 = static_cast<IntegerObject*>(object)->value;
+				const IntegerObject::InnerType& int2 = static_cast<const IntegerObject*>(value)->value;
+				switch (op)
+				{
+				case OPCODE::SUM_OP:
+					int1 += int2;
+					return true;
+				case OPCODE::SUB_OP:
+					int1 -= int2;
+					return true;
+				case OPCODE::MULT_OP:
+					int1 *= int2;
+					return true;
+				case OPCODE::DIV_OP:
+					int1 /= int2;
+					return true;
+				case OPCODE::MOD_OP:
+					int1 %= int2;
+					return true;
+				case OPCODE::POWER_OP:
+					int1 = momo::pow(int1, int2);
+					return true;
+				default:
+					return false;
+				}
+			}
+			case Type::FLOAT:
+			{
+				FloatObject::InnerType f2 = 0.0;
+				if (AssertType(value, Type::FLOAT))
+					f2 = static_cast<const FloatObject*>(value)->value;
+				else if (AssertType(value, Type::INTEGER))
+					f2 = static_cast<const IntegerObject*>(value)->value.to_double();
+				else
+					return false;
+
+				FloatObject::InnerType& f1 = static_cast<FloatObject*>(object)->value;
+				switch (op)
+				{
+				case OPCODE::SUM_OP:
+					f1 += f2;
+					return true;
+				case OPCODE::SUB_OP:
+					f1 -= f2;
+					return true;
+				case OPCODE::MULT_OP:
+					f1 *= f2;
+					return true;
+				case OPCODE::DIV_OP:
+					f1 /= f2;
+					return true;
+				case OPCODE::POWER_OP:
+					f1 = std::pow(f1, f2);
+					return true;
+				default:
+					return false;
+				}
+			}
+			case Type::STRING:
+			{
+				if (op != OPCODE::SUM_OP) return false;
+				StringObject::InnerType& str = static_cast<StringObject*>(object)->value;
+				if (AssertType(value, Type::STRING))
+					str += static_cast<const StringObject*>(value)->value;
+				else if (AssertType(value, Type::INTEGER))
+					static_cast<const IntegerObject*>(value)->value.append_to(str);
+				else
+					return false;
+				return true;
+			}
+			default:
+				return false;
 			}
 		}
 
@@ -1617,18 +2654,27 @@ namespace MSL
 				{
 					ClassType& c = namespaceIt->second;
 					c.wrapper = GC.classWrapAlloc.Alloc(&c);
-					c.staticInstance = GC.classObjAlloc.Alloc(&c);
-					c.staticInstance->attributes.reserve(c.staticAttributes.size());
-					for (const auto& attr : c.staticAttributes)
-					{
-						AttributeObject* staticAttr = GC.attributeAlloc.Alloc(&attr.second);
-						staticAttr->object = AllocNull();
-						c.staticInstance->attributes[attr.first] = staticAttr;
-					}
 				}
 			}
 		}
 
+		ClassObject* VirtualMachine::GetStaticInstance(const ClassType* _class)
+		{
+			if (_class->staticInstance != nullptr) return _class->staticInstance;
+
+			// static attributes are allocated when class is first referenced, class wrapper keeps them alive
+			ClassObject* staticInstance = GC.classObjAlloc.Alloc(_class);
+			staticInstance->attributes.reserve(_class->staticAttributes.size());
+			for (const auto& attr : _class->staticAttributes)
+			{
+				AttributeObject* staticAttr = GC.attributeAlloc.Alloc(&attr.second);
+				staticAttr->object = AllocNull();
+				staticInstance->attributes[attr.first] = staticAttr;
+			}
+			_class->staticInstance = staticInstance;
+			return staticInstance;
+		}
+
 		void VirtualMachine::AddSystemNamespace()
 		{
 			/////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1868,6 +2914,8 @@ namespace MSL
 			   iterAlloc > config.GC.minMemory && 
 			   iterAlloc > GC.GetClearedMemorySinceIter())
 			{
+				// message of caught error may refer to objects which are not reachable any more
+				exception.Format();
 				GC.Collect(this->assembly, this->callStack, this->objectStack);
 			}
 		}
@@ -1885,10 +2933,10 @@ namespace MSL
 			}
 		}
 
-		bool VirtualMachine::AssertType(const BaseObject* object, Type type, const std::string& message, const Frame* frame)
+		bool VirtualMachine::AssertType(const BaseObject* object, Type type, const char* message, const Frame* frame)
 		{
 			if (AssertType(object, type)) return true;
-			InvokeError(ERROR::INVALID_TYPE, message, object->ToString());
+			InvokeError(ERROR::INVALID_TYPE, [message, object](std::string& msg, std::string& arg) { msg = message; arg = object->ToString(); });
 			return false;
 		}
 
@@ -1960,7 +3008,13 @@ namespace MSL
 		void VirtualMachine::InvokeError(size_t error, const std::string& message, const std::string& arg)
 		{
 			errors |= error;
-			exception.Init(message, arg, ErrorToString(error));
+			exception.Init(message, arg, error);
+		}
+
+		void VirtualMachine::InvokeError(size_t error, ExceptionTrace::Formatter formatter)
+		{
+			errors |= error;
+			exception.Init(std::move(formatter), error);
 		}
 
 		std::string VirtualMachine::OpcodeToMethod(OPCODE op) const
@@ -2115,6 +3169,7 @@ namespace MSL
 				break;
 			case OPCODE::POSITIVE_OP:
 				// optimize +int1 == int1
+				int1->unique = false;
 				objectStack.push_back(int1);
 				break;
 			case OPCODE::SUM_OP:
@@ -2202,7 +3257,11 @@ namespace MSL
 				}
 				break;
 			default:
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with two integers: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with two integers: " + argument;
+				});
 				break;
 			}
 		}
@@ -2279,7 +3338,11 @@ namespace MSL
 				}
 				break;
 			default:
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with two strings: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with two strings: " + argument;
+				});
 				break;
 			}
 		}
@@ -2297,11 +3360,17 @@ namespace MSL
 				objectStack.push_back(result);
 				break;
 			case OPCODE::SUM_OP:
-				result->value = str->value + integer->to_string();
+				result->value.reserve(str->value.size() + integer->chars_size());
+				result->value = str->value;
+				integer->append_to(result->value);
 				objectStack.push_back(result);
 				break;
 			default:
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with String and Integer: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with String and Integer: " + argument;
+				});
 				break;
 			}
 		}
@@ -2311,7 +3380,11 @@ namespace MSL
 			std::string methodName = OpcodeToMethod(op);
 			if(methodName.empty())
 			{
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with two class objects: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with two class objects: " + argument;
+				});
 				
 			}
 			switch (op)
@@ -2361,7 +3434,11 @@ namespace MSL
 					objectStack.push_back(AllocFalse());
 				break;
 			default:
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with two Booleans: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with two Booleans: " + argument;
+				});
 				
 				break;
 			}
@@ -2461,7 +3538,11 @@ namespace MSL
 				}
 				break;
 			default:
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with two Floats: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with two Floats: " + argument;
+				});
  				break;
 			}
 		}
@@ -2492,7 +3573,11 @@ namespace MSL
 				break;
 			default:
 				objectStack.push_back(class1);
-				InvokeError(ERROR::INVALID_OPERATION, "invalid operation with two class types: " + OpcodeToMethod(op), OpcodeToMethod(op));
+				InvokeError(ERROR::INVALID_OPERATION, [this, op](std::string& message, std::string& argument)
+				{
+					argument = OpcodeToMethod(op);
+					message = "invalid operation with two class types: " + argument;
+				});
  				break;
 			}
 		}
@@ -2567,11 +3652,11 @@ namespace MSL
 		{
 			if ((uint64_t)size * sizeof(NullObject) > config.GC.maxMemory)
 			{
-				InvokeError(
-					ERROR::INVALID_ARGUMENT, 
-					"cannot allocate array with too big size = " + std::to_string(size) + " (" + MSL::utils::formatBytes((uint64_t)size * sizeof(NullObject)) + ')',
-					std::to_string(size)
-				);
+				InvokeError(ERROR::INVALID_ARGUMENT, [size](std::string& message, std::string& argument)
+				{
+					argument = std::to_string(size);
+					message = "cannot allocate array with too big size = " + argument + " (" + MSL::utils::formatBytes((uint64_t)size * sizeof(NullObject)) + ')';
+				});
 				return GC.arrayAlloc.Alloc(0);
 			}
 
@@ -2622,6 +3707,29 @@ namespace MSL
 			if (!assembly.namespaces.empty() && !config.compilation.allowAssemblyMerge) return false;
 
 			AssemblyEditor editor(binaryFile, config.streams.error);
+			editor.SetLazyDecoding(config.compilation.lazyDecoding);
+			return MergeAssembly(editor);
+		}
+
+		bool VirtualMachine::AddBytecodeFile(const std::string& fileName)
+		{
+			if (!assembly.namespaces.empty() && !config.compilation.allowAssemblyMerge) return false;
+
+			auto file = std::make_shared<MappedFile>();
+			if (!file->Open(fileName))
+			{
+				if (config.streams.error != nullptr)
+					*config.streams.error << "[assembly editor]: cannot map assembly file: " << fileName << '\n';
+				return false;
+			}
+			// mapping is kept by assembly while it has methods which are not decoded yet
+			AssemblyEditor editor(file->GetData(), file->GetSize(), config.streams.error, file);
+			editor.SetLazyDecoding(config.compilation.lazyDecoding);
+			return MergeAssembly(editor);
+		}
+
+		bool VirtualMachine::MergeAssembly(AssemblyEditor& editor)
+		{
 			CallPath* callPath = nullptr;
 			if (callStack.empty())
 			{
@@ -2631,17 +3739,98 @@ namespace MSL
 			bool result = editor.MergeAssemblies(assembly, config.compilation.varifyBytecode, callPath);
 			if(callPath != nullptr && callPath->GetMethod() == nullptr)
 				callStack.pop_back();
+
+			size_t heapSize = 0;
+			const uint8_t* heap = editor.GetSnapshotHeap(heapSize);
+			if (result && heap != nullptr)
+			{
+				if (!snapshotHeap.empty() || initialized)
+				{
+					if (config.streams.error != nullptr)
+						*config.streams.error << "[VM]: static state of only one snapshot can be restored, before VM is launched" << std::endl;
+					return false;
+				}
+				snapshotHeap.assign(heap, heap + heapSize);
+			}
 			return result;
 		}
 
-		void VirtualMachine::Run()
+		bool VirtualMachine::Initialize()
 		{
+			if (initialized) return errors == 0;
+			initialized = true;
 			#ifdef MSL_DLL_API
 			dllLoader.UseFunctionCache(config.execution.cacheDll);
 			#endif
 			GC.SetLogStream(config.GC.log);
 			AddSystemNamespace();
 			InitializeStaticMembers();
+			if (config.execution.inlineMethods) FindInlineMethods();
+
+			if (!snapshotHeap.empty())
+			{
+				// static constructors which were called before snapshot was written are not called again
+				HeapSnapshot heap(*this, config.streams.error);
+				if (!heap.Restore(snapshotHeap.data(), snapshotHeap.size()))
+					InvokeError(ERROR::INVALID_BYTECODE | ERROR::TERMINATE_ON_LAUNCH, "static state of snapshot cannot be restored", "");
+				snapshotHeap.clear();
+				snapshotHeap.shrink_to_fit();
+			}
+			return errors == 0;
+		}
+
+		bool VirtualMachine::Warmup(const std::string& _namespace, const std::string& _class, const std::string& _method)
+		{
+			config.quickening.enabled = false;
+			if (!Initialize()) return false;
+
+			const ClassType* type = GetClassOrNull(_namespace, _class);
+			std::string methodName = _method + "_0";
+			if (type == nullptr || GetMethodOrNull(type, methodName) == nullptr)
+			{
+				if (config.streams.error != nullptr)
+					*config.streams.error << "[VM]: warm-up method " << _namespace << '.' << _class << '.' << _method << " was not found" << std::endl;
+				return false;
+			}
+			size_t stackSize = objectStack.size();
+			objectStack.push_back(type->wrapper);
+			try
+			{
+				InvokeStaticMethod(methodName, type);
+			}
+			catch (std::exception& e)
+			{
+				InvokeError(ERROR::FATAL_ERROR, "an exception occured during VM execution: ", e.what());
+			}
+			objectStack.resize(stackSize);
+			if (errors != 0 && config.streams.error != nullptr)
+			{
+				*config.streams.error << "[VM]: warm-up method failed with error '" << ErrorToString(exception.GetError()) << "': " << exception.GetMessage() << std::endl;
+			}
+			return errors == 0;
+		}
+
+		bool VirtualMachine::WriteSnapshot(std::ostream& out)
+		{
+			if (!Initialize()) return false;
+			for (const auto& ns : assembly.namespaces)
+			{
+				for (const auto& c : ns.second.classes)
+				{
+					for (const auto& m : c.second.methods)
+					{
+						if (!DecodeMethod(&c.second, &m.second)) return false;
+					}
+				}
+			}
+			AssemblyEditor::WriteSnapshot(assembly, out);
+			HeapSnapshot heap(*this, config.streams.error);
+			return heap.Write(out);
+		}
+
+		void VirtualMachine::Run()
+		{
+			Initialize();
 
 			if (config.execution.useUnicode)
 			{
@@ -2701,6 +3890,14 @@ namespace MSL
 
 			auto endTimePoint = std::chrono::system_clock::now();
 			auto elapsedTime = endTimePoint - startTimePoint;
+
+			if (config.quickening.log != nullptr)
+			{
+				*config.quickening.log << "[VM]: quickening stats: " <<
+					quickeningStats.aluSpecialized << " ALU instructions specialized, " <<
+					quickeningStats.callsSpecialized << " method calls cached, " <<
+					quickeningStats.despecialized << " instructions despecialized" << std::endl;
+			}
 			
 			if (errors != 0)
 			{
@@ -2711,13 +3908,13 @@ namespace MSL
 						err << "[VM]: fatal error during VM execution:";
 					else
 						err << "[VM]: unhandled exception during VM execution:";
-					err << "\n    type: '" << exception.GetErrorType() + "'";
+					err << "\n    type: '" << ErrorToString(exception.GetError()) + "'";
 					err << "\n    message: '" << exception.GetMessage() << "'";
 					err << "\n    argument: '" << exception.GetArgument() << "'";
 					err << "\n    exception stack trace:";
 					for (size_t i = 0; i < exception.GetTraceSize(); i++)
 					{
-						err << "\n        " << exception.GetTraceEntry(i);
+						err << "\n        " << GetTraceString(exception.GetTraceEntry(i));
 					}
 					err << std::endl;
 				}
@@ -2785,6 +3982,16 @@ namespace MSL
 			return exception;
 		}
 
+		const VirtualMachine::QuickeningStats& VirtualMachine::GetQuickeningStats() const
+		{
+			return quickeningStats;
+		}
+
+		bool& VirtualMachine::GetAluIncrMode()
+		{
+			return AluIncrMode;
+		}
+
 		std::vector<std::string> VirtualMachine::GetErrorStrings(uint32_t errors) const
 		{
 			std::vector<std::string> errorList;
@@ -2841,6 +4048,39 @@ namespace MSL
 			dllLoader.AddDllFunction(module, function, (DllLoader::DllFunction)pointer);
 		}
 
+		bool VirtualMachine::AddAotMethod(const std::string& _namespace, const std::string& _class, const std::string& _method, uint64_t bodyHash, MethodType::NativeMethod function)
+		{
+			const MethodType* method = GetMethodOrNull(_namespace, _class, _method);
+			if (method != nullptr && !DecodeMethod(GetClassOrNull(_namespace, _class), method)) return false;
+			if (method == nullptr || method->GetBodyHash() != bodyHash)
+			{
+				// native code is generated from another version of assembly and cannot be used
+				if (config.streams.error != nullptr)
+					*config.streams.error << "[VM WARNING]: AOT-compiled method " << _namespace << '.' << _class << '.' << _method << " does not match loaded assembly" << std::endl;
+				return false;
+			}
+			method->aotMethod = function;
+			return true;
+		}
+
+		bool VirtualMachine::LoadAotModule(const std::string& libName)
+		{
+			#ifdef MSL_DLL_API
+			using RegisterFunction = bool(*)(VirtualMachine*);
+			dllLoader.AddLibrary(libName);
+			auto registerModule = (RegisterFunction)dllLoader.GetFunctionPointer(libName, "MSL_RegisterAotModule");
+			if (registerModule == nullptr)
+			{
+				if (config.streams.error != nullptr)
+					*config.streams.error << "[VM WARNING]: AOT module " << libName << " was not loaded or has no registration function" << std::endl;
+				return false;
+			}
+			return registerModule(this);
+			#else
+			return false;
+			#endif
+		}
+
 		AssemblyType& VirtualMachine::GetAssembly()
 		{
 			return assembly;
@@ -2862,6 +4102,7 @@ namespace MSL
 		}
 	}
 }
+#undef FRAME_ACTION
 #undef RET_CS_POP
 #undef PRINTPREVFRAME
 #undef PRINTFRAME_2
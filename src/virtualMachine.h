@@ -4,9 +4,12 @@
 #include "configuration.h"
 #include "callPath.h"
 #include "assemblyEditor.h"
+#include "mappedFile.h"
 #include "assemblyType.h"
 #include "garbageCollector.h"
 #include "ExceptionTrace.h"
+#include "jitCompiler.h"
+#include "heapSnapshot.h"
 
 #define MSL_DLL_API
 //#undef MSL_DLL_API
@@ -22,6 +25,9 @@ namespace MSL
 	{
 		class VirtualMachine
 		{
+			friend class JitCompiler;
+			friend class HeapSnapshot;
+
 			using CallStack = std::vector<CallPath>;
 			using ObjectStack = std::vector<BaseObject*>;
 			CallStack callStack;
@@ -37,6 +43,30 @@ namespace MSL
 			Configuration config;
 			uint32_t errors;
 			bool AluIncrMode;
+			bool initialized = false;
+			std::vector<uint8_t> snapshotHeap; // static state of loaded snapshot, it is restored when VM is initialized
+		public:
+			/*
+			counters of instructions rewritten in place by VM quickening
+			*/
+			struct QuickeningStats
+			{
+				size_t aluSpecialized = 0;
+				size_t callsSpecialized = 0;
+				size_t despecialized = 0;
+			};
+		private:
+			/*
+			how interpreter leaves instruction which calls or returns from method: it continues the frame, returns from it or starts method called by TAIL_CALL in it
+			*/
+			enum class FrameAction
+			{
+				CONTINUE,
+				RETURN,
+				TAIL_CALL,
+			};
+			QuickeningStats quickeningStats;
+			JitCompiler jit;
 
 			OPCODE ReadOPCode(const std::vector<uint8_t>& bytes, size_t& offset);
 			uint16_t ReadLabel(const std::vector<uint8_t>& bytes, size_t& offset);
@@ -48,10 +78,14 @@ namespace MSL
 			BaseObject* GetUnderlyingObject(BaseObject* object) const;
 			const std::string* GetObjectName(const BaseObject* object) const;
 			void InitializeStaticMembers();
+			/*
+			adds System namespace, class wrappers and static state of snapshot to loaded assembly. It is done once, before any method is called
+			*/
+			bool Initialize();
+			bool MergeAssembly(AssemblyEditor& editor);
 			void AddSystemNamespace();
-			void CollectGarbage(bool forceCollection = false);
 			bool ValidateHashValue(size_t hashValue, size_t maxHashValue);
-			bool AssertType(const BaseObject* object, Type type, const std::string& message, const Frame* frame = nullptr);
+			bool AssertType(const BaseObject* object, Type type, const char* message, const Frame* frame = nullptr);
 			bool LoadDll(const std::string& libName);
 			inline bool AssertType(const BaseObject* object, Type type);
 			void InitializeAttribute(ClassObject* object, const std::string& attribute, BaseObject* value);
@@ -62,6 +96,36 @@ namespace MSL
 			std::string GetFullMethodType(const MethodType* type) const;
 			std::string GetMethodActualName(const std::string& methodName) const;
 			void PerformSystemCall(const ClassType* _class, const MethodType* _method, Frame* frame);
+			/*
+			read operands from frame offset and call overloads with decoded operands
+			*/
+			void PerformIterationInit(Frame* frame);
+			void PerformIterationNext(Frame* frame);
+			void PerformStoreLocal(Frame* frame);
+			/*
+			instructions which can leave the frame. They are executed by interpreter and JIT helpers, operands are read from frame offset
+			*/
+			FrameAction PerformFunctionCall(Frame* frame, OPCODE op);
+			FrameAction PerformMethodCall(Frame* frame);
+			FrameAction PerformGetMember(Frame* frame);
+			FrameAction PerformReturn(Frame* frame, OPCODE op);
+			bool ResolveCallArguments(Frame* frame, uint8_t paramSize);
+			void QuickenALUCall(OPCODE op, Frame* frame);
+			void QuickenMethodCall(Frame* frame, size_t offset, const ClassType* receiver, const std::string* method);
+			void Despecialize(Frame* frame, size_t offset);
+			void UpdateHotness(const MethodType* method);
+			void FindInlineMethods();
+			void FindInlineKind(const ClassType& classType, const MethodType& method);
+			bool DecodeMethod(const ClassType* _class, const MethodType* method);
+			ClassObject* GetStaticInstance(const ClassType* _class);
+			bool TryInlineCall(Frame* frame, const ClassType* _class, const MethodType* method, uint8_t paramSize);
+			bool CanReuseFrame(const Frame* frame, const CallPath& callee) const;
+			bool IsFrameLocal(const Frame* frame, const LocalObject* local) const;
+			const MethodType::ExceptionHandler* FindExceptionHandler(const MethodType* method, size_t offset);
+			std::string GetTraceString(const ExceptionTrace::TraceEntry& entry) const;
+			ArrayObject* GetNativeArrayOrNull(BaseObject* object) const;
+			bool IsNativeRange(BaseObject* object) const;
+			bool ReuseIterationElement(const Local& element, Type type);
 			void PerformALUCallIntegers(IntegerObject* int1, const IntegerObject::InnerType* int2, OPCODE op, Frame* frame);
 			void PerformALUcallStrings(StringObject* str1, const StringObject::InnerType* str2, OPCODE op, Frame* frame);
 			void PerformALUcallStringInteger(StringObject* str, const IntegerObject::InnerType* integer, OPCODE op, Frame* frame);
@@ -99,9 +163,27 @@ namespace MSL
 
 			VirtualMachine(Configuration config);
 			bool AddBytecodeFile(std::istream* binaryFile);
+			/*
+			maps assembly file to memory and decodes it directly from mapped pages. Returns false if file cannot be mapped or contains errors
+			*/
+			bool AddBytecodeFile(const std::string& fileName);
 			void Run();
 			std::vector<std::string> GetErrorStrings(uint32_t errors) const;
 			void AddExternalFunction(const std::string& module, const std::string& function, void(*pointer)(VirtualMachine*));
+			bool AddAotMethod(const std::string& _namespace, const std::string& _class, const std::string& _method, uint64_t bodyHash, MethodType::NativeMethod function);
+			/*
+			loads module built from source generated by MSL aot command and calls its MSL_RegisterAotModule function, which attaches methods to loaded assembly
+			returns false if module or its registration function is not found, or some of its methods do not match loaded assembly
+			*/
+			bool LoadAotModule(const std::string& libName);
+			/*
+			calls static method without parameters, so static state it creates is written to snapshot. Quickening is disabled, as method bodies are written as they were loaded
+			*/
+			bool Warmup(const std::string& _namespace, const std::string& _class, const std::string& _method);
+			/*
+			writes loaded assembly and static state of VM as snapshot, which is restored when it is added to another VM by AddBytecodeFile()
+			*/
+			bool WriteSnapshot(std::ostream& out);
 
 			#ifdef MSL_DLL_API
 			public:
@@ -134,6 +216,8 @@ namespace MSL
 			uint32_t& GetErrors();
 			Configuration& GetConfig();
 			ExceptionTrace& GetException();
+			const QuickeningStats& GetQuickeningStats() const;
+			bool& GetAluIncrMode();
 			// Assembly Members
 			const MethodType* GetMethodOrNull(const std::string& _namespace, const std::string& _class, const std::string& _method) const;
 			const MethodType* GetMethodOrNull(const ClassType* _class, const std::string& _method) const;
@@ -142,9 +226,23 @@ namespace MSL
 			const NamespaceType* GetNamespaceOrNull(const std::string& _namespace) const;
 			// Method Invoke
 			void InvokeError(size_t error, const std::string& message, const std::string& arg);
+			/*
+			message of error is built by formatter only if it is read (by System.Exception.Instance() or when VM terminates). Errors which can be caught by script use it
+			*/
+			void InvokeError(size_t error, ExceptionTrace::Formatter formatter);
 			ClassWrapper* GetClassPrimitive(BaseObject* object);
 			BaseObject* GetMemberObject(BaseObject* object, const std::string& memberName);
 			void PerformALUCall(OPCODE op, size_t parameters, Frame* frame);
+			bool PerformInplaceALUCall(BaseObject* object, const BaseObject* value, OPCODE op);
+			// Frame Instructions, operands are dependency hashes and label index of frame method
+			void CollectGarbage(bool forceCollection = false);
+			Local* GetLocalSlot(Frame* frame, size_t hash);
+			void PerformStoreLocal(Frame* frame, size_t hash);
+			void PerformIterationInit(Frame* frame, size_t containerHash, size_t iteratorHash);
+			/*
+			moves frame offset to the end label when iteration is finished
+			*/
+			void PerformIterationNext(Frame* frame, size_t elementHash, size_t containerHash, size_t iteratorHash, uint16_t label);
 			void StartNewStackFrame();
 			void InvokeObjectMethod(const std::string& methodName, const ClassObject* object);
 			void InvokeStaticMethod(const std::string& methodName, const ClassType* type);
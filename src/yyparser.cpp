@@ -54,7 +54,7 @@
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -87,37 +87,24 @@ struct yy_ast_node
 };
 typedef yy_ast_node YYSTYPE;
 
-static Lexer* yy_lexer;
-
-void yyset_lexer(Lexer* lexer)
+int yylex(YYSTYPE* yylval, Lexer* lexer)
 {
-    yy_lexer = lexer;
-}
-
-extern YYSTYPE yylval;
-
-int yylex()
-{
-    auto* token = &yy_lexer->Peek();
-    yylval.token = token;
+    auto* token = &lexer->Peek();
+    yylval->token = token;
     //std::cout << token->value << ' ';
-    yy_lexer->Next();
+    lexer->Next();
     return token->type;
 }
 
-void yyerror(BaseAstNode** root, const char* message)
+void yyerror(BaseAstNode** root, Lexer* lexer, AstArena* arena, const char* message)
 {
     std::cout << "\n[Parser error]: " << message << std::endl;
 
-    if(*root != nullptr) // destroy AST
-    {
-        (*root)->Destroy();
-        delete *root;
-        *root = nullptr;
-    }
+    // nodes of incomplete AST are destroyed with the arena by Parser::Parse()
+    *root = nullptr;
 }
 
-#line 121 "yyparser.cpp"
+#line 108 "yyparser.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -232,9 +219,8 @@ extern int yydebug;
 /* Value type.  */
 
 
-extern YYSTYPE yylval;
 
-int yyparse (BaseAstNode** AST);
+int yyparse (BaseAstNode** AST, Lexer* lexer, AstArena* arena);
 
 
 
@@ -605,18 +591,18 @@ static const yytype_int8 yytranslate[] =
   /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   144,   144,   149,   157,   163,   167,   174,   182,   188,
-     197,   201,   208,   215,   223,   227,   237,   248,   254,   258,
-     265,   272,   279,   287,   292,   298,   304,   308,   315,   323,
-     329,   333,   341,   346,   351,   356,   361,   366,   371,   376,
-     381,   387,   392,   397,   402,   408,   413,   420,   425,   430,
-     435,   440,   445,   450,   455,   460,   465,   471,   477,   482,
-     488,   495,   503,   508,   513,   518,   523,   528,   533,   538,
-     543,   548,   553,   558,   563,   568,   573,   578,   584,   590,
-     596,   602,   608,   615,   620,   625,   631,   637,   643,   648,
-     654,   659,   665,   671,   675,   680,   686,   690,   694,   698,
-     704,   713,   722,   731,   741,   747,   753,   760,   766,   772,
-     779,   785,   792,   798,   803,   808
+       0,   137,   137,   142,   150,   156,   160,   167,   175,   181,
+     190,   194,   201,   208,   216,   220,   230,   241,   247,   251,
+     258,   265,   272,   280,   285,   291,   297,   301,   308,   316,
+     322,   326,   334,   339,   344,   349,   354,   359,   364,   369,
+     374,   380,   385,   390,   395,   401,   406,   413,   418,   423,
+     428,   433,   438,   443,   448,   453,   458,   464,   470,   475,
+     481,   488,   496,   501,   506,   511,   516,   521,   526,   531,
+     536,   541,   546,   551,   556,   561,   566,   571,   577,   583,
+     589,   595,   601,   608,   613,   618,   624,   630,   636,   641,
+     647,   652,   658,   664,   668,   673,   679,   683,   687,   691,
+     697,   706,   715,   724,   734,   740,   746,   753,   759,   765,
+     772,   778,   785,   791,   796,   801
 };
 #endif
 
@@ -946,7 +932,7 @@ static const yytype_int8 yyr2[] =
       }                                                           \
     else                                                          \
       {                                                           \
-        yyerror (AST, YY_("syntax error: cannot back up")); \
+        yyerror (AST, lexer, arena, YY_("syntax error: cannot back up")); \
         YYERROR;                                                  \
       }                                                           \
   while (0)
@@ -983,7 +969,7 @@ do {                                                                      \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, AST); \
+                  Type, Value, AST, lexer, arena); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -994,11 +980,13 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, BaseAstNode** AST)
+yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, BaseAstNode** AST, Lexer* lexer, AstArena* arena)
 {
   FILE *yyoutput = yyo;
   YYUSE (yyoutput);
   YYUSE (AST);
+  YYUSE (lexer);
+  YYUSE (arena);
   if (!yyvaluep)
     return;
 # ifdef YYPRINT
@@ -1016,12 +1004,12 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, Ba
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, BaseAstNode** AST)
+yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, BaseAstNode** AST, Lexer* lexer, AstArena* arena)
 {
   YYFPRINTF (yyo, "%s %s (",
              yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
 
-  yy_symbol_value_print (yyo, yytype, yyvaluep, AST);
+  yy_symbol_value_print (yyo, yytype, yyvaluep, AST, lexer, arena);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1054,7 +1042,7 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule, BaseAstNode** AST)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule, BaseAstNode** AST, Lexer* lexer, AstArena* arena)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1068,7 +1056,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule, BaseAstNode** AS
       yy_symbol_print (stderr,
                        yystos[yyssp[yyi + 1 - yynrhs]],
                        &yyvsp[(yyi + 1) - (yynrhs)]
-                                              , AST);
+                                              , AST, lexer, arena);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1076,7 +1064,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule, BaseAstNode** AS
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule, AST); \
+    yy_reduce_print (yyssp, yyvsp, Rule, AST, lexer, arena); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1344,10 +1332,12 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, BaseAstNode** AST)
+yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, BaseAstNode** AST, Lexer* lexer, AstArena* arena)
 {
   YYUSE (yyvaluep);
   YYUSE (AST);
+  YYUSE (lexer);
+  YYUSE (arena);
   if (!yymsg)
     yymsg = "Deleting";
   YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
@@ -1360,13 +1350,6 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, BaseAstNode** AST)
 
 
 
-/* The lookahead symbol.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 /*----------.
@@ -1374,8 +1357,21 @@ int yynerrs;
 `----------*/
 
 int
-yyparse (BaseAstNode** AST)
+yyparse (BaseAstNode** AST, Lexer* lexer, AstArena* arena)
 {
+/* The lookahead symbol.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs;
+
     yy_state_fast_t yystate;
     /* Number of tokens to shift before error messages enabled.  */
     int yyerrstatus;
@@ -1539,7 +1535,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = yylex ();
+      yychar = yylex (&yylval, lexer);
     }
 
   if (yychar <= YYEOF)
@@ -1616,127 +1612,127 @@ yyreduce:
   switch (yyn)
     {
   case 2:
-#line 144 "yyparser.y"
+#line 133 "yyparser.y"
     {
-        *AST = new AstNodeList();
+        *AST = arena->New<AstNodeList>();
         (yyval.expr) = *AST;
     }
-#line 1625 "yyparser.cpp"
+#line 1621 "yyparser.cpp"
     break;
 
   case 3:
-#line 150 "yyparser.y"
+#line 139 "yyparser.y"
     {
         auto* namespaces = static_cast<AstNodeList*>((yyvsp[-1].expr));
         namespaces->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1635 "yyparser.cpp"
+#line 1631 "yyparser.cpp"
     break;
 
   case 4:
-#line 158 "yyparser.y"
+#line 147 "yyparser.y"
     {
-        (yyval.expr) = new NamespaceDeclNode((yyvsp[-3].token)->value, static_cast<AstNodeList*>((yyvsp[-1].expr)));
+        (yyval.expr) = arena->New<NamespaceDeclNode>((yyvsp[-3].token)->value, static_cast<AstNodeList*>((yyvsp[-1].expr)));
     }
-#line 1643 "yyparser.cpp"
+#line 1639 "yyparser.cpp"
     break;
 
   case 5:
-#line 163 "yyparser.y"
+#line 152 "yyparser.y"
     {
-        (yyval.expr) = new AstNodeList();
+        (yyval.expr) = arena->New<AstNodeList>();
     }
-#line 1651 "yyparser.cpp"
+#line 1647 "yyparser.cpp"
     break;
 
   case 6:
-#line 168 "yyparser.y"
+#line 157 "yyparser.y"
     {
         auto* nsList = static_cast<AstNodeList*>((yyvsp[-1].expr));
         nsList->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1661 "yyparser.cpp"
+#line 1657 "yyparser.cpp"
     break;
 
   case 7:
-#line 175 "yyparser.y"
+#line 164 "yyparser.y"
     {
         auto* nsList = static_cast<AstNodeList*>((yyvsp[-1].expr));
         nsList->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1671 "yyparser.cpp"
+#line 1667 "yyparser.cpp"
     break;
 
   case 8:
-#line 183 "yyparser.y"
+#line 172 "yyparser.y"
     {
-        (yyval.expr) = new UsingNamespaceNode((yyvsp[-1].token)->value);
+        (yyval.expr) = arena->New<UsingNamespaceNode>((yyvsp[-1].token)->value);
     }
-#line 1679 "yyparser.cpp"
+#line 1675 "yyparser.cpp"
     break;
 
   case 9:
-#line 189 "yyparser.y"
+#line 178 "yyparser.y"
     {
-        auto* classNode = new ClassDeclNode((yyvsp[-3].token)->value);
+        auto* classNode = arena->New<ClassDeclNode>((yyvsp[-3].token)->value);
         classNode->modifiers = static_cast<StringList*>((yyvsp[-5].expr));
         classNode->members = static_cast<AstNodeList*>((yyvsp[-1].expr));
         (yyval.expr) = classNode;
     }
-#line 1690 "yyparser.cpp"
+#line 1686 "yyparser.cpp"
     break;
 
   case 10:
-#line 197 "yyparser.y"
+#line 186 "yyparser.y"
     {
-        (yyval.expr) = new StringList();
+        (yyval.expr) = arena->New<StringList>();
     }
-#line 1698 "yyparser.cpp"
+#line 1694 "yyparser.cpp"
     break;
 
   case 11:
-#line 202 "yyparser.y"
+#line 191 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("public");
         (yyval.expr) = modifiers;
     }
-#line 1708 "yyparser.cpp"
+#line 1704 "yyparser.cpp"
     break;
 
   case 12:
-#line 209 "yyparser.y"
+#line 198 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("private");
         (yyval.expr) = modifiers;
     }
-#line 1718 "yyparser.cpp"
+#line 1714 "yyparser.cpp"
     break;
 
   case 13:
-#line 216 "yyparser.y"
+#line 205 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("static");
         (yyval.expr) = modifiers;
     }
-#line 1728 "yyparser.cpp"
+#line 1724 "yyparser.cpp"
     break;
 
   case 14:
-#line 223 "yyparser.y"
+#line 212 "yyparser.y"
     {
-        (yyval.expr) = new AstNodeList();
+        (yyval.expr) = arena->New<AstNodeList>();
     }
-#line 1736 "yyparser.cpp"
+#line 1732 "yyparser.cpp"
     break;
 
   case 15:
-#line 228 "yyparser.y"
+#line 217 "yyparser.y"
     {
         auto* members = static_cast<AstNodeList*>((yyvsp[-2].expr));
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
@@ -1745,11 +1741,11 @@ yyreduce:
         members->vec.push_back(method);
         (yyval.expr) = members;
     }
-#line 1749 "yyparser.cpp"
+#line 1745 "yyparser.cpp"
     break;
 
   case 16:
-#line 238 "yyparser.y"
+#line 227 "yyparser.y"
     {
         auto* members = static_cast<AstNodeList*>((yyvsp[-2].expr));
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
@@ -1758,843 +1754,837 @@ yyreduce:
         members->vec.push_back(attribute);
         (yyval.expr) = members;
     }
-#line 1762 "yyparser.cpp"
+#line 1758 "yyparser.cpp"
     break;
 
   case 17:
-#line 249 "yyparser.y"
+#line 238 "yyparser.y"
     {
-        (yyval.expr) = new AttributeDeclNode((yyvsp[-1].token)->value);
+        (yyval.expr) = arena->New<AttributeDeclNode>((yyvsp[-1].token)->value);
     }
-#line 1770 "yyparser.cpp"
+#line 1766 "yyparser.cpp"
     break;
 
   case 18:
-#line 254 "yyparser.y"
+#line 243 "yyparser.y"
     {
-        (yyval.expr) = new StringList();
+        (yyval.expr) = arena->New<StringList>();
     }
-#line 1778 "yyparser.cpp"
+#line 1774 "yyparser.cpp"
     break;
 
   case 19:
-#line 259 "yyparser.y"
+#line 248 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("public");
         (yyval.expr) = modifiers;
     }
-#line 1788 "yyparser.cpp"
+#line 1784 "yyparser.cpp"
     break;
 
   case 20:
-#line 266 "yyparser.y"
+#line 255 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("private");
         (yyval.expr) = modifiers;
     }
-#line 1798 "yyparser.cpp"
+#line 1794 "yyparser.cpp"
     break;
 
   case 21:
-#line 273 "yyparser.y"
+#line 262 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("static");
         (yyval.expr) = modifiers;
     }
-#line 1808 "yyparser.cpp"
+#line 1804 "yyparser.cpp"
     break;
 
   case 22:
-#line 280 "yyparser.y"
+#line 269 "yyparser.y"
     {
         auto* modifiers = static_cast<StringList*>((yyvsp[-1].expr));
         modifiers->vec.push_back("const");
         (yyval.expr) = modifiers;
     }
-#line 1818 "yyparser.cpp"
+#line 1814 "yyparser.cpp"
     break;
 
   case 23:
-#line 288 "yyparser.y"
+#line 277 "yyparser.y"
     {
-        (yyval.expr) = new MethodDeclNode((yyvsp[-2].token)->value, static_cast<StringList*>((yyvsp[-1].expr)), nullptr);
+        (yyval.expr) = arena->New<MethodDeclNode>((yyvsp[-2].token)->value, static_cast<StringList*>((yyvsp[-1].expr)), nullptr);
     }
-#line 1826 "yyparser.cpp"
+#line 1822 "yyparser.cpp"
     break;
 
   case 24:
-#line 293 "yyparser.y"
+#line 282 "yyparser.y"
     {
-        (yyval.expr) = new MethodDeclNode((yyvsp[-2].token)->value, static_cast<StringList*>((yyvsp[-1].expr)), static_cast<AstNodeList*>((yyvsp[0].expr)));
+        (yyval.expr) = arena->New<MethodDeclNode>((yyvsp[-2].token)->value, static_cast<StringList*>((yyvsp[-1].expr)), static_cast<AstNodeList*>((yyvsp[0].expr)));
     }
-#line 1834 "yyparser.cpp"
+#line 1830 "yyparser.cpp"
     break;
 
   case 25:
-#line 299 "yyparser.y"
+#line 288 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1842 "yyparser.cpp"
+#line 1838 "yyparser.cpp"
     break;
 
   case 26:
-#line 304 "yyparser.y"
+#line 293 "yyparser.y"
     {
-        (yyval.expr) = new StringList();
+        (yyval.expr) = arena->New<StringList>();
     }
-#line 1850 "yyparser.cpp"
+#line 1846 "yyparser.cpp"
     break;
 
   case 27:
-#line 309 "yyparser.y"
+#line 298 "yyparser.y"
     {
-        auto* strs = new StringList();
+        auto* strs = arena->New<StringList>();
         strs->vec.push_back((yyvsp[0].token)->value);
         (yyval.expr) = strs;
     }
-#line 1860 "yyparser.cpp"
+#line 1856 "yyparser.cpp"
     break;
 
   case 28:
-#line 316 "yyparser.y"
+#line 305 "yyparser.y"
     {
         auto* strs = static_cast<StringList*>((yyvsp[-2].expr));
         strs->vec.push_back((yyvsp[0].token)->value);
         (yyval.expr) = strs;
     }
-#line 1870 "yyparser.cpp"
+#line 1866 "yyparser.cpp"
     break;
 
   case 29:
-#line 324 "yyparser.y"
+#line 313 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1878 "yyparser.cpp"
+#line 1874 "yyparser.cpp"
     break;
 
   case 30:
-#line 329 "yyparser.y"
+#line 318 "yyparser.y"
     {
-        (yyval.expr) = new AstNodeList();
+        (yyval.expr) = arena->New<AstNodeList>();
     }
-#line 1886 "yyparser.cpp"
+#line 1882 "yyparser.cpp"
     break;
 
   case 31:
-#line 334 "yyparser.y"
+#line 323 "yyparser.y"
     {
         auto* exprs = static_cast<AstNodeList*>((yyvsp[-1].expr));
         exprs->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = exprs;
     }
-#line 1896 "yyparser.cpp"
+#line 1892 "yyparser.cpp"
     break;
 
   case 32:
-#line 342 "yyparser.y"
+#line 331 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1904 "yyparser.cpp"
+#line 1900 "yyparser.cpp"
     break;
 
   case 33:
-#line 347 "yyparser.y"
+#line 336 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1912 "yyparser.cpp"
+#line 1908 "yyparser.cpp"
     break;
 
   case 34:
-#line 352 "yyparser.y"
+#line 341 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1920 "yyparser.cpp"
+#line 1916 "yyparser.cpp"
     break;
 
   case 35:
-#line 357 "yyparser.y"
+#line 346 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1928 "yyparser.cpp"
+#line 1924 "yyparser.cpp"
     break;
 
   case 36:
-#line 362 "yyparser.y"
+#line 351 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1936 "yyparser.cpp"
+#line 1932 "yyparser.cpp"
     break;
 
   case 37:
-#line 367 "yyparser.y"
+#line 356 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1944 "yyparser.cpp"
+#line 1940 "yyparser.cpp"
     break;
 
   case 38:
-#line 372 "yyparser.y"
+#line 361 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1952 "yyparser.cpp"
+#line 1948 "yyparser.cpp"
     break;
 
   case 39:
-#line 377 "yyparser.y"
+#line 366 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1960 "yyparser.cpp"
+#line 1956 "yyparser.cpp"
     break;
 
   case 40:
-#line 382 "yyparser.y"
+#line 371 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1968 "yyparser.cpp"
+#line 1964 "yyparser.cpp"
     break;
 
   case 41:
-#line 388 "yyparser.y"
+#line 377 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1976 "yyparser.cpp"
+#line 1972 "yyparser.cpp"
     break;
 
   case 42:
-#line 393 "yyparser.y"
+#line 382 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[-1].expr);
     }
-#line 1984 "yyparser.cpp"
+#line 1980 "yyparser.cpp"
     break;
 
   case 43:
-#line 398 "yyparser.y"
+#line 387 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 1992 "yyparser.cpp"
+#line 1988 "yyparser.cpp"
     break;
 
   case 44:
-#line 403 "yyparser.y"
+#line 392 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2000 "yyparser.cpp"
+#line 1996 "yyparser.cpp"
     break;
 
   case 45:
-#line 409 "yyparser.y"
+#line 398 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2008 "yyparser.cpp"
+#line 2004 "yyparser.cpp"
     break;
 
   case 46:
-#line 414 "yyparser.y"
+#line 403 "yyparser.y"
     {
         auto* call = static_cast<MethodCallNode*>((yyvsp[0].expr));
         call->parent = (yyvsp[-2].expr);
         (yyval.expr) = call;
     }
-#line 2018 "yyparser.cpp"
+#line 2014 "yyparser.cpp"
     break;
 
   case 47:
-#line 421 "yyparser.y"
+#line 410 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2026 "yyparser.cpp"
+#line 2022 "yyparser.cpp"
     break;
 
   case 48:
-#line 426 "yyparser.y"
+#line 415 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2034 "yyparser.cpp"
+#line 2030 "yyparser.cpp"
     break;
 
   case 49:
-#line 431 "yyparser.y"
+#line 420 "yyparser.y"
     {
-       (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+       (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2042 "yyparser.cpp"
+#line 2038 "yyparser.cpp"
     break;
 
   case 50:
-#line 436 "yyparser.y"
+#line 425 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2050 "yyparser.cpp"
+#line 2046 "yyparser.cpp"
     break;
 
   case 51:
-#line 441 "yyparser.y"
+#line 430 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2058 "yyparser.cpp"
+#line 2054 "yyparser.cpp"
     break;
 
   case 52:
-#line 446 "yyparser.y"
+#line 435 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2066 "yyparser.cpp"
+#line 2062 "yyparser.cpp"
     break;
 
   case 53:
-#line 451 "yyparser.y"
+#line 440 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2074 "yyparser.cpp"
+#line 2070 "yyparser.cpp"
     break;
 
   case 54:
-#line 456 "yyparser.y"
+#line 445 "yyparser.y"
     {
-        (yyval.expr) = new ObjectNode((yyvsp[0].token)->value, (yyvsp[0].token)->type);
+        (yyval.expr) = arena->New<ObjectNode>((yyvsp[0].token)->value, (yyvsp[0].token)->type);
     }
-#line 2082 "yyparser.cpp"
+#line 2078 "yyparser.cpp"
     break;
 
   case 55:
-#line 461 "yyparser.y"
+#line 450 "yyparser.y"
     {
-        (yyval.expr) = new MemberCallNode((yyvsp[-2].expr), (yyvsp[0].token)->value);
+        (yyval.expr) = arena->New<MemberCallNode>((yyvsp[-2].expr), (yyvsp[0].token)->value);
     }
-#line 2090 "yyparser.cpp"
+#line 2086 "yyparser.cpp"
     break;
 
   case 56:
-#line 466 "yyparser.y"
+#line 455 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2098 "yyparser.cpp"
+#line 2094 "yyparser.cpp"
     break;
 
   case 57:
-#line 472 "yyparser.y"
+#line 461 "yyparser.y"
     {
-        (yyval.expr) = new IndexCallNode((yyvsp[-3].expr), (yyvsp[-1].expr));
+        (yyval.expr) = arena->New<IndexCallNode>((yyvsp[-3].expr), (yyvsp[-1].expr));
     }
-#line 2106 "yyparser.cpp"
+#line 2102 "yyparser.cpp"
     break;
 
   case 58:
-#line 478 "yyparser.y"
+#line 467 "yyparser.y"
     {
-        (yyval.expr) = new MethodCallNode((yyvsp[-2].token)->value, nullptr, new AstNodeList());
+        (yyval.expr) = arena->New<MethodCallNode>((yyvsp[-2].token)->value, nullptr, arena->New<AstNodeList>());
     }
-#line 2114 "yyparser.cpp"
+#line 2110 "yyparser.cpp"
     break;
 
   case 59:
-#line 483 "yyparser.y"
+#line 472 "yyparser.y"
     {
-        (yyval.expr) = new MethodCallNode((yyvsp[-3].token)->value, nullptr, static_cast<AstNodeList*>((yyvsp[-1].expr)));
+        (yyval.expr) = arena->New<MethodCallNode>((yyvsp[-3].token)->value, nullptr, static_cast<AstNodeList*>((yyvsp[-1].expr)));
     }
-#line 2122 "yyparser.cpp"
+#line 2118 "yyparser.cpp"
     break;
 
   case 60:
-#line 489 "yyparser.y"
+#line 478 "yyparser.y"
     {
-        auto* args = new AstNodeList();
+        auto* args = arena->New<AstNodeList>();
         args->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = args;
     }
-#line 2132 "yyparser.cpp"
+#line 2128 "yyparser.cpp"
     break;
 
   case 61:
-#line 496 "yyparser.y"
+#line 485 "yyparser.y"
     {
         auto* args = static_cast<AstNodeList*>((yyvsp[-2].expr));
         args->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = args;
     }
-#line 2142 "yyparser.cpp"
+#line 2138 "yyparser.cpp"
     break;
 
   case 62:
-#line 504 "yyparser.y"
+#line 493 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUM_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUM_OP);
     }
-#line 2150 "yyparser.cpp"
+#line 2146 "yyparser.cpp"
     break;
 
   case 63:
-#line 509 "yyparser.y"
+#line 498 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUB_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUB_OP);
     }
-#line 2158 "yyparser.cpp"
+#line 2154 "yyparser.cpp"
     break;
 
   case 64:
-#line 514 "yyparser.y"
+#line 503 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::MULT_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::MULT_OP);
     }
-#line 2166 "yyparser.cpp"
+#line 2162 "yyparser.cpp"
     break;
 
   case 65:
-#line 519 "yyparser.y"
+#line 508 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::DIV_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::DIV_OP);
     }
-#line 2174 "yyparser.cpp"
+#line 2170 "yyparser.cpp"
     break;
 
   case 66:
-#line 524 "yyparser.y"
+#line 513 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::MOD_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::MOD_OP);
     }
-#line 2182 "yyparser.cpp"
+#line 2178 "yyparser.cpp"
     break;
 
   case 67:
-#line 529 "yyparser.y"
+#line 518 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::POWER_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::POWER_OP);
     }
-#line 2190 "yyparser.cpp"
+#line 2186 "yyparser.cpp"
     break;
 
   case 68:
-#line 534 "yyparser.y"
+#line 523 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_EQUALS);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_EQUALS);
     }
-#line 2198 "yyparser.cpp"
+#line 2194 "yyparser.cpp"
     break;
 
   case 69:
-#line 539 "yyparser.y"
+#line 528 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_NOT_EQUALS);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_NOT_EQUALS);
     }
-#line 2206 "yyparser.cpp"
+#line 2202 "yyparser.cpp"
     break;
 
   case 70:
-#line 544 "yyparser.y"
+#line 533 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_LESS);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_LESS);
     }
-#line 2214 "yyparser.cpp"
+#line 2210 "yyparser.cpp"
     break;
 
   case 71:
-#line 549 "yyparser.y"
+#line 538 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_GREATER);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_GREATER);
     }
-#line 2222 "yyparser.cpp"
+#line 2218 "yyparser.cpp"
     break;
 
   case 72:
-#line 554 "yyparser.y"
+#line 543 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_LESS_EQUALS);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_LESS_EQUALS);
     }
-#line 2230 "yyparser.cpp"
+#line 2226 "yyparser.cpp"
     break;
 
   case 73:
-#line 559 "yyparser.y"
+#line 548 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_GREATER_EQUALS);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_GREATER_EQUALS);
     }
-#line 2238 "yyparser.cpp"
+#line 2234 "yyparser.cpp"
     break;
 
   case 74:
-#line 564 "yyparser.y"
+#line 553 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_OR);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_OR);
     }
-#line 2246 "yyparser.cpp"
+#line 2242 "yyparser.cpp"
     break;
 
   case 75:
-#line 569 "yyparser.y"
+#line 558 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_AND);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::LOGIC_AND);
     }
-#line 2254 "yyparser.cpp"
+#line 2250 "yyparser.cpp"
     break;
 
   case 76:
-#line 574 "yyparser.y"
+#line 563 "yyparser.y"
     {
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::ASSIGN_OP);
     }
-#line 2262 "yyparser.cpp"
+#line 2258 "yyparser.cpp"
     break;
 
   case 77:
-#line 579 "yyparser.y"
+#line 568 "yyparser.y"
     {
-        auto* expr = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUM_OP);
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), expr, Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUM_ASSIGN_OP);
     }
-#line 2271 "yyparser.cpp"
+#line 2266 "yyparser.cpp"
     break;
 
   case 78:
-#line 585 "yyparser.y"
+#line 573 "yyparser.y"
     {
-        auto* expr = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUB_OP);
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), expr, Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::SUB_ASSIGN_OP);
     }
-#line 2280 "yyparser.cpp"
+#line 2274 "yyparser.cpp"
     break;
 
   case 79:
-#line 591 "yyparser.y"
+#line 578 "yyparser.y"
     {
-        auto* expr = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::MULT_OP);
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), expr, Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::MULT_ASSIGN_OP);
     }
-#line 2289 "yyparser.cpp"
+#line 2282 "yyparser.cpp"
     break;
 
   case 80:
-#line 597 "yyparser.y"
+#line 583 "yyparser.y"
     {
-        auto* expr = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::DIV_OP);
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), expr, Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::DIV_ASSIGN_OP);
     }
-#line 2298 "yyparser.cpp"
+#line 2290 "yyparser.cpp"
     break;
 
   case 81:
-#line 603 "yyparser.y"
+#line 588 "yyparser.y"
     {
-        auto* expr = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::MOD_OP);
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), expr, Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::MOD_ASSIGN_OP);
     }
-#line 2307 "yyparser.cpp"
+#line 2298 "yyparser.cpp"
     break;
 
   case 82:
-#line 609 "yyparser.y"
+#line 593 "yyparser.y"
     {
-        auto* expr = new BinaryExprNode((yyvsp[-2].expr), (yyvsp[0].expr), Type::POWER_OP);
-        (yyval.expr) = new BinaryExprNode((yyvsp[-2].expr), expr, Type::ASSIGN_OP);
+        (yyval.expr) = arena->New<BinaryExprNode>((yyvsp[-2].expr), (yyvsp[0].expr), Type::POWER_ASSIGN_OP);
     }
-#line 2316 "yyparser.cpp"
+#line 2306 "yyparser.cpp"
     break;
 
   case 83:
-#line 616 "yyparser.y"
+#line 599 "yyparser.y"
     {
-        (yyval.expr) = new UnaryExprNode((yyvsp[0].expr), Type::NEGATION_OP);
+        (yyval.expr) = arena->New<UnaryExprNode>((yyvsp[0].expr), Type::NEGATION_OP);
     }
-#line 2324 "yyparser.cpp"
+#line 2314 "yyparser.cpp"
     break;
 
   case 84:
-#line 621 "yyparser.y"
+#line 604 "yyparser.y"
     {
-        auto* expr = new UnaryExprNode((yyvsp[0].expr), Type::POSITIVE_OP);
+        auto* expr = arena->New<UnaryExprNode>((yyvsp[0].expr), Type::POSITIVE_OP);
     }
-#line 2332 "yyparser.cpp"
+#line 2322 "yyparser.cpp"
     break;
 
   case 85:
-#line 626 "yyparser.y"
+#line 609 "yyparser.y"
     {
-        auto* expr = new UnaryExprNode((yyvsp[0].expr), Type::NEGATIVE_OP);
+        auto* expr = arena->New<UnaryExprNode>((yyvsp[0].expr), Type::NEGATIVE_OP);
     }
-#line 2340 "yyparser.cpp"
+#line 2330 "yyparser.cpp"
     break;
 
   case 86:
-#line 632 "yyparser.y"
+#line 615 "yyparser.y"
     {
-        (yyval.expr) = new ReturnExprNode(new ObjectNode("null", Token::Type::NULLPTR));
+        (yyval.expr) = arena->New<ReturnExprNode>(arena->New<ObjectNode>("null", Token::Type::NULLPTR));
         // maybe check if function is a constructor?
     }
-#line 2349 "yyparser.cpp"
+#line 2339 "yyparser.cpp"
     break;
 
   case 87:
-#line 638 "yyparser.y"
+#line 621 "yyparser.y"
     {
-         (yyval.expr) = new ReturnExprNode((yyvsp[0].expr));
+         (yyval.expr) = arena->New<ReturnExprNode>((yyvsp[0].expr));
     }
-#line 2357 "yyparser.cpp"
+#line 2347 "yyparser.cpp"
     break;
 
   case 88:
-#line 644 "yyparser.y"
+#line 627 "yyparser.y"
     {
-        (yyval.expr) = new VariableDeclNode((yyvsp[0].token)->value, false, nullptr);
+        (yyval.expr) = arena->New<VariableDeclNode>((yyvsp[0].token)->value, false, nullptr);
     }
-#line 2365 "yyparser.cpp"
+#line 2355 "yyparser.cpp"
     break;
 
   case 89:
-#line 649 "yyparser.y"
+#line 632 "yyparser.y"
     {
-        (yyval.expr) = new VariableDeclNode((yyvsp[-2].token)->value, false, (yyvsp[0].expr));
+        (yyval.expr) = arena->New<VariableDeclNode>((yyvsp[-2].token)->value, false, (yyvsp[0].expr));
     }
-#line 2373 "yyparser.cpp"
+#line 2363 "yyparser.cpp"
     break;
 
   case 90:
-#line 655 "yyparser.y"
+#line 638 "yyparser.y"
     {
-        (yyval.expr) = new VariableDeclNode((yyvsp[0].token)->value, true, new ObjectNode("null", Token::Type::NULLPTR));
+        (yyval.expr) = arena->New<VariableDeclNode>((yyvsp[0].token)->value, true, arena->New<ObjectNode>("null", Token::Type::NULLPTR));
     }
-#line 2381 "yyparser.cpp"
+#line 2371 "yyparser.cpp"
     break;
 
   case 91:
-#line 660 "yyparser.y"
+#line 643 "yyparser.y"
     {
-        (yyval.expr) = new VariableDeclNode((yyvsp[-2].token)->value, true, (yyvsp[0].expr));
+        (yyval.expr) = arena->New<VariableDeclNode>((yyvsp[-2].token)->value, true, (yyvsp[0].expr));
     }
-#line 2389 "yyparser.cpp"
+#line 2379 "yyparser.cpp"
     break;
 
   case 92:
-#line 666 "yyparser.y"
+#line 649 "yyparser.y"
     {
-        (yyval.expr) = new ForExprNode((yyvsp[-6].expr), (yyvsp[-4].expr), (yyvsp[-2].expr), (yyvsp[0].expr));
+        (yyval.expr) = arena->New<ForExprNode>((yyvsp[-6].expr), (yyvsp[-4].expr), (yyvsp[-2].expr), (yyvsp[0].expr));
     }
-#line 2397 "yyparser.cpp"
+#line 2387 "yyparser.cpp"
     break;
 
   case 93:
-#line 671 "yyparser.y"
+#line 654 "yyparser.y"
     {
         (yyval.expr) = nullptr;
     }
-#line 2405 "yyparser.cpp"
+#line 2395 "yyparser.cpp"
     break;
 
   case 94:
-#line 676 "yyparser.y"
+#line 659 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2413 "yyparser.cpp"
+#line 2403 "yyparser.cpp"
     break;
 
   case 95:
-#line 681 "yyparser.y"
+#line 664 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2421 "yyparser.cpp"
+#line 2411 "yyparser.cpp"
     break;
 
   case 96:
-#line 686 "yyparser.y"
+#line 669 "yyparser.y"
     {
         (yyval.expr) = nullptr;
     }
-#line 2429 "yyparser.cpp"
+#line 2419 "yyparser.cpp"
     break;
 
   case 98:
-#line 694 "yyparser.y"
+#line 677 "yyparser.y"
     {
         (yyval.expr) = nullptr;
     }
-#line 2437 "yyparser.cpp"
+#line 2427 "yyparser.cpp"
     break;
 
   case 99:
-#line 699 "yyparser.y"
+#line 682 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2445 "yyparser.cpp"
+#line 2435 "yyparser.cpp"
     break;
 
   case 100:
-#line 705 "yyparser.y"
+#line 688 "yyparser.y"
     {
-        (yyval.expr) = new IfStatementNode(
+        (yyval.expr) = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>((yyvsp[0].expr)), 
-            new AstNodeList(), 
+            arena->New<AstNodeList>(), 
             nullptr
         );
     }
-#line 2457 "yyparser.cpp"
+#line 2447 "yyparser.cpp"
     break;
 
   case 101:
-#line 714 "yyparser.y"
+#line 697 "yyparser.y"
     {
-        (yyval.expr) = new IfStatementNode(
+        (yyval.expr) = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>((yyvsp[-1].expr)), 
             static_cast<AstNodeList*>((yyvsp[0].expr)), 
             nullptr
         );
     }
-#line 2469 "yyparser.cpp"
+#line 2459 "yyparser.cpp"
     break;
 
   case 102:
-#line 723 "yyparser.y"
+#line 706 "yyparser.y"
     {
-        (yyval.expr) = new IfStatementNode(
+        (yyval.expr) = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>((yyvsp[-2].expr)), 
             static_cast<AstNodeList*>((yyvsp[-1].expr)), 
             static_cast<ConditionalNode*>((yyvsp[0].expr))
         );
     }
-#line 2481 "yyparser.cpp"
+#line 2471 "yyparser.cpp"
     break;
 
   case 103:
-#line 732 "yyparser.y"
+#line 715 "yyparser.y"
     {
-        (yyval.expr) = new IfStatementNode(
+        (yyval.expr) = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>((yyvsp[-1].expr)), 
-            new AstNodeList(), 
+            arena->New<AstNodeList>(), 
             static_cast<ConditionalNode*>((yyvsp[0].expr))
         );
     }
-#line 2493 "yyparser.cpp"
+#line 2483 "yyparser.cpp"
     break;
 
   case 104:
-#line 742 "yyparser.y"
+#line 725 "yyparser.y"
     {
-        (yyval.expr) = new ConditionalNode((yyvsp[-2].expr), (yyvsp[0].expr));
+        (yyval.expr) = arena->New<ConditionalNode>((yyvsp[-2].expr), (yyvsp[0].expr));
     }
-#line 2501 "yyparser.cpp"
+#line 2491 "yyparser.cpp"
     break;
 
   case 105:
-#line 748 "yyparser.y"
+#line 731 "yyparser.y"
     {
-        auto* elifs = new AstNodeList();
+        auto* elifs = arena->New<AstNodeList>();
         elifs->vec.push_back((yyvsp[0].expr));
     }
-#line 2510 "yyparser.cpp"
+#line 2500 "yyparser.cpp"
     break;
 
   case 106:
-#line 754 "yyparser.y"
+#line 737 "yyparser.y"
     {
         auto* elifs = static_cast<AstNodeList*>((yyvsp[-1].expr));
         elifs->vec.push_back((yyvsp[0].expr));
     }
-#line 2519 "yyparser.cpp"
+#line 2509 "yyparser.cpp"
     break;
 
   case 107:
-#line 761 "yyparser.y"
+#line 744 "yyparser.y"
     {
-        (yyval.expr) = new ConditionalNode((yyvsp[-2].expr), (yyvsp[0].expr));
+        (yyval.expr) = arena->New<ConditionalNode>((yyvsp[-2].expr), (yyvsp[0].expr));
     }
-#line 2527 "yyparser.cpp"
+#line 2517 "yyparser.cpp"
     break;
 
   case 108:
-#line 767 "yyparser.y"
+#line 750 "yyparser.y"
     {
-        (yyval.expr) = new ConditionalNode(nullptr, (yyvsp[0].expr));
+        (yyval.expr) = arena->New<ConditionalNode>(nullptr, (yyvsp[0].expr));
     }
-#line 2535 "yyparser.cpp"
+#line 2525 "yyparser.cpp"
     break;
 
   case 109:
-#line 773 "yyparser.y"
+#line 756 "yyparser.y"
     {
-        auto* exprs = new AstNodeList();
+        auto* exprs = arena->New<AstNodeList>();
         exprs->vec.push_back((yyvsp[0].expr));
         (yyval.expr) = exprs;
     }
-#line 2545 "yyparser.cpp"
+#line 2535 "yyparser.cpp"
     break;
 
   case 110:
-#line 780 "yyparser.y"
+#line 763 "yyparser.y"
     {
         (yyval.expr) = (yyvsp[0].expr);
     }
-#line 2553 "yyparser.cpp"
+#line 2543 "yyparser.cpp"
     break;
 
   case 111:
-#line 786 "yyparser.y"
+#line 769 "yyparser.y"
     {
-        (yyval.expr) = new ForExprNode(nullptr, (yyvsp[-2].expr), nullptr, (yyvsp[0].expr));
+        (yyval.expr) = arena->New<ForExprNode>(nullptr, (yyvsp[-2].expr), nullptr, (yyvsp[0].expr));
         // init and iter are empty in while statement
     }
-#line 2562 "yyparser.cpp"
+#line 2552 "yyparser.cpp"
     break;
 
   case 112:
-#line 793 "yyparser.y"
+#line 776 "yyparser.y"
     {
-        (yyval.expr) = new ForeachExprNode((yyvsp[-4].token)->value, (yyvsp[-2].expr), (yyvsp[0].expr));
+        (yyval.expr) = arena->New<ForeachExprNode>((yyvsp[-4].token)->value, (yyvsp[-2].expr), (yyvsp[0].expr));
     }
-#line 2570 "yyparser.cpp"
+#line 2560 "yyparser.cpp"
     break;
 
   case 113:
-#line 799 "yyparser.y"
+#line 782 "yyparser.y"
     {
-        (yyval.expr) = new TryCatchNode("", (yyvsp[0].expr), nullptr);
+        (yyval.expr) = arena->New<TryCatchNode>("", (yyvsp[0].expr), nullptr);
     }
-#line 2578 "yyparser.cpp"
+#line 2568 "yyparser.cpp"
     break;
 
   case 114:
-#line 804 "yyparser.y"
+#line 787 "yyparser.y"
     {
-        (yyval.expr) = new TryCatchNode("", (yyvsp[-2].expr), (yyvsp[0].expr));
+        (yyval.expr) = arena->New<TryCatchNode>("", (yyvsp[-2].expr), (yyvsp[0].expr));
     }
-#line 2586 "yyparser.cpp"
+#line 2576 "yyparser.cpp"
     break;
 
   case 115:
-#line 809 "yyparser.y"
+#line 792 "yyparser.y"
     {
-        (yyval.expr) = new TryCatchNode((yyvsp[-2].token)->value, (yyvsp[-5].expr), (yyvsp[0].expr));
+        (yyval.expr) = arena->New<TryCatchNode>((yyvsp[-2].token)->value, (yyvsp[-5].expr), (yyvsp[0].expr));
     }
-#line 2594 "yyparser.cpp"
+#line 2584 "yyparser.cpp"
     break;
 
 
-#line 2598 "yyparser.cpp"
+#line 2588 "yyparser.cpp"
 
       default: break;
     }
@@ -2644,7 +2634,7 @@ yyerrlab:
     {
       ++yynerrs;
 #if ! YYERROR_VERBOSE
-      yyerror (AST, YY_("syntax error"));
+      yyerror (AST, lexer, arena, YY_("syntax error"));
 #else
 # define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
                                         yyssp, yytoken)
@@ -2671,7 +2661,7 @@ yyerrlab:
                 yymsgp = yymsg;
               }
           }
-        yyerror (AST, yymsgp);
+        yyerror (AST, lexer, arena, yymsgp);
         if (yysyntax_error_status == 2)
           goto yyexhaustedlab;
       }
@@ -2695,7 +2685,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval, AST);
+                      yytoken, &yylval, AST, lexer, arena);
           yychar = YYEMPTY;
         }
     }
@@ -2749,7 +2739,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, AST);
+                  yystos[yystate], yyvsp, AST, lexer, arena);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2788,7 +2778,7 @@ yyabortlab:
 | yyexhaustedlab -- memory exhaustion comes here.  |
 `-------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (AST, YY_("memory exhausted"));
+  yyerror (AST, lexer, arena, YY_("memory exhausted"));
   yyresult = 2;
   /* Fall through.  */
 #endif
@@ -2804,7 +2794,7 @@ yyreturn:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, AST);
+                  yytoken, &yylval, AST, lexer, arena);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -2813,7 +2803,7 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp, AST);
+                  yystos[*yyssp], yyvsp, AST, lexer, arena);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -2826,4 +2816,4 @@ yyreturn:
 #endif
   return yyresult;
 }
-#line 812 "yyparser.y"
+#line 795 "yyparser.y"
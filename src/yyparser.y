@@ -18,39 +18,28 @@ struct yy_ast_node
 };
 typedef yy_ast_node YYSTYPE;
 
-static Lexer* yy_lexer;
-
-void yyset_lexer(Lexer* lexer)
+int yylex(YYSTYPE* yylval, Lexer* lexer)
 {
-    yy_lexer = lexer;
-}
-
-extern YYSTYPE yylval;
-
-int yylex()
-{
-    auto* token = &yy_lexer->Peek();
-    yylval.token = token;
+    auto* token = &lexer->Peek();
+    yylval->token = token;
     //std::cout << token->value << ' ';
-    yy_lexer->Next();
+    lexer->Next();
     return token->type;
 }
 
-void yyerror(BaseAstNode** root, const char* message)
+void yyerror(BaseAstNode** root, Lexer* lexer, AstArena* arena, const char* message)
 {
     std::cout << "\n[Parser error]: " << message << std::endl;
 
-    if(*root != nullptr) // destroy AST
-    {
-        (*root)->Destroy();
-        delete *root;
-        *root = nullptr;
-    }
+    // nodes of incomplete AST are destroyed with the arena by Parser::Parse()
+    *root = nullptr;
 }
 %}
 
 %define parse.error verbose
-%parse-param {BaseAstNode** AST}
+%define api.pure full
+%lex-param {Lexer* lexer}
+%parse-param {BaseAstNode** AST} {Lexer* lexer} {AstArena* arena}
 
 %token ERROR
 %token ENDLINE
@@ -142,7 +131,7 @@ void yyerror(BaseAstNode** root, const char* message)
 %%
 NAMESPACE_LIST:
     {
-        *AST = new AstNodeList();
+        *AST = arena->New<AstNodeList>();
         $$ = *AST;
     }
     |
@@ -156,12 +145,12 @@ NAMESPACE_LIST:
 NAMESPACE_DECL:
     NAMESPACE OBJECT BRACE_BRACKET_O NAMESPACE_MEMBER_LIST BRACE_BRACKET_C
     {
-        $$ = new NamespaceDeclNode($2->value, static_cast<AstNodeList*>($4));
+        $$ = arena->New<NamespaceDeclNode>($2->value, static_cast<AstNodeList*>($4));
     }
 
 NAMESPACE_MEMBER_LIST:
     {
-        $$ = new AstNodeList();
+        $$ = arena->New<AstNodeList>();
     }
     |
     NAMESPACE_MEMBER_LIST CLASS_DECL
@@ -181,13 +170,13 @@ NAMESPACE_MEMBER_LIST:
 USING_STATEMENT:
     USING NAMESPACE OBJECT SEMICOLON
     {
-        $$ = new UsingNamespaceNode($3->value);
+        $$ = arena->New<UsingNamespaceNode>($3->value);
     }
 
 CLASS_DECL:
     CLASS_MODIFIER_LIST CLASS OBJECT BRACE_BRACKET_O MEMBER_LIST BRACE_BRACKET_C
     {
-        auto* classNode = new ClassDeclNode($3->value);
+        auto* classNode = arena->New<ClassDeclNode>($3->value);
         classNode->modifiers = static_cast<StringList*>($1);
         classNode->members = static_cast<AstNodeList*>($5);
         $$ = classNode;
@@ -195,7 +184,7 @@ CLASS_DECL:
 
 CLASS_MODIFIER_LIST:
     {
-        $$ = new StringList();
+        $$ = arena->New<StringList>();
     }
     |
     MEMBER_MODIFIER_LIST PUBLIC
@@ -221,7 +210,7 @@ CLASS_MODIFIER_LIST:
 
 MEMBER_LIST:
     {
-        $$ = new AstNodeList();
+        $$ = arena->New<AstNodeList>();
     }
     |
     MEMBER_LIST MEMBER_MODIFIER_LIST METHOD_DECL
@@ -247,12 +236,12 @@ MEMBER_LIST:
 ATTRIBUTE_DECL:
     VARIABLE OBJECT SEMICOLON
     {
-        $$ = new AttributeDeclNode($2->value);
+        $$ = arena->New<AttributeDeclNode>($2->value);
     }
 
 MEMBER_MODIFIER_LIST:
     {
-        $$ = new StringList();
+        $$ = arena->New<StringList>();
     }
     |
     MEMBER_MODIFIER_LIST PUBLIC
@@ -286,12 +275,12 @@ MEMBER_MODIFIER_LIST:
 METHOD_DECL:
     FUNCTION OBJECT ARGUMENT_LIST_DECL SEMICOLON
     {
-        $$ = new MethodDeclNode($2->value, static_cast<StringList*>($3), nullptr);
+        $$ = arena->New<MethodDeclNode>($2->value, static_cast<StringList*>($3), nullptr);
     }
     |
     FUNCTION OBJECT ARGUMENT_LIST_DECL EXPRESSION_BLOCK
     {
-        $$ = new MethodDeclNode($2->value, static_cast<StringList*>($3), static_cast<AstNodeList*>($4));
+        $$ = arena->New<MethodDeclNode>($2->value, static_cast<StringList*>($3), static_cast<AstNodeList*>($4));
     }
 
 ARGUMENT_LIST_DECL:
@@ -302,12 +291,12 @@ ARGUMENT_LIST_DECL:
 
 VARIABLE_NAME_LIST:
     {
-        $$ = new StringList();
+        $$ = arena->New<StringList>();
     }
     |
     OBJECT
     {
-        auto* strs = new StringList();
+        auto* strs = arena->New<StringList>();
         strs->vec.push_back($1->value);
         $$ = strs;
     }
@@ -327,7 +316,7 @@ EXPRESSION_BLOCK:
 
 EXPRESSION_LIST:
     {
-        $$ = new AstNodeList();
+        $$ = arena->New<AstNodeList>();
     }
     |
     EXPRESSION_LIST EXPRESSION
@@ -419,47 +408,47 @@ VALUE:
     |
     INTEGER_CONSTANT
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     | 
     STRING_CONSTANT
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     | 
     FLOAT_CONSTANT
     {
-       $$ = new ObjectNode($1->value, $1->type);
+       $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     | 
     NULLPTR
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     |
     THIS
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     |
     OBJECT
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     |
     TRUE_CONSTANT
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     |
     FALSE_CONSTANT
     {
-        $$ = new ObjectNode($1->value, $1->type);
+        $$ = arena->New<ObjectNode>($1->value, $1->type);
     }
     |
     VALUE DOT OBJECT
     {
-        $$ = new MemberCallNode($1, $3->value);
+        $$ = arena->New<MemberCallNode>($1, $3->value);
     }
     |
     INDEX_CALL
@@ -470,24 +459,24 @@ VALUE:
 INDEX_CALL:
     VALUE SQUARE_BRACKET_O STATEMENT SQUARE_BRACKET_C
     {
-        $$ = new IndexCallNode($1, $3);
+        $$ = arena->New<IndexCallNode>($1, $3);
     }
 
 METHOD_CALL:
     OBJECT ROUND_BRACKET_O ROUND_BRACKET_C
     {
-        $<expr>$ = new MethodCallNode($1->value, nullptr, new AstNodeList());
+        $<expr>$ = arena->New<MethodCallNode>($1->value, nullptr, arena->New<AstNodeList>());
     }
     |
     OBJECT ROUND_BRACKET_O METHOD_ARGUMENT_LIST ROUND_BRACKET_C
     {
-        $<expr>$ = new MethodCallNode($1->value, nullptr, static_cast<AstNodeList*>($3));
+        $<expr>$ = arena->New<MethodCallNode>($1->value, nullptr, static_cast<AstNodeList*>($3));
     }
 
 METHOD_ARGUMENT_LIST:
     STATEMENT
     {
-        auto* args = new AstNodeList();
+        auto* args = arena->New<AstNodeList>();
         args->vec.push_back($1);
         $$ = args;
     }
@@ -502,169 +491,163 @@ METHOD_ARGUMENT_LIST:
 BINARY_STATEMENT:
     STATEMENT SUM_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::SUM_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::SUM_OP);
     }
     | 
     STATEMENT SUB_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::SUB_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::SUB_OP);
     }
     | 
     STATEMENT MULT_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::MULT_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::MULT_OP);
     }
     | 
     STATEMENT DIV_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::DIV_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::DIV_OP);
     }
     | 
     STATEMENT MOD_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::MOD_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::MOD_OP);
     }
     | 
     STATEMENT POWER_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::POWER_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::POWER_OP);
     }
     |
     STATEMENT LOGIC_EQUALS STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_EQUALS);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_EQUALS);
     }
     |
     STATEMENT LOGIC_NOT_EQUALS STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_NOT_EQUALS);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_NOT_EQUALS);
     }
     |
     STATEMENT LOGIC_LESS STATEMENT   
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_LESS);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_LESS);
     }
     |
     STATEMENT LOGIC_GREATER STATEMENT  
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_GREATER);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_GREATER);
     }
     |
     STATEMENT LOGIC_LESS_EQUALS STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_LESS_EQUALS);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_LESS_EQUALS);
     }
     |
     STATEMENT LOGIC_GREATER_EQUALS STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_GREATER_EQUALS);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_GREATER_EQUALS);
     }
     |
     STATEMENT LOGIC_OR STATEMENT    
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_OR);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_OR);
     }
     |
     STATEMENT LOGIC_AND STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::LOGIC_AND);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::LOGIC_AND);
     }
     |
     STATEMENT ASSIGN_OP STATEMENT
     {
-        $$ = new BinaryExprNode($1, $3, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::ASSIGN_OP);
     }
     |
     STATEMENT SUM_ASSIGN_OP STATEMENT
     {
-        auto* expr = new BinaryExprNode($1, $3, Type::SUM_OP);
-        $$ = new BinaryExprNode($1, expr, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::SUM_ASSIGN_OP);
     }
     |
     STATEMENT SUB_ASSIGN_OP STATEMENT
     {
-        auto* expr = new BinaryExprNode($1, $3, Type::SUB_OP);
-        $$ = new BinaryExprNode($1, expr, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::SUB_ASSIGN_OP);
     }
     |
     STATEMENT MULT_ASSIGN_OP STATEMENT
     {
-        auto* expr = new BinaryExprNode($1, $3, Type::MULT_OP);
-        $$ = new BinaryExprNode($1, expr, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::MULT_ASSIGN_OP);
     }
     |
     STATEMENT DIV_ASSIGN_OP STATEMENT
     {
-        auto* expr = new BinaryExprNode($1, $3, Type::DIV_OP);
-        $$ = new BinaryExprNode($1, expr, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::DIV_ASSIGN_OP);
     }
     |
     STATEMENT MOD_ASSIGN_OP STATEMENT
     {
-        auto* expr = new BinaryExprNode($1, $3, Type::MOD_OP);
-        $$ = new BinaryExprNode($1, expr, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::MOD_ASSIGN_OP);
     }
     |
     STATEMENT POWER_ASSIGN_OP STATEMENT
     {
-        auto* expr = new BinaryExprNode($1, $3, Type::POWER_OP);
-        $$ = new BinaryExprNode($1, expr, Type::ASSIGN_OP);
+        $$ = arena->New<BinaryExprNode>($1, $3, Type::POWER_ASSIGN_OP);
     }
 
 UNARY_STATEMENT:
     NEGATION_OP STATEMENT
     {
-        $$ = new UnaryExprNode($2, Type::NEGATION_OP);
+        $$ = arena->New<UnaryExprNode>($2, Type::NEGATION_OP);
     }
     |
     SUM_OP STATEMENT %prec POSITIVE_OP
     {
-        auto* expr = new UnaryExprNode($2, Type::POSITIVE_OP);
+        auto* expr = arena->New<UnaryExprNode>($2, Type::POSITIVE_OP);
     }
     |
     SUB_OP STATEMENT %prec NEGATIVE_OP
     {
-        auto* expr = new UnaryExprNode($2, Type::NEGATIVE_OP);
+        auto* expr = arena->New<UnaryExprNode>($2, Type::NEGATIVE_OP);
     }
 
 RETURN_STATEMENT:
     RETURN
     {
-        $$ = new ReturnExprNode(new ObjectNode("null", Token::Type::NULLPTR));
+        $$ = arena->New<ReturnExprNode>(arena->New<ObjectNode>("null", Token::Type::NULLPTR));
         // maybe check if function is a constructor?
     }
     |
     RETURN STATEMENT
     {
-         $$ = new ReturnExprNode($2);
+         $$ = arena->New<ReturnExprNode>($2);
     }
 
 VARIABLE_DECL:
     VARIABLE OBJECT
     {
-        $$ = new VariableDeclNode($2->value, false, nullptr);
+        $$ = arena->New<VariableDeclNode>($2->value, false, nullptr);
     }
     |
     VARIABLE OBJECT ASSIGN_OP STATEMENT
     {
-        $$ = new VariableDeclNode($2->value, false, $4);
+        $$ = arena->New<VariableDeclNode>($2->value, false, $4);
     }
 
 CONST_VARIABLE_DECL:
     CONST VARIABLE OBJECT
     {
-        $$ = new VariableDeclNode($3->value, true, new ObjectNode("null", Token::Type::NULLPTR));
+        $$ = arena->New<VariableDeclNode>($3->value, true, arena->New<ObjectNode>("null", Token::Type::NULLPTR));
     }
     |
     CONST VARIABLE OBJECT ASSIGN_OP STATEMENT
     {
-        $$ = new VariableDeclNode($3->value, true, $5);
+        $$ = arena->New<VariableDeclNode>($3->value, true, $5);
     }
 
 FOR_STATEMENT:
     FOR ROUND_BRACKET_O OPTIONAL_FOR_INIT SEMICOLON OPTIONAL_FOR_PRED SEMICOLON OPTIONAL_FOR_ITER ROUND_BRACKET_C INNER_EXPRESSION_BLOCK
     {
-        $$ = new ForExprNode($3, $5, $7, $9);
+        $$ = arena->New<ForExprNode>($3, $5, $7, $9);
     }
 
 OPTIONAL_FOR_INIT:
@@ -703,16 +686,16 @@ OPTIONAL_FOR_ITER:
 IF_STATEMENT:
     IF_BLOCK %prec IF
     {
-        $$ = new IfStatementNode(
+        $$ = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>($1), 
-            new AstNodeList(), 
+            arena->New<AstNodeList>(), 
             nullptr
         );
     }
     |
     IF_BLOCK ELIF_LIST %prec ELIF
     {
-        $$ = new IfStatementNode(
+        $$ = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>($1), 
             static_cast<AstNodeList*>($2), 
             nullptr
@@ -721,7 +704,7 @@ IF_STATEMENT:
     |
     IF_BLOCK ELIF_LIST ELSE_BLOCK
     {
-        $$ = new IfStatementNode(
+        $$ = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>($1), 
             static_cast<AstNodeList*>($2), 
             static_cast<ConditionalNode*>($3)
@@ -730,9 +713,9 @@ IF_STATEMENT:
     |
     IF_BLOCK ELSE_BLOCK
     {
-        $$ = new IfStatementNode(
+        $$ = arena->New<IfStatementNode>(
             static_cast<ConditionalNode*>($1), 
-            new AstNodeList(), 
+            arena->New<AstNodeList>(), 
             static_cast<ConditionalNode*>($2)
         );
     }
@@ -740,13 +723,13 @@ IF_STATEMENT:
 IF_BLOCK:
     IF ROUND_BRACKET_O STATEMENT ROUND_BRACKET_C INNER_EXPRESSION_BLOCK
     {
-        $$ = new ConditionalNode($3, $5);
+        $$ = arena->New<ConditionalNode>($3, $5);
     }
     
 ELIF_LIST:
     ELIF_BLOCK
     {
-        auto* elifs = new AstNodeList();
+        auto* elifs = arena->New<AstNodeList>();
         elifs->vec.push_back($1);
     }
     |
@@ -759,19 +742,19 @@ ELIF_LIST:
 ELIF_BLOCK:
     ELIF ROUND_BRACKET_O STATEMENT ROUND_BRACKET_C INNER_EXPRESSION_BLOCK
     {
-        $$ = new ConditionalNode($3, $5);
+        $$ = arena->New<ConditionalNode>($3, $5);
     }
 
 ELSE_BLOCK:
     ELSE INNER_EXPRESSION_BLOCK
     {
-        $$ = new ConditionalNode(nullptr, $2);
+        $$ = arena->New<ConditionalNode>(nullptr, $2);
     }
 
 INNER_EXPRESSION_BLOCK:
     EXPRESSION
     {
-        auto* exprs = new AstNodeList();
+        auto* exprs = arena->New<AstNodeList>();
         exprs->vec.push_back($1);
         $$ = exprs;
     }
@@ -784,29 +767,29 @@ INNER_EXPRESSION_BLOCK:
 WHILE_STATEMENT:
     WHILE ROUND_BRACKET_O STATEMENT ROUND_BRACKET_C INNER_EXPRESSION_BLOCK
     {
-        $$ = new ForExprNode(nullptr, $3, nullptr, $5);
+        $$ = arena->New<ForExprNode>(nullptr, $3, nullptr, $5);
         // init and iter are empty in while statement
     }
 
 FOREACH_STATEMENT:
     FOREACH ROUND_BRACKET_O VARIABLE OBJECT IN STATEMENT ROUND_BRACKET_C INNER_EXPRESSION_BLOCK
     {
-        $$ = new ForeachExprNode($4->value, $6, $8);
+        $$ = arena->New<ForeachExprNode>($4->value, $6, $8);
     }
 
 TRY_STATEMENT:
     TRY EXPRESSION_BLOCK
     {
-        $$ = new TryCatchNode("", $2, nullptr);
+        $$ = arena->New<TryCatchNode>("", $2, nullptr);
     }
     |
     TRY EXPRESSION_BLOCK CATCH EXPRESSION_BLOCK
     {
-        $$ = new TryCatchNode("", $2, $4);
+        $$ = arena->New<TryCatchNode>("", $2, $4);
     }
     |
     TRY EXPRESSION_BLOCK CATCH ROUND_BRACKET_O OBJECT ROUND_BRACKET_C EXPRESSION_BLOCK
     {
-        $$ = new TryCatchNode($5->value, $2, $7);
+        $$ = arena->New<TryCatchNode>($5->value, $2, $7);
     }
 %%
\ No newline at end of file